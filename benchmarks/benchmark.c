@@ -0,0 +1,529 @@
+/*
+ * (C) 2020 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+#include <margo.h>
+#include <json-c/json.h>
+#include <alpha/alpha-server.h>
+#include <alpha/alpha-client.h>
+#include <alpha/alpha-resource.h>
+
+// This benchmark measures the throughput and latency of the client's
+// RPCs. By default, it registers a provider in its own process and sends
+// RPCs to it over na+sm. With --serve, it only runs a provider, and with
+// --server, it sends RPCs to a provider running in another process.
+// With --local-shortcut, the client calls the local provider directly
+// when it can, as it would by default outside of the benchmark.
+//
+// For each RPC, it sweeps the number of ULTs issuing RPCs concurrently
+// (--concurrency), the number of non-blocking requests each of them keeps
+// in flight (--batch), and the number of elements of each request
+// (--payload, ignored for sum). Results are printed as JSON. Given the
+// JSON output of a previous run (--baseline), it flags the configurations
+// whose throughput or p99 latency got worse by more than --tolerance,
+// and exits with a non-zero code if there are any.
+
+#define FATAL(mid, ...) \
+    do { \
+        margo_critical(mid, __VA_ARGS__); \
+        exit(-1); \
+    } while(0)
+
+#define MAX_LIST_SIZE 32
+
+typedef enum bench_rpc {
+    BENCH_SUM,
+    BENCH_SUM_MULTI,
+    BENCH_SUM_BULK,
+    BENCH_ACCUMULATE,
+    BENCH_NUM_RPCS
+} bench_rpc;
+
+static const char* const rpc_names[BENCH_NUM_RPCS] = {
+    "sum", "sum_multi", "sum_bulk", "accumulate"
+};
+
+typedef struct bench_options {
+    const char* protocol;
+    const char* server;      // address of the remote provider, if any
+    int         serve;       // only run a provider
+    uint16_t    provider_id;
+    const char* config;      // configuration of the local provider
+    int         rpc_threads; // number of RPC execution streams of a local provider
+    bool        local;       // call the local provider directly instead of sending RPCs
+    bool        rpcs[BENCH_NUM_RPCS];
+    size_t      concurrency[MAX_LIST_SIZE];
+    size_t      num_concurrency;
+    size_t      batch[MAX_LIST_SIZE];
+    size_t      num_batch;
+    size_t      payload[MAX_LIST_SIZE];
+    size_t      num_payload;
+    size_t      iterations;  // batches sent by each ULT
+    size_t      warmup;      // batches sent by each ULT before measuring
+    const char* output;
+    const char* baseline;
+    double      tolerance;
+} bench_options;
+
+/* Parameters and measurements of one ULT issuing RPCs */
+typedef struct bench_worker {
+    alpha_resource_handle_t handle;
+    bench_rpc               rpc;
+    size_t                  batch;
+    size_t                  payload;
+    size_t                  iterations;
+    size_t                  warmup;
+    const char*             self_addr;
+    margo_instance_id       mid;
+    uint64_t*               latencies; // iterations*batch latencies, in ns
+    alpha_return_t          ret;
+} bench_worker;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec*1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int compare_u64(const void* a, const void* b)
+{
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static size_t parse_list(const char* str, size_t* values)
+{
+    size_t n = 0;
+    char* copy = strdup(str);
+    for(char* tok = strtok(copy, ","); tok && n < MAX_LIST_SIZE; tok = strtok(NULL, ","))
+        values[n++] = strtoull(tok, NULL, 0);
+    free(copy);
+    return n;
+}
+
+static void usage(const char* prog)
+{
+    fprintf(stderr,
+        "Usage: %s [options]\n"
+        "  -p, --protocol PROTOCOL  Mercury protocol (default na+sm)\n"
+        "  -s, --server ADDRESS     address of a running provider (default: local provider)\n"
+        "  -S, --serve              only run a provider and print its address\n"
+        "  -i, --provider-id ID     provider id (default 42)\n"
+        "  -C, --config JSON        configuration of the local provider\n"
+        "  -t, --rpc-threads N      RPC execution streams of the local provider (default 0)\n"
+        "  -l, --local-shortcut     call the local provider directly instead of sending RPCs\n"
+        "  -r, --rpcs LIST          RPCs to run among sum,sum_multi,sum_bulk,accumulate (default all)\n"
+        "  -c, --concurrency LIST   ULTs issuing RPCs (default 1,8)\n"
+        "  -b, --batch LIST         requests in flight per ULT (default 1,16)\n"
+        "  -n, --payload LIST       elements per request (default 1024,65536,1048576)\n"
+        "  -I, --iterations N       measured batches per ULT (default 100)\n"
+        "  -w, --warmup N           unmeasured batches per ULT (default 10)\n"
+        "  -o, --output FILE        where to write the results (default stdout)\n"
+        "  -B, --baseline FILE      results of a previous run to compare against\n"
+        "  -T, --tolerance RATIO    relative degradation flagged as a regression (default 0.1)\n",
+        prog);
+}
+
+static void parse_options(int argc, char** argv, bench_options* opts)
+{
+    static struct option long_options[] = {
+        {"protocol",    required_argument, 0, 'p'},
+        {"server",      required_argument, 0, 's'},
+        {"serve",       no_argument,       0, 'S'},
+        {"provider-id", required_argument, 0, 'i'},
+        {"config",      required_argument, 0, 'C'},
+        {"rpc-threads", required_argument, 0, 't'},
+        {"local-shortcut", no_argument,    0, 'l'},
+        {"rpcs",        required_argument, 0, 'r'},
+        {"concurrency", required_argument, 0, 'c'},
+        {"batch",       required_argument, 0, 'b'},
+        {"payload",     required_argument, 0, 'n'},
+        {"iterations",  required_argument, 0, 'I'},
+        {"warmup",      required_argument, 0, 'w'},
+        {"output",      required_argument, 0, 'o'},
+        {"baseline",    required_argument, 0, 'B'},
+        {"tolerance",   required_argument, 0, 'T'},
+        {"help",        no_argument,       0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    memset(opts, 0, sizeof(*opts));
+    opts->protocol    = "na+sm";
+    opts->provider_id = 42;
+    opts->config      = "{ \"resource\":{ \"type\":\"dummy\", \"config\":{} } }";
+    for(int r = 0; r < BENCH_NUM_RPCS; ++r) opts->rpcs[r] = true;
+    opts->num_concurrency = parse_list("1,8", opts->concurrency);
+    opts->num_batch       = parse_list("1,16", opts->batch);
+    opts->num_payload     = parse_list("1024,65536,1048576", opts->payload);
+    opts->iterations      = 100;
+    opts->warmup          = 10;
+    opts->tolerance       = 0.1;
+
+    int c;
+    while((c = getopt_long(argc, argv, "p:s:Si:C:t:lr:c:b:n:I:w:o:B:T:h", long_options, NULL)) != -1) {
+        switch(c) {
+        case 'p': opts->protocol = optarg; break;
+        case 's': opts->server = optarg; break;
+        case 'S': opts->serve = 1; break;
+        case 'i': opts->provider_id = (uint16_t)atoi(optarg); break;
+        case 'C': opts->config = optarg; break;
+        case 't': opts->rpc_threads = atoi(optarg); break;
+        case 'l': opts->local = true; break;
+        case 'r':
+            for(int r = 0; r < BENCH_NUM_RPCS; ++r)
+                opts->rpcs[r] = false;
+            {
+                char* copy = strdup(optarg);
+                for(char* tok = strtok(copy, ","); tok; tok = strtok(NULL, ",")) {
+                    int r = 0;
+                    while(r < BENCH_NUM_RPCS && strcmp(tok, rpc_names[r]) != 0) ++r;
+                    if(r == BENCH_NUM_RPCS) {
+                        fprintf(stderr, "Unknown RPC \"%s\"\n", tok);
+                        exit(-1);
+                    }
+                    opts->rpcs[r] = true;
+                }
+                free(copy);
+            }
+            break;
+        case 'c': opts->num_concurrency = parse_list(optarg, opts->concurrency); break;
+        case 'b': opts->num_batch = parse_list(optarg, opts->batch); break;
+        case 'n': opts->num_payload = parse_list(optarg, opts->payload); break;
+        case 'I': opts->iterations = strtoull(optarg, NULL, 0); break;
+        case 'w': opts->warmup = strtoull(optarg, NULL, 0); break;
+        case 'o': opts->output = optarg; break;
+        case 'B': opts->baseline = optarg; break;
+        case 'T': opts->tolerance = atof(optarg); break;
+        default:
+            usage(argv[0]);
+            exit(c == 'h' ? 0 : -1);
+        }
+    }
+}
+
+/* Starts the i-th request of a batch */
+static alpha_return_t start_request(
+        bench_worker* w, size_t i,
+        const int32_t* x, const int32_t* y, int32_t* r, hg_bulk_t bulk,
+        alpha_request_t* req)
+{
+    size_t size = w->payload*sizeof(int32_t);
+    switch(w->rpc) {
+    case BENCH_SUM:
+        return alpha_compute_sum_async(w->handle, (int32_t)i, 1, r + i, req);
+    case BENCH_SUM_MULTI:
+        return alpha_compute_sum_multi_async(
+            w->handle, w->payload, x, y, r + i*w->payload, req);
+    case BENCH_SUM_BULK: {
+        /* the bulk handle exposes x, y, and the batch's results */
+        alpha_bulk_location_t x_bl = {
+            .bulk = bulk, .address = (char*)w->self_addr, .offset = 0, .size = size
+        };
+        alpha_bulk_location_t y_bl = x_bl;
+        alpha_bulk_location_t r_bl = x_bl;
+        y_bl.offset = size;
+        r_bl.offset = (2 + i)*size;
+        return alpha_compute_sum_bulk_async(w->handle, w->payload, &x_bl, &y_bl, &r_bl, req);
+    }
+    case BENCH_ACCUMULATE: {
+        /* each request of the batch accumulates x into its own array */
+        alpha_bulk_location_t x_bl = {
+            .bulk = bulk, .address = (char*)w->self_addr, .offset = 0, .size = size
+        };
+        alpha_bulk_location_t y_bl = x_bl;
+        y_bl.offset = (2 + i)*size;
+        return alpha_compute_accumulate_bulk_async(w->handle, w->payload, &x_bl, &y_bl, req);
+    }
+    default:
+        return ALPHA_ERR_INVALID_ARGS;
+    }
+}
+
+static void worker_ult(void* arg)
+{
+    bench_worker* w = (bench_worker*)arg;
+    size_t payload  = w->rpc == BENCH_SUM ? 1 : w->payload;
+    int32_t* data   = (int32_t*)calloc((2 + w->batch)*payload, sizeof(int32_t));
+    alpha_request_t* reqs = (alpha_request_t*)calloc(w->batch, sizeof(*reqs));
+    hg_bulk_t bulk  = HG_BULK_NULL;
+    if(!data || !reqs) {
+        w->ret = ALPHA_ERR_ALLOCATION;
+        goto finish;
+    }
+    int32_t* x = data;
+    int32_t* y = x + payload;
+    int32_t* r = y + payload;
+    for(size_t i = 0; i < payload; ++i) {
+        x[i] = (int32_t)i;
+        y[i] = 1;
+    }
+
+    if(w->rpc == BENCH_SUM_BULK || w->rpc == BENCH_ACCUMULATE) {
+        void* ptrs[1]      = { data };
+        hg_size_t sizes[1] = { (2 + w->batch)*payload*sizeof(int32_t) };
+        if(margo_bulk_create(w->mid, 1, ptrs, sizes, HG_BULK_READWRITE, &bulk) != HG_SUCCESS) {
+            w->ret = ALPHA_ERR_FROM_MERCURY;
+            goto finish;
+        }
+    }
+
+    for(size_t it = 0; it < w->warmup + w->iterations; ++it) {
+        uint64_t start = now_ns();
+        for(size_t i = 0; i < w->batch; ++i) {
+            w->ret = start_request(w, i, x, y, r, bulk, &reqs[i]);
+            if(w->ret != ALPHA_SUCCESS) {
+                alpha_request_wait_all(i, reqs);
+                goto finish;
+            }
+        }
+        /* each request's latency runs from the start of its batch */
+        for(size_t i = 0; i < w->batch; ++i) {
+            alpha_return_t ret = alpha_request_wait(reqs[i]);
+            reqs[i] = ALPHA_REQUEST_NULL;
+            if(it >= w->warmup)
+                w->latencies[(it - w->warmup)*w->batch + i] = now_ns() - start;
+            if(ret != ALPHA_SUCCESS && w->ret == ALPHA_SUCCESS) w->ret = ret;
+        }
+        if(w->ret != ALPHA_SUCCESS) goto finish;
+    }
+
+finish:
+    margo_bulk_free(bulk);
+    free(reqs);
+    free(data);
+}
+
+/* Runs one configuration and returns its results as a JSON object */
+static struct json_object* run_benchmark(
+        margo_instance_id mid, alpha_resource_handle_t handle,
+        const char* self_addr, const bench_options* opts,
+        bench_rpc rpc, size_t concurrency, size_t batch, size_t payload)
+{
+    size_t ops_per_worker = opts->iterations*batch;
+    bench_worker* workers = (bench_worker*)calloc(concurrency, sizeof(*workers));
+    ABT_thread* threads   = (ABT_thread*)calloc(concurrency, sizeof(*threads));
+    uint64_t* latencies   = (uint64_t*)calloc(concurrency*ops_per_worker, sizeof(uint64_t));
+    if(!workers || !threads || !latencies)
+        FATAL(mid, "Could not allocate memory for benchmark");
+
+    ABT_pool pool = ABT_POOL_NULL;
+    margo_get_handler_pool(mid, &pool);
+
+    uint64_t start = now_ns();
+    for(size_t i = 0; i < concurrency; ++i) {
+        workers[i].handle     = handle;
+        workers[i].rpc        = rpc;
+        workers[i].batch      = batch;
+        workers[i].payload    = payload;
+        workers[i].iterations = opts->iterations;
+        workers[i].warmup     = opts->warmup;
+        workers[i].self_addr  = self_addr;
+        workers[i].mid        = mid;
+        workers[i].latencies  = latencies + i*ops_per_worker;
+        if(ABT_thread_create(pool, worker_ult, &workers[i],
+                             ABT_THREAD_ATTR_NULL, &threads[i]) != ABT_SUCCESS)
+            FATAL(mid, "Could not create benchmark ULT");
+    }
+    alpha_return_t ret = ALPHA_SUCCESS;
+    for(size_t i = 0; i < concurrency; ++i) {
+        ABT_thread_join(threads[i]);
+        ABT_thread_free(&threads[i]);
+        if(ret == ALPHA_SUCCESS) ret = workers[i].ret;
+    }
+    double seconds = (double)(now_ns() - start)/1e9;
+    if(ret != ALPHA_SUCCESS)
+        FATAL(mid, "%s benchmark failed (ret = %d)", rpc_names[rpc], ret);
+
+    /* the elapsed time includes the warmup, which is discounted here
+     * assuming warmup batches take as long as measured ones */
+    size_t total_ops = concurrency*ops_per_worker;
+    seconds *= (double)opts->iterations/(double)(opts->iterations + opts->warmup);
+    size_t bytes_per_op = 3*sizeof(int32_t)*(rpc == BENCH_SUM ? 1 : payload);
+
+    qsort(latencies, total_ops, sizeof(uint64_t), compare_u64);
+    uint64_t sum = 0;
+    for(size_t i = 0; i < total_ops; ++i) sum += latencies[i];
+
+    struct json_object* result = json_object_new_object();
+    json_object_object_add(result, "rpc", json_object_new_string(rpc_names[rpc]));
+    json_object_object_add(result, "concurrency", json_object_new_int64((int64_t)concurrency));
+    json_object_object_add(result, "batch", json_object_new_int64((int64_t)batch));
+    json_object_object_add(result, "payload", json_object_new_int64((int64_t)payload));
+    json_object_object_add(result, "ops", json_object_new_int64((int64_t)total_ops));
+    json_object_object_add(result, "seconds", json_object_new_double(seconds));
+    json_object_object_add(result, "ops_per_sec", json_object_new_double(total_ops/seconds));
+    json_object_object_add(result, "gb_per_sec",
+        json_object_new_double((double)total_ops*bytes_per_op/seconds/1e9));
+    struct json_object* latency = json_object_new_object();
+    json_object_object_add(result, "latency_ns", latency);
+    if(total_ops) {
+        json_object_object_add(latency, "mean", json_object_new_double((double)sum/total_ops));
+        json_object_object_add(latency, "p50", json_object_new_int64((int64_t)latencies[total_ops*50/100]));
+        json_object_object_add(latency, "p99", json_object_new_int64((int64_t)latencies[total_ops*99/100]));
+        json_object_object_add(latency, "p999", json_object_new_int64((int64_t)latencies[total_ops*999/1000]));
+        json_object_object_add(latency, "max", json_object_new_int64((int64_t)latencies[total_ops-1]));
+    }
+
+    free(latencies);
+    free(threads);
+    free(workers);
+    return result;
+}
+
+/* Finds the result of the same configuration in the baseline's results */
+static struct json_object* find_in_baseline(
+        struct json_object* baseline, struct json_object* result)
+{
+    static const char* const keys[] = { "rpc", "concurrency", "batch", "payload" };
+    struct json_object* results = json_object_object_get(baseline, "results");
+    if(!json_object_is_type(results, json_type_array)) return NULL;
+    for(size_t i = 0; i < json_object_array_length(results); ++i) {
+        struct json_object* b = json_object_array_get_idx(results, i);
+        bool match = true;
+        for(size_t k = 0; k < 4 && match; ++k)
+            match = strcmp(json_object_to_json_string(json_object_object_get(b, keys[k])),
+                           json_object_to_json_string(json_object_object_get(result, keys[k]))) == 0;
+        if(match) return b;
+    }
+    return NULL;
+}
+
+/* Compares a result with the baseline, adds a "baseline" field with the
+ * baseline's throughput and p99 latency, and returns true if it regressed */
+static bool check_regression(
+        struct json_object* baseline, struct json_object* result, double tolerance)
+{
+    struct json_object* b = find_in_baseline(baseline, result);
+    if(!b) return false;
+    double b_ops = json_object_get_double(json_object_object_get(b, "ops_per_sec"));
+    double r_ops = json_object_get_double(json_object_object_get(result, "ops_per_sec"));
+    double b_p99 = json_object_get_double(json_object_object_get(
+        json_object_object_get(b, "latency_ns"), "p99"));
+    double r_p99 = json_object_get_double(json_object_object_get(
+        json_object_object_get(result, "latency_ns"), "p99"));
+    bool regression = r_ops < b_ops*(1.0 - tolerance)
+                   || (b_p99 > 0 && r_p99 > b_p99*(1.0 + tolerance));
+    struct json_object* jbaseline = json_object_new_object();
+    json_object_object_add(jbaseline, "ops_per_sec", json_object_new_double(b_ops));
+    json_object_object_add(jbaseline, "p99", json_object_new_double(b_p99));
+    json_object_object_add(result, "baseline", jbaseline);
+    json_object_object_add(result, "regression", json_object_new_boolean(regression));
+    return regression;
+}
+
+int main(int argc, char** argv)
+{
+    bench_options opts;
+    parse_options(argc, argv, &opts);
+
+    int mode = (opts.server && !opts.serve) ? MARGO_CLIENT_MODE : MARGO_SERVER_MODE;
+    margo_instance_id mid = margo_init(opts.protocol, mode, 1, opts.rpc_threads);
+    if(!mid) {
+        fprintf(stderr, "Could not initialize margo with protocol %s\n", opts.protocol);
+        return -1;
+    }
+
+    hg_addr_t self_addr;
+    char self_addr_str[256];
+    hg_size_t self_addr_size = sizeof(self_addr_str);
+    margo_addr_self(mid, &self_addr);
+    margo_addr_to_string(mid, self_addr_str, &self_addr_size, self_addr);
+    margo_addr_free(mid, self_addr);
+
+    if(!opts.server) {
+        struct alpha_provider_args args = ALPHA_PROVIDER_ARGS_INIT;
+        alpha_return_t ret = alpha_provider_register(
+            mid, opts.provider_id, opts.config, &args, ALPHA_PROVIDER_IGNORE);
+        if(ret != ALPHA_SUCCESS)
+            FATAL(mid, "alpha_provider_register failed (ret = %d)", ret);
+    }
+    if(opts.serve) {
+        printf("%s %u\n", self_addr_str, opts.provider_id);
+        fflush(stdout);
+        margo_wait_for_finalize(mid);
+        return 0;
+    }
+
+    struct json_object* baseline = NULL;
+    if(opts.baseline) {
+        baseline = json_object_from_file(opts.baseline);
+        if(!baseline)
+            FATAL(mid, "Could not read baseline from %s", opts.baseline);
+    }
+
+    hg_addr_t server_addr = HG_ADDR_NULL;
+    if(opts.server) {
+        if(margo_addr_lookup(mid, opts.server, &server_addr) != HG_SUCCESS)
+            FATAL(mid, "margo_addr_lookup failed for address %s", opts.server);
+    } else {
+        margo_addr_self(mid, &server_addr);
+    }
+
+    alpha_client_t client;
+    alpha_resource_handle_t handle;
+    struct alpha_client_args client_args = ALPHA_CLIENT_ARGS_INIT;
+    /* the benchmark measures RPCs unless asked to measure direct calls */
+    client_args.local_shortcut = opts.local;
+    alpha_return_t ret = alpha_client_init_ext(mid, &client_args, &client);
+    if(ret != ALPHA_SUCCESS)
+        FATAL(mid, "alpha_client_init_ext failed (ret = %d)", ret);
+    ret = alpha_resource_handle_create(client, server_addr, opts.provider_id, true, &handle);
+    if(ret != ALPHA_SUCCESS)
+        FATAL(mid, "alpha_resource_handle_create failed (ret = %d)", ret);
+
+    struct json_object* root = json_object_new_object();
+    struct json_object* config = json_object_new_object();
+    json_object_object_add(root, "config", config);
+    json_object_object_add(config, "protocol", json_object_new_string(opts.protocol));
+    json_object_object_add(config, "remote", json_object_new_boolean(opts.server != NULL));
+    json_object_object_add(config, "local_shortcut", json_object_new_boolean(opts.local));
+    json_object_object_add(config, "iterations", json_object_new_int64((int64_t)opts.iterations));
+    json_object_object_add(config, "warmup", json_object_new_int64((int64_t)opts.warmup));
+    struct json_object* results = json_object_new_array();
+    json_object_object_add(root, "results", results);
+
+    size_t num_regressions = 0;
+    for(int rpc = 0; rpc < BENCH_NUM_RPCS; ++rpc) {
+        if(!opts.rpcs[rpc]) continue;
+        /* the payload doesn't apply to sum */
+        size_t num_payload = rpc == BENCH_SUM ? 1 : opts.num_payload;
+        for(size_t c = 0; c < opts.num_concurrency; ++c)
+        for(size_t b = 0; b < opts.num_batch; ++b)
+        for(size_t p = 0; p < num_payload; ++p) {
+            size_t payload = rpc == BENCH_SUM ? 1 : opts.payload[p];
+            margo_info(mid, "Running %s benchmark (concurrency=%lu, batch=%lu, payload=%lu)",
+                       rpc_names[rpc], (unsigned long)opts.concurrency[c],
+                       (unsigned long)opts.batch[b], (unsigned long)payload);
+            struct json_object* result = run_benchmark(
+                mid, handle, self_addr_str, &opts, (bench_rpc)rpc,
+                opts.concurrency[c], opts.batch[b], payload);
+            if(baseline && check_regression(baseline, result, opts.tolerance))
+                num_regressions += 1;
+            json_object_array_add(results, result);
+        }
+    }
+    json_object_object_add(root, "regressions", json_object_new_int64((int64_t)num_regressions));
+
+    FILE* out = opts.output ? fopen(opts.output, "w") : stdout;
+    if(!out) FATAL(mid, "Could not open %s", opts.output);
+    fprintf(out, "%s\n", json_object_to_json_string_ext(root, JSON_C_TO_STRING_PRETTY));
+    if(out != stdout) fclose(out);
+
+    json_object_put(root);
+    if(baseline) json_object_put(baseline);
+    alpha_resource_handle_release(handle);
+    alpha_client_finalize(client);
+    margo_addr_free(mid, server_addr);
+    margo_finalize(mid);
+
+    if(num_regressions)
+        fprintf(stderr, "%lu configuration(s) regressed\n", (unsigned long)num_regressions);
+    return num_regressions ? 1 : 0;
+}
@@ -18,7 +18,11 @@ extern "C" {
 //
 // A backend for a provider is implemented using a structure of function pointers,
 // similar to a vtable in C++. The alpha_register_backend function can be used to
-// register a backend type.
+// register a backend type. Backends may also be provided by shared libraries that
+// the provider loads when a resource's configuration has a "library" field, e.g.
+// { "type": "foo", "library": "libfoo.so", "config": {} }. Such a library should
+// call alpha_register_backend when it is loaded, or define a function named
+// alpha_register_backends (see alpha_register_backends_fn) that does.
 
 typedef struct alpha_provider* alpha_provider_t;
 
@@ -38,19 +42,57 @@ typedef struct alpha_backend_impl {
     alpha_backend_get_config_fn get_config;
     // RPC functions
     int32_t (*sum)(void*, int32_t, int32_t);
+    // optional batched version of sum, computing r[i] = x[i] + y[i]
+    // for i in [0, count); r may alias x or y. If NULL, the provider
+    // will call sum on each element. When the provider has a compute
+    // pool, this function (or sum) may be called concurrently on
+    // disjoint parts of the same arrays.
+    void (*sum_batch)(void*, size_t, const int32_t*, const int32_t*, int32_t*);
+    // optional typed version of sum_batch, for elements of the given type
+    // (for ALPHA_DTYPE_I32, the provider calls sum_batch or sum instead).
+    // Returns ALPHA_ERR_OP_UNSUPPORTED for the types it doesn't handle,
+    // in which case, or if NULL, the provider uses its own kernels.
+    alpha_return_t (*sum_typed)(void*, alpha_dtype_t, size_t, const void*, const void*, void*);
+    // optional reduction of x[0..count) into a single value, for the
+    // ALPHA_REDUCE_SUM, ALPHA_REDUCE_MIN, and ALPHA_REDUCE_MAX operations
+    // (count is never 0 for the latter two). Sums are computed on 64 bits,
+    // wrapping around on overflow. If NULL, the provider uses its own kernels.
+    // The provider may call this function on consecutive parts of the array
+    // and combine the partial results.
+    int64_t (*reduce)(void*, alpha_reduce_op_t, size_t, const int32_t*);
+    // optional dot product of x[0..count) and y[0..count), computed on
+    // 64 bits, with the same conventions as reduce.
+    int64_t (*dot)(void*, size_t, const int32_t*, const int32_t*);
+    // optional named arrays of int32_t kept by the resource (e.g. in files).
+    // create_array creates an array of count elements, failing with
+    // ALPHA_ERR_INVALID_ARGS if the name is invalid or already taken, and
+    // find_array looks one up, failing with ALPHA_ERR_INVALID_ARRAY if there
+    // is no such array. The returned pointers must stay valid, and may be
+    // read and written concurrently, until the resource is destroyed.
+    // If NULL, the provider rejects the RPCs using named arrays.
+    alpha_return_t (*create_array)(void*, const char*, size_t, int32_t**);
+    alpha_return_t (*find_array)(void*, const char*, int32_t**, size_t*);
+    // optional hint that data[0..count) of a named array will be read soon
+    void (*prefetch)(void*, const int32_t*, size_t);
     // ... add other functions here
 } alpha_backend_impl;
 
 /**
- * @brief Registers a backend implementation.
+ * @brief Type of the alpha_register_backends function that shared
+ * libraries providing backends may define. It is called after the
+ * library has been loaded.
+ */
+typedef alpha_return_t (*alpha_register_backends_fn)(void);
+
+/**
+ * @brief Registers a backend implementation. This function is thread-safe.
+ * Registering a backend with the same name as an already registered
+ * backend has no effect.
  *
  * Note: the backend implementation will not be copied; it is
  * therefore important that it stays valid in memory while
  * in use by any alpha provider.
  *
- * Important: up to 64 backend implementations may be registered,
- * including the ones provided internally.
- *
  * @param backend_impl backend implementation.
  *
  * @return ALPHA_SUCCESS or error code defined in alpha-common.h
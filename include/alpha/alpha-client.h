@@ -25,6 +25,35 @@ extern "C" {
 typedef struct alpha_client* alpha_client_t;
 #define ALPHA_CLIENT_NULL ((alpha_client_t)NULL)
 
+#define ALPHA_EAGER_THRESHOLD_AUTO ((size_t)-1)
+
+struct alpha_client_args {
+    size_t eager_threshold; // Max number of elements for which alpha_compute_sum_multi
+                            // sends its arrays inline instead of using RDMA
+                            // (0 to disable, ALPHA_EAGER_THRESHOLD_AUTO to derive it
+                            // from Mercury's eager sizes; capped to 1048576)
+    size_t handle_cache_size; // Max number of hg_handle_t kept by each resource handle
+                              // for reuse by subsequent RPCs (0 to disable)
+    unsigned max_retries; // Max number of times an RPC rejected with ALPHA_ERR_BUSY
+                          // is resent, after a jittered delay that grows with each
+                          // attempt, starting from the one suggested by the provider
+    bool local_shortcut; // Call providers living in the same margo instance directly
+                         // (see alpha_compute_sum_multi)
+    size_t shm_size; // Size of the shared-memory segment each resource handle creates
+                     // to exchange sum_multi arrays with a provider on the same node
+                     // that enables shm in its configuration, i.e. trusts its
+                     // clients (0 to disable, see alpha_resource_handle_shm_alloc)
+    // ...
+};
+
+#define ALPHA_CLIENT_ARGS_INIT { \
+    /* .eager_threshold = */ ALPHA_EAGER_THRESHOLD_AUTO, \
+    /* .handle_cache_size = */ 8, \
+    /* .max_retries = */ 5, \
+    /* .local_shortcut = */ true, \
+    /* .shm_size = */ 0 \
+}
+
 /**
  * @brief Creates a ALPHA client.
  *
@@ -35,6 +64,20 @@ typedef struct alpha_client* alpha_client_t;
  */
 alpha_return_t alpha_client_init(margo_instance_id mid, alpha_client_t* client);
 
+/**
+ * @brief Creates a ALPHA client with the provided arguments.
+ *
+ * @param[in] mid Margo instance
+ * @param[in] args arguments (NULL to use default values)
+ * @param[out] client ALPHA client
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_client_init_ext(
+        margo_instance_id mid,
+        const struct alpha_client_args* args,
+        alpha_client_t* client);
+
 /**
  * @brief Finalizes a ALPHA client.
  *
@@ -44,6 +87,62 @@ alpha_return_t alpha_client_init(margo_instance_id mid, alpha_client_t* client);
  */
 alpha_return_t alpha_client_finalize(alpha_client_t client);
 
+/**
+ * @brief Registers a buffer for RDMA operations. Functions such as
+ * alpha_compute_sum_multi will use the resulting bulk handle for any array
+ * that lies within a registered buffer, instead of registering (and
+ * deregistering) the array's memory at each call. Registering long-lived
+ * arrays that are used in many operations therefore saves the cost of
+ * memory registration.
+ *
+ * The buffer must remain valid until alpha_client_unregister_buffer is
+ * called, and must not overlap with another registered buffer.
+ *
+ * @param[in] client ALPHA client
+ * @param[in] ptr start of the buffer
+ * @param[in] size size of the buffer in bytes
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_client_register_buffer(
+        alpha_client_t client,
+        void* ptr,
+        size_t size);
+
+/**
+ * @brief Unregisters a buffer previously registered using
+ * alpha_client_register_buffer. No operation using the buffer
+ * should be in progress when this function is called.
+ *
+ * @param[in] client ALPHA client
+ * @param[in] ptr start of the buffer
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_client_unregister_buffer(
+        alpha_client_t client,
+        void* ptr);
+
+/**
+ * @brief Retrieves JSON-formatted statistics from a provider (see
+ * alpha_provider_get_stats) using the alpha_stats RPC. Fails with
+ * ALPHA_ERR_OP_FORBIDDEN if the provider disables this RPC.
+ *
+ * The caller is responsible for freeing the returned string.
+ *
+ * @param[in] client ALPHA client
+ * @param[in] addr Mercury address of the provider
+ * @param[in] provider_id id of the provider
+ * @param[out] stats heap-allocated JSON string
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_client_get_provider_stats(
+        alpha_client_t client,
+        hg_addr_t addr,
+        uint16_t provider_id,
+        char** stats);
+
 #ifdef __cplusplus
 }
 #endif
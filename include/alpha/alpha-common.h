@@ -7,6 +7,7 @@
 #define __ALPHA_COMMON_H
 
 #include <stdint.h>
+#include <stdlib.h>
 #include <margo.h>
 #include <mercury_proc.h>
 #include <mercury_proc_bulk.h>
@@ -38,10 +39,41 @@ typedef enum alpha_return_t {
     ALPHA_ERR_FROM_ARGOBOTS,     /* Argobots error */
     ALPHA_ERR_OP_UNSUPPORTED,    /* Unsupported operation */
     ALPHA_ERR_OP_FORBIDDEN,      /* Forbidden operation */
+    ALPHA_ERR_BUSY,              /* Provider overloaded, retry later */
+    ALPHA_ERR_INVALID_ARRAY,     /* Invalid stored array id */
     /* ... TODO add more error codes here if needed */
     ALPHA_ERR_OTHER              /* Other error */
 } alpha_return_t;
 
+/**
+ * @brief Types of the elements of the arrays passed to typed operations
+ * such as alpha_compute_sum_multi_typed.
+ */
+typedef enum alpha_dtype_t {
+    ALPHA_DTYPE_I32, /* int32_t */
+    ALPHA_DTYPE_I64, /* int64_t */
+    ALPHA_DTYPE_F32, /* float */
+    ALPHA_DTYPE_F64  /* double */
+} alpha_dtype_t;
+
+/**
+ * @brief Returns the size in bytes of an element of the given type.
+ */
+static inline size_t alpha_dtype_size(alpha_dtype_t dtype)
+{
+    return dtype == ALPHA_DTYPE_I32 || dtype == ALPHA_DTYPE_F32 ? 4 : 8;
+}
+
+/**
+ * @brief Reductions computed by alpha_compute_reduce_bulk.
+ */
+typedef enum alpha_reduce_op_t {
+    ALPHA_REDUCE_SUM, /* Sum of the elements of x */
+    ALPHA_REDUCE_MIN, /* Smallest element of x */
+    ALPHA_REDUCE_MAX, /* Largest element of x */
+    ALPHA_REDUCE_DOT  /* Dot product of x and y */
+} alpha_reduce_op_t;
+
 /**
  * The alpha_bulk_location_t structure encapsulates a bulk handle
  * with the address it originates from, and the range (offset, size)
@@ -56,6 +88,74 @@ MERCURY_GEN_PROC(alpha_bulk_location_t,
     ((int64_t)(offset))\
     ((int64_t)(size)))
 
+/**
+ * The alpha_segment_t structure describes a contiguous range of bytes
+ * (offset, size) of the memory exposed by a bulk handle.
+ */
+typedef struct alpha_segment_t {
+    int64_t offset;
+    int64_t size;
+} alpha_segment_t;
+
+/**
+ * The alpha_strided_location_t structure describes an array whose elements
+ * are not contiguous in the memory exposed by a bulk handle, so that it
+ * can be used by the server without being packed first.
+ *
+ * If num_segments is 0, element i of the array lies at offset + i*stride,
+ * stride being in bytes and at least the size of an element (e.g. a field
+ * of an array of structures, or a row of a column-major matrix).
+ * Otherwise the array is the concatenation of the given segments, whose
+ * offsets are relative to offset, and stride is ignored.
+ *
+ * The segments array belongs to the caller.
+ */
+typedef struct alpha_strided_location_t {
+    hg_bulk_t        bulk;
+    hg_string_t      address;
+    int64_t          offset;
+    int64_t          stride;
+    uint64_t         num_segments;
+    alpha_segment_t* segments;
+} alpha_strided_location_t;
+
+static inline hg_return_t hg_proc_alpha_strided_location_t(hg_proc_t proc, void* data)
+{
+    alpha_strided_location_t* loc = (alpha_strided_location_t*)data;
+    hg_return_t hret;
+    if((hret = hg_proc_hg_bulk_t(proc, &loc->bulk)) != HG_SUCCESS
+    || (hret = hg_proc_hg_string_t(proc, &loc->address)) != HG_SUCCESS
+    || (hret = hg_proc_int64_t(proc, &loc->offset)) != HG_SUCCESS
+    || (hret = hg_proc_int64_t(proc, &loc->stride)) != HG_SUCCESS
+    || (hret = hg_proc_uint64_t(proc, &loc->num_segments)) != HG_SUCCESS)
+        return hret;
+    switch(hg_proc_get_op(proc)) {
+    case HG_DECODE:
+        loc->segments = NULL;
+        if(loc->num_segments == 0) return HG_SUCCESS;
+        /* each segment takes 2 int64_t in the buffer, so a count that the
+         * remaining bytes can't hold is bogus and mustn't be allocated */
+        if(loc->num_segments > hg_proc_get_size_left(proc) / (2*sizeof(int64_t)))
+            return HG_INVALID_ARG;
+        loc->segments = (alpha_segment_t*)calloc(loc->num_segments, sizeof(alpha_segment_t));
+        if(!loc->segments) return HG_NOMEM;
+        /* fall through */
+    case HG_ENCODE:
+        for(uint64_t i = 0; i < loc->num_segments; ++i) {
+            if((hret = hg_proc_int64_t(proc, &loc->segments[i].offset)) != HG_SUCCESS
+            || (hret = hg_proc_int64_t(proc, &loc->segments[i].size)) != HG_SUCCESS)
+                return hret;
+        }
+        return HG_SUCCESS;
+    case HG_FREE:
+        free(loc->segments);
+        loc->segments = NULL;
+        return HG_SUCCESS;
+    default:
+        return HG_INVALID_ARG;
+    }
+}
+
 #ifdef __cplusplus
 }
 #endif
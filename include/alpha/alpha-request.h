@@ -0,0 +1,88 @@
+/*
+ * (C) 2020 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef __ALPHA_REQUEST_H
+#define __ALPHA_REQUEST_H
+
+#include <alpha/alpha-common.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// TUTORIAL
+// ********
+//
+// An alpha_request_t represents an operation started by one of the non-blocking
+// functions of the client library (e.g. alpha_compute_sum_async). The operation
+// is completed, and the request freed, by alpha_request_wait (or by
+// alpha_request_wait_any/alpha_request_wait_all). Output arguments passed to the
+// non-blocking function (e.g. the result pointer) must remain valid until then,
+// and should not be read before the request has completed.
+//
+// If the provider rejects the operation with ALPHA_ERR_BUSY, alpha_request_wait
+// resends it (see max_retries in alpha_client_args), hence a request reported
+// as completed by alpha_request_test may still block in alpha_request_wait.
+
+typedef struct alpha_request* alpha_request_t;
+#define ALPHA_REQUEST_NULL ((alpha_request_t)NULL)
+
+/**
+ * @brief Waits for the request to complete and frees it.
+ *
+ * @param[in] req request to wait on
+ *
+ * @return the return value of the operation
+ */
+alpha_return_t alpha_request_wait(alpha_request_t req);
+
+/**
+ * @brief Checks whether the request has completed, without blocking.
+ * The request still needs to be waited on with alpha_request_wait
+ * to get its return value and free it.
+ *
+ * @param[in] req request to test
+ * @param[out] flag set to 1 if the request has completed, 0 otherwise
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_request_test(alpha_request_t req, int* flag);
+
+/**
+ * @brief Waits for any of the requests in the array to complete.
+ * Entries set to ALPHA_REQUEST_NULL are ignored. The request that
+ * completed is freed and its entry is set to ALPHA_REQUEST_NULL.
+ *
+ * @param[in] count number of requests in the array
+ * @param[inout] reqs array of requests
+ * @param[out] index index of the request that completed
+ *
+ * @return the return value of the completed operation, or
+ * ALPHA_ERR_INVALID_ARGS if all the requests are ALPHA_REQUEST_NULL
+ */
+alpha_return_t alpha_request_wait_any(
+        size_t count,
+        alpha_request_t* reqs,
+        size_t* index);
+
+/**
+ * @brief Waits for all the requests in the array to complete.
+ * Entries set to ALPHA_REQUEST_NULL are ignored. All the requests
+ * are freed and set to ALPHA_REQUEST_NULL.
+ *
+ * @param[in] count number of requests in the array
+ * @param[inout] reqs array of requests
+ *
+ * @return ALPHA_SUCCESS or the first error returned by an operation
+ */
+alpha_return_t alpha_request_wait_all(
+        size_t count,
+        alpha_request_t* reqs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
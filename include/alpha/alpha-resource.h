@@ -9,6 +9,7 @@
 #include <margo.h>
 #include <alpha/alpha-common.h>
 #include <alpha/alpha-client.h>
+#include <alpha/alpha-request.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -18,7 +19,8 @@ typedef struct alpha_resource_handle *alpha_resource_handle_t;
 #define ALPHA_RESOURCE_HANDLE_NULL ((alpha_resource_handle_t)NULL)
 
 /**
- * @brief Creates a ALPHA resource handle.
+ * @brief Creates a ALPHA resource handle for the resource with id 0
+ * in the provider.
  *
  * @param[in] client ALPHA client responsible for the resource handle
  * @param[in] addr Mercury address of the provider
@@ -35,6 +37,28 @@ alpha_return_t alpha_resource_handle_create(
         bool check,
         alpha_resource_handle_t* handle);
 
+/**
+ * @brief Creates a ALPHA resource handle for the resource with the
+ * given id in the provider. Note that check only checks that the
+ * provider exists, not the resource.
+ *
+ * @param[in] client ALPHA client responsible for the resource handle
+ * @param[in] addr Mercury address of the provider
+ * @param[in] provider_id id of the provider
+ * @param[in] resource_id id of the resource within the provider
+ * @param[in] check If true, will send an RPC to check that the provider exists
+ * @param[out] handle resource handle
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_resource_handle_create_with_id(
+        alpha_client_t client,
+        hg_addr_t addr,
+        uint16_t provider_id,
+        uint32_t resource_id,
+        bool check,
+        alpha_resource_handle_t* handle);
+
 /**
  * @brief Increments the reference counter of a resource handle.
  *
@@ -56,6 +80,64 @@ alpha_return_t alpha_resource_handle_ref_incr(
  */
 alpha_return_t alpha_resource_handle_release(alpha_resource_handle_t handle);
 
+/**
+ * @brief Enables the coalescing of scalar sums on the resource handle.
+ * When enabled, alpha_compute_sum and alpha_compute_sum_async don't send
+ * one RPC per call. Instead, calls are buffered and sent as a single
+ * batch RPC when max_batch_size calls have been buffered, or max_delay_us
+ * microseconds after the first call of the batch, whichever comes first.
+ * Each call still completes individually (in particular, the blocking
+ * alpha_compute_sum may wait up to max_delay_us for a batch to fill up).
+ *
+ * alpha_compute_sum_timed is never coalesced.
+ *
+ * @param[in] handle resource handle.
+ * @param[in] max_batch_size maximum number of sums per batch
+ * (0 or 1 disables coalescing, at most 1048576).
+ * @param[in] max_delay_us maximum time a sum may be buffered.
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_resource_handle_set_coalescing(
+        alpha_resource_handle_t handle,
+        size_t max_batch_size,
+        double max_delay_us);
+
+/**
+ * @brief Allocates memory in the shared-memory segment the resource handle
+ * shares with its provider (see shm_size in the client's arguments).
+ * alpha_compute_sum_multi passes arrays allocated this way to the provider
+ * without any copy, while it copies other arrays into the segment.
+ *
+ * The memory must be freed with alpha_resource_handle_shm_free before
+ * the resource handle is released.
+ *
+ * @param[in] handle resource handle.
+ * @param[in] size size of the memory in bytes.
+ * @param[out] ptr allocated memory (aligned on 64 bytes).
+ *
+ * @return ALPHA_SUCCESS, ALPHA_ERR_OP_UNSUPPORTED if the resource handle has
+ * no segment (e.g. the provider is on another node or has not enabled shm
+ * in its configuration), ALPHA_ERR_ALLOCATION if
+ * the segment is full, or other error code defined in alpha-common.h
+ */
+alpha_return_t alpha_resource_handle_shm_alloc(
+        alpha_resource_handle_t handle,
+        size_t size,
+        void** ptr);
+
+/**
+ * @brief Frees memory allocated with alpha_resource_handle_shm_alloc.
+ *
+ * @param[in] handle resource handle.
+ * @param[in] ptr memory to free.
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_resource_handle_shm_free(
+        alpha_resource_handle_t handle,
+        void* ptr);
+
 /**
  * @brief Makes the target ALPHA resource compute the sum of the
  * two numbers and return the result.
@@ -73,6 +155,25 @@ alpha_return_t alpha_compute_sum(
         int32_t y,
         int32_t* result);
 
+/**
+ * @brief Non-blocking version of alpha_compute_sum. The result
+ * pointer must remain valid until the request has completed.
+ *
+ * @param[in] handle resource handle.
+ * @param[in] x first number.
+ * @param[in] y second number.
+ * @param[out] result resulting value.
+ * @param[out] req request to wait on.
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_compute_sum_async(
+        alpha_resource_handle_t handle,
+        int32_t x,
+        int32_t y,
+        int32_t* result,
+        alpha_request_t* req);
+
 /**
  * @brief Same as alpha_compute_sum but allows passing a timeout.
  *
@@ -95,6 +196,13 @@ alpha_return_t alpha_compute_sum_timed(
  * @brief Makes the target ALPHA resource compute the pair-wise sum of the
  * numbers in the x and y arrays and set the results in the result array.
  *
+ * If the provider lives in the client's margo instance (and local_shortcut
+ * is set in the client's arguments), the resource computes directly on the
+ * caller's arrays in a ULT of the provider's pool, without any RPC or bulk
+ * transfer. Otherwise, if the resource handle has a shared-memory segment,
+ * the arrays are placed in it (see alpha_resource_handle_shm_alloc) and
+ * the provider works on the segment, without any bulk transfer.
+ *
  * @param[in] handle resource handle.
  * @param[in] x first array of numbers.
  * @param[in] y second array of numbers.
@@ -109,6 +217,28 @@ alpha_return_t alpha_compute_sum_multi(
         const int32_t* y,
         int32_t* result);
 
+/**
+ * @brief Non-blocking version of alpha_compute_sum_multi. The x, y, and
+ * result arrays must remain valid until the request has completed.
+ * Operations on a co-located provider complete before this function
+ * returns.
+ *
+ * @param[in] handle resource handle.
+ * @param[in] x first array of numbers.
+ * @param[in] y second array of numbers.
+ * @param[out] result resulting values.
+ * @param[out] req request to wait on.
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_compute_sum_multi_async(
+        alpha_resource_handle_t handle,
+        size_t count,
+        const int32_t* x,
+        const int32_t* y,
+        int32_t* result,
+        alpha_request_t* req);
+
 /**
  * @brief Low-level version of alpha_compute_sum_multi based on user-provided
  * bulk handles.
@@ -127,6 +257,459 @@ alpha_return_t alpha_compute_sum_bulk(
         const alpha_bulk_location_t* y,
         const alpha_bulk_location_t* result);
 
+/**
+ * @brief Non-blocking version of alpha_compute_sum_bulk. The bulk
+ * handles and addresses must remain valid until the request has
+ * completed, since the RPC may be resent if the provider is busy.
+ *
+ * @param[in] handle resource handle.
+ * @param[in] x bulk location of the first array of numbers.
+ * @param[in] y bulk location of the second array of numbers.
+ * @param[out] result bulk location of the resulting values.
+ * @param[out] req request to wait on.
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_compute_sum_bulk_async(
+        alpha_resource_handle_t handle,
+        size_t count,
+        const alpha_bulk_location_t* x,
+        const alpha_bulk_location_t* y,
+        const alpha_bulk_location_t* result,
+        alpha_request_t* req);
+
+/**
+ * @brief In-place variant of alpha_compute_sum_bulk: makes the target
+ * ALPHA resource add the numbers of the x array to those of the y array
+ * (y += x). Only two regions are needed, and the provider borrows less
+ * scratch memory than for alpha_compute_sum_bulk.
+ *
+ * @param[in] handle resource handle.
+ * @param[in] x bulk location of the numbers to add.
+ * @param[in,out] y bulk location of the numbers to add to, which receives
+ * the resulting values.
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_compute_accumulate_bulk(
+        alpha_resource_handle_t handle,
+        size_t count,
+        const alpha_bulk_location_t* x,
+        const alpha_bulk_location_t* y);
+
+/**
+ * @brief Non-blocking version of alpha_compute_accumulate_bulk. The bulk
+ * handles and addresses must remain valid until the request has
+ * completed, since the RPC may be resent if the provider is busy.
+ *
+ * @param[in] handle resource handle.
+ * @param[in] x bulk location of the numbers to add.
+ * @param[in,out] y bulk location of the numbers to add to, which receives
+ * the resulting values.
+ * @param[out] req request to wait on.
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_compute_accumulate_bulk_async(
+        alpha_resource_handle_t handle,
+        size_t count,
+        const alpha_bulk_location_t* x,
+        const alpha_bulk_location_t* y,
+        alpha_request_t* req);
+
+/**
+ * @brief Variant of alpha_compute_sum_multi for arrays of any of the types
+ * of alpha_dtype_t. Integers wrap around on overflow. Arrays of int32_t
+ * take the same paths as with alpha_compute_sum_multi; arrays of other
+ * types are always sent through RDMA.
+ *
+ * @param[in] handle resource handle.
+ * @param[in] dtype type of the elements of the three arrays.
+ * @param[in] count number of elements of the arrays.
+ * @param[in] x first array of numbers.
+ * @param[in] y second array of numbers.
+ * @param[out] result resulting values.
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_compute_sum_multi_typed(
+        alpha_resource_handle_t handle,
+        alpha_dtype_t dtype,
+        size_t count,
+        const void* x,
+        const void* y,
+        void* result);
+
+/**
+ * @brief Non-blocking version of alpha_compute_sum_multi_typed. The x, y,
+ * and result arrays must remain valid until the request has completed.
+ *
+ * @param[in] handle resource handle.
+ * @param[in] dtype type of the elements of the three arrays.
+ * @param[in] count number of elements of the arrays.
+ * @param[in] x first array of numbers.
+ * @param[in] y second array of numbers.
+ * @param[out] result resulting values.
+ * @param[out] req request to wait on.
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_compute_sum_multi_typed_async(
+        alpha_resource_handle_t handle,
+        alpha_dtype_t dtype,
+        size_t count,
+        const void* x,
+        const void* y,
+        void* result,
+        alpha_request_t* req);
+
+/**
+ * @brief Variant of alpha_compute_sum_bulk for arrays of any of the types
+ * of alpha_dtype_t. The regions must hold count elements of that type.
+ *
+ * @param[in] handle resource handle.
+ * @param[in] dtype type of the elements of the three arrays.
+ * @param[in] count number of elements of the arrays.
+ * @param[in] x bulk location of the first array of numbers.
+ * @param[in] y bulk location of the second array of numbers.
+ * @param[out] result bulk location of the resulting values.
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_compute_sum_bulk_typed(
+        alpha_resource_handle_t handle,
+        alpha_dtype_t dtype,
+        size_t count,
+        const alpha_bulk_location_t* x,
+        const alpha_bulk_location_t* y,
+        const alpha_bulk_location_t* result);
+
+/**
+ * @brief Variant of alpha_compute_accumulate_bulk for arrays of any of the
+ * types of alpha_dtype_t.
+ *
+ * @param[in] handle resource handle.
+ * @param[in] dtype type of the elements of the two arrays.
+ * @param[in] count number of elements of the arrays.
+ * @param[in] x bulk location of the numbers to add.
+ * @param[in,out] y bulk location of the numbers to add to, which receives
+ * the resulting values.
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_compute_accumulate_bulk_typed(
+        alpha_resource_handle_t handle,
+        alpha_dtype_t dtype,
+        size_t count,
+        const alpha_bulk_location_t* x,
+        const alpha_bulk_location_t* y);
+
+/**
+ * @brief Variant of alpha_compute_sum_bulk_typed for arrays that are not
+ * contiguous in the memory exposed by their bulk handles, e.g. fields of
+ * arrays of structures, which would otherwise need to be packed first
+ * (see alpha_strided_location_t). The provider transfers elements or
+ * segments that are close to each other through windows of up to 1 MiB
+ * of their span, and the others one by one. The windows of the result are
+ * pulled before being pushed back, so the bytes between its elements are
+ * rewritten with their value and must not be modified during the call.
+ *
+ * @param[in] handle resource handle.
+ * @param[in] dtype type of the elements of the three arrays.
+ * @param[in] count number of elements of the arrays.
+ * @param[in] x location of the first array of numbers.
+ * @param[in] y location of the second array of numbers.
+ * @param[out] result location of the resulting values.
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_compute_sum_strided(
+        alpha_resource_handle_t handle,
+        alpha_dtype_t dtype,
+        size_t count,
+        const alpha_strided_location_t* x,
+        const alpha_strided_location_t* y,
+        const alpha_strided_location_t* result);
+
+/**
+ * @brief Non-blocking version of alpha_compute_sum_strided. The bulk
+ * handles, addresses, and segments must remain valid until the request
+ * has completed, since the RPC may be resent if the provider is busy.
+ *
+ * @param[in] handle resource handle.
+ * @param[in] dtype type of the elements of the three arrays.
+ * @param[in] count number of elements of the arrays.
+ * @param[in] x location of the first array of numbers.
+ * @param[in] y location of the second array of numbers.
+ * @param[out] result location of the resulting values.
+ * @param[out] req request to wait on.
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_compute_sum_strided_async(
+        alpha_resource_handle_t handle,
+        alpha_dtype_t dtype,
+        size_t count,
+        const alpha_strided_location_t* x,
+        const alpha_strided_location_t* y,
+        const alpha_strided_location_t* result,
+        alpha_request_t* req);
+
+/**
+ * @brief Uploads an array to the target provider, which keeps it so that
+ * it can be used as an operand of alpha_compute_sum_stored without being
+ * sent again. The array is kept until alpha_remove_array is called, or
+ * until it has not been used for the provider's "idle_timeout_ms", if
+ * set. Stored arrays belong to the provider, not to a resource.
+ *
+ * @param[in] handle resource handle.
+ * @param[in] dtype type of the elements of the array.
+ * @param[in] count number of elements of the array (at least 1).
+ * @param[in] data array to upload.
+ * @param[out] array_id id of the stored array.
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ * (ALPHA_ERR_ALLOCATION if the provider's stored arrays are full).
+ */
+alpha_return_t alpha_store_array(
+        alpha_resource_handle_t handle,
+        alpha_dtype_t dtype,
+        size_t count,
+        const void* data,
+        uint64_t* array_id);
+
+/**
+ * @brief Low-level version of alpha_store_array based on a user-provided
+ * bulk handle.
+ *
+ * @param[in] handle resource handle.
+ * @param[in] dtype type of the elements of the array.
+ * @param[in] count number of elements of the array (at least 1).
+ * @param[in] data bulk location of the array to upload.
+ * @param[out] array_id id of the stored array.
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_store_array_bulk(
+        alpha_resource_handle_t handle,
+        alpha_dtype_t dtype,
+        size_t count,
+        const alpha_bulk_location_t* data,
+        uint64_t* array_id);
+
+/**
+ * @brief Removes an array stored with alpha_store_array. RPCs already
+ * using the array complete normally.
+ *
+ * @param[in] handle resource handle.
+ * @param[in] array_id id of the stored array.
+ *
+ * @return ALPHA_SUCCESS, ALPHA_ERR_INVALID_ARRAY if there is no such
+ * array, or other error code defined in alpha-common.h
+ */
+alpha_return_t alpha_remove_array(
+        alpha_resource_handle_t handle,
+        uint64_t array_id);
+
+/**
+ * @brief Variant of alpha_compute_sum_multi_typed whose y operand is the
+ * first count elements of a stored array, so that only x and the result
+ * are transferred.
+ *
+ * @param[in] handle resource handle.
+ * @param[in] dtype type of the elements of the arrays, which must be
+ * that of the stored array.
+ * @param[in] count number of elements of the arrays.
+ * @param[in] x first array of numbers.
+ * @param[in] y_id id of the stored array to add to x.
+ * @param[out] result resulting values.
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_compute_sum_stored(
+        alpha_resource_handle_t handle,
+        alpha_dtype_t dtype,
+        size_t count,
+        const void* x,
+        uint64_t y_id,
+        void* result);
+
+/**
+ * @brief Non-blocking version of alpha_compute_sum_stored. The x and
+ * result arrays must remain valid until the request has completed.
+ *
+ * @param[in] handle resource handle.
+ * @param[in] dtype type of the elements of the arrays.
+ * @param[in] count number of elements of the arrays.
+ * @param[in] x first array of numbers.
+ * @param[in] y_id id of the stored array to add to x.
+ * @param[out] result resulting values.
+ * @param[out] req request to wait on.
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_compute_sum_stored_async(
+        alpha_resource_handle_t handle,
+        alpha_dtype_t dtype,
+        size_t count,
+        const void* x,
+        uint64_t y_id,
+        void* result,
+        alpha_request_t* req);
+
+/**
+ * @brief Low-level version of alpha_compute_sum_stored based on
+ * user-provided bulk handles.
+ *
+ * @param[in] handle resource handle.
+ * @param[in] dtype type of the elements of the arrays.
+ * @param[in] count number of elements of the arrays.
+ * @param[in] x bulk location of the first array of numbers.
+ * @param[in] y_id id of the stored array to add to x.
+ * @param[out] result bulk location of the resulting values.
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_compute_sum_stored_bulk(
+        alpha_resource_handle_t handle,
+        alpha_dtype_t dtype,
+        size_t count,
+        const alpha_bulk_location_t* x,
+        uint64_t y_id,
+        const alpha_bulk_location_t* result);
+
+/**
+ * @brief Creates a named array of count int32_t elements (initialized to 0)
+ * in the target resource, whose backend must support named arrays (e.g. the
+ * "files" backend, which keeps them in memory-mapped files so that they may
+ * be larger than memory and survive the provider). Names may only contain
+ * letters, digits, '_', '-', and '.' (except as first character).
+ *
+ * @param[in] handle resource handle.
+ * @param[in] name name of the array.
+ * @param[in] count number of elements of the array (at least 1).
+ *
+ * @return ALPHA_SUCCESS, ALPHA_ERR_INVALID_ARGS if the name is invalid or
+ * already taken, ALPHA_ERR_OP_UNSUPPORTED if the backend doesn't support
+ * named arrays, or other error code defined in alpha-common.h
+ */
+alpha_return_t alpha_create_named_array(
+        alpha_resource_handle_t handle,
+        const char* name,
+        size_t count);
+
+/**
+ * @brief Writes data to elements [offset, offset+count) of a named array.
+ *
+ * @param[in] handle resource handle.
+ * @param[in] name name of the array.
+ * @param[in] offset index of the first element to write.
+ * @param[in] count number of elements to write.
+ * @param[in] data elements to write.
+ *
+ * @return ALPHA_SUCCESS, ALPHA_ERR_INVALID_ARRAY if there is no such
+ * array, ALPHA_ERR_INVALID_ARGS if the range is out of the array,
+ * or other error code defined in alpha-common.h
+ */
+alpha_return_t alpha_write_named_array(
+        alpha_resource_handle_t handle,
+        const char* name,
+        size_t offset,
+        size_t count,
+        const int32_t* data);
+
+/**
+ * @brief Reads elements [offset, offset+count) of a named array into data.
+ *
+ * @param[in] handle resource handle.
+ * @param[in] name name of the array.
+ * @param[in] offset index of the first element to read.
+ * @param[in] count number of elements to read.
+ * @param[out] data elements read.
+ *
+ * @return ALPHA_SUCCESS, ALPHA_ERR_INVALID_ARRAY if there is no such
+ * array, ALPHA_ERR_INVALID_ARGS if the range is out of the array,
+ * or other error code defined in alpha-common.h
+ */
+alpha_return_t alpha_read_named_array(
+        alpha_resource_handle_t handle,
+        const char* name,
+        size_t offset,
+        size_t count,
+        int32_t* data);
+
+/**
+ * @brief Variant of alpha_compute_sum_multi whose y operand is elements
+ * [y_offset, y_offset+count) of a named array, so that only x and the
+ * result are transferred.
+ *
+ * @param[in] handle resource handle.
+ * @param[in] count number of elements of the arrays.
+ * @param[in] x first array of numbers.
+ * @param[in] y_name name of the array to add to x.
+ * @param[in] y_offset index of the first element of the named array to use.
+ * @param[out] result resulting values.
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_compute_sum_named(
+        alpha_resource_handle_t handle,
+        size_t count,
+        const int32_t* x,
+        const char* y_name,
+        size_t y_offset,
+        int32_t* result);
+
+/**
+ * @brief Makes the target ALPHA resource reduce the x array (or the x and
+ * y arrays, for ALPHA_REDUCE_DOT) to a single value, which is returned in
+ * the RPC's response instead of transferring a result array. Sums and dot
+ * products are computed on 64 bits, wrapping around on overflow.
+ * ALPHA_REDUCE_MIN and ALPHA_REDUCE_MAX require count > 0.
+ *
+ * @param[in] handle resource handle.
+ * @param[in] op reduction to compute.
+ * @param[in] count number of elements of the arrays.
+ * @param[in] x bulk location of the array to reduce.
+ * @param[in] y bulk location of the second array of a dot product
+ * (may be NULL for other reductions).
+ * @param[out] result resulting value.
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_compute_reduce_bulk(
+        alpha_resource_handle_t handle,
+        alpha_reduce_op_t op,
+        size_t count,
+        const alpha_bulk_location_t* x,
+        const alpha_bulk_location_t* y,
+        int64_t* result);
+
+/**
+ * @brief Non-blocking version of alpha_compute_reduce_bulk. The bulk
+ * handles and addresses, and the result pointer, must remain valid
+ * until the request has completed.
+ *
+ * @param[in] handle resource handle.
+ * @param[in] op reduction to compute.
+ * @param[in] count number of elements of the arrays.
+ * @param[in] x bulk location of the array to reduce.
+ * @param[in] y bulk location of the second array of a dot product
+ * (may be NULL for other reductions).
+ * @param[out] result resulting value.
+ * @param[out] req request to wait on.
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_compute_reduce_bulk_async(
+        alpha_resource_handle_t handle,
+        alpha_reduce_op_t op,
+        size_t count,
+        const alpha_bulk_location_t* x,
+        const alpha_bulk_location_t* y,
+        int64_t* result,
+        alpha_request_t* req);
+
 #ifdef __cplusplus
 }
 #endif
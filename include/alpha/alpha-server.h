@@ -13,8 +13,10 @@
 // TUTORIAL
 // ********
 //
-// A alpha_provider_t object is an object that (1) holds a resource instance and
-// (2) receives RPCs to be executed against this instance. It is initialized
+// A alpha_provider_t object is an object that (1) holds resource instances and
+// (2) receives RPCs to be executed against these instances. Resources are
+// identified within a provider by a resource id, which RPCs carry along with
+// the provider id. It is initialized
 // with a Margo instance ID, a provider ID, a configuration string, which
 // should be JSON-formatted, and some other optional arguments such as an Argobots
 // pool in which its RPCs will land.
@@ -32,14 +34,17 @@ typedef struct alpha_provider* alpha_provider_t;
 #define ALPHA_PROVIDER_IGNORE ((alpha_provider_t*)NULL)
 
 struct alpha_provider_args {
-    ABT_pool            pool;    // Pool used to run RPCs
-    alpha_backend_impl* backend; // Type of backend, will take priority over the "type" field in config
+    ABT_pool            pool;         // Pool used to run RPCs
+    alpha_backend_impl* backend;      // Type of backend, will take priority over the "type" field in config
+    ABT_pool            compute_pool; // Pool in which the computation of large requests is split
+                                      // into tasks (ABT_POOL_NULL to compute in the RPC's ULT)
     // ...
 };
 
 #define ALPHA_PROVIDER_ARGS_INIT { \
     /* .pool = */ ABT_POOL_NULL, \
-    /* .backend = */ NULL \
+    /* .backend = */ NULL, \
+    /* .compute_pool = */ ABT_POOL_NULL \
 }
 
 /**
@@ -71,6 +76,38 @@ alpha_return_t alpha_provider_register(
 alpha_return_t alpha_provider_destroy(
         alpha_provider_t provider);
 
+/**
+ * @brief Creates a new resource in the provider, using the backend
+ * of the given type. The resource id is the smallest id not in use
+ * in the provider.
+ *
+ * @param[in] provider Alpha provider
+ * @param[in] type name of the backend
+ * @param[in] config JSON-formatted configuration of the resource (may be NULL)
+ * @param[out] resource_id id of the created resource
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_provider_add_resource(
+        alpha_provider_t provider,
+        const char* type,
+        const char* config,
+        uint32_t* resource_id);
+
+/**
+ * @brief Removes a resource from the provider. The resource is destroyed
+ * once the RPCs in progress that use it have completed. Subsequent RPCs
+ * sent to this resource id will fail with ALPHA_ERR_INVALID_RESOURCE.
+ *
+ * @param[in] provider Alpha provider
+ * @param[in] resource_id id of the resource to remove
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_provider_remove_resource(
+        alpha_provider_t provider,
+        uint32_t resource_id);
+
 /**
  * @brief Returns a JSON-formatted configuration of the provider.
  *
@@ -83,6 +120,22 @@ alpha_return_t alpha_provider_destroy(
 char* alpha_provider_get_config(
         alpha_provider_t provider);
 
+/**
+ * @brief Returns JSON-formatted statistics about the provider
+ * (e.g. hits and misses of its buffer pool) and, unless disabled in
+ * the "metrics" section of its configuration, per-RPC metrics (call
+ * and error counts, bytes transferred, and latency histograms of each
+ * phase of the RPCs).
+ *
+ * The caller is responsible for freeing the returned pointer.
+ *
+ * @param provider Alpha provider
+ *
+ * @return a heap-allocated JSON string or NULL in case of an error.
+ */
+char* alpha_provider_get_stats(
+        alpha_provider_t provider);
+
 #ifdef __cplusplus
 }
 #endif
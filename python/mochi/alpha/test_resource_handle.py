@@ -56,3 +56,36 @@ class TestResourceHandle(unittest.TestCase):
         x = array.array('f', [1.0, 2.0, 3.0])
         with self.assertRaises(AlphaException) as context:
             handle.compute_sums(x, y, r)
+
+    def test_compute_sum_typed_arrays(self):
+        handle = self.client.make_resource_handle(address=self.engine.address,
+                                                  provider_id=42)
+        import array
+        for typecode in ['q', 'd']:
+            x = array.array(typecode, [1, 2, 3])
+            y = array.array(typecode, [4, 5, 6])
+            r = array.array(typecode, [0, 0, 0])
+            handle.compute_sums(x, y, r)
+            for i in range(0, 3):
+                self.assertEqual(r[i], x[i] + y[i])
+
+        x = array.array('q', [1 << 40, 2, 3])
+        y = array.array('q', [1 << 40, 5, 6])
+        r = array.array('q', [0, 0, 0])
+        handle.compute_sums(x, y, r)
+        self.assertEqual(r[0], 1 << 41)
+
+        x = array.array('d', [1.0, 2.0, 3.0])
+        with self.assertRaises(AlphaException) as context:
+            handle.compute_sums(x, y, r)
+
+    def test_multiple_resources(self):
+        resource_id = self.provider.add_resource("dummy")
+        self.assertEqual(resource_id, 1)
+        handle = self.client.make_resource_handle(address=self.engine.address,
+                                                  provider_id=42,
+                                                  resource_id=resource_id)
+        self.assertEqual(handle.compute_sum(1, 2), 3)
+        self.provider.remove_resource(resource_id)
+        with self.assertRaises(AlphaException) as context:
+            handle.compute_sum(1, 2)
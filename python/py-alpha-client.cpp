@@ -53,11 +53,12 @@ PYBIND11_MODULE(_pyalpha_client, m) {
             )",
             "engine"_a)
         .def("make_resource_handle",
-             [](const AlphaClient& client, const py::object& pyAddr, uint16_t provider_id, bool check) {
+             [](const AlphaClient& client, const py::object& pyAddr, uint16_t provider_id,
+                bool check, uint32_t resource_id) {
                 py::capsule addr = pyAddr.attr("get_internal_hg_addr")();
                 alpha_resource_handle_t handle = ALPHA_RESOURCE_HANDLE_NULL;
-                alpha_return_t ret = alpha_resource_handle_create(
-                    client, addr, provider_id, check, &handle);
+                alpha_return_t ret = alpha_resource_handle_create_with_id(
+                    client, addr, provider_id, resource_id, check, &handle);
                 if(ret != ALPHA_SUCCESS) {
                     throw AlphaException{
                         std::string{"Could not create alpha_resource_handle_t, "
@@ -76,13 +77,14 @@ PYBIND11_MODULE(_pyalpha_client, m) {
             address (str): Address of the process owning the resource.
             provider_id (int): Provider ID of the resource.
             check (Optional[bool]): Check that the provider exists.
+            resource_id (Optional[int]): ID of the resource within the provider.
 
             Returns
             -------
 
             A alpha.ResourceHandle instance.
             )",
-            "address"_a, "provider_id"_a, "check"_a=false)
+            "address"_a, "provider_id"_a, "check"_a=false, "resource_id"_a=0)
         ;
 
     py::class_<AlphaResourceHandle, std::shared_ptr<AlphaResourceHandle>>(m, "ResourceHandle")
@@ -149,12 +151,30 @@ PYBIND11_MODULE(_pyalpha_client, m) {
                     auto check_array_valid = [](const py::buffer& buf) {
                         auto info = buf.request();
                         if(info.ndim != 1) throw AlphaException{"Invalid array dimenion (should be 1)"};
-                        if(info.itemsize != sizeof(int32_t)) throw AlphaException{"Invalid itemsize"};
-                        if(info.format != py::format_descriptor<int32_t>::format())
-                            throw AlphaException{"Invalid array content type"};
+                        if(info.strides[0] != info.itemsize) throw AlphaException{"Array should be contiguous"};
                         return info;
                     };
 
+                    // the element type is given by the last character of the
+                    // buffer's format, optionally preceded by a native byte
+                    // order character (also accepted by NumPy for '<')
+                    auto get_dtype = [](const py::buffer_info& info) {
+                        const std::string& format = info.format;
+                        if(format.empty() || format.size() > 2
+                        || (format.size() == 2 && std::string{"@=<"}.find(format[0]) == std::string::npos))
+                            throw AlphaException{"Invalid array content type"};
+                        char c = format.back();
+                        if(std::string{"bhilq"}.find(c) != std::string::npos) {
+                            if(info.itemsize == sizeof(int32_t)) return ALPHA_DTYPE_I32;
+                            if(info.itemsize == sizeof(int64_t)) return ALPHA_DTYPE_I64;
+                        } else if(c == 'f' && info.itemsize == sizeof(float)) {
+                            return ALPHA_DTYPE_F32;
+                        } else if(c == 'd' && info.itemsize == sizeof(double)) {
+                            return ALPHA_DTYPE_F64;
+                        }
+                        throw AlphaException{"Invalid array content type"};
+                    };
+
                     py::buffer_info x_info = check_array_valid(x);
                     py::buffer_info y_info = check_array_valid(y);
                     py::buffer_info r_info = check_array_valid(r);
@@ -163,14 +183,17 @@ PYBIND11_MODULE(_pyalpha_client, m) {
                         throw AlphaException{"Buffers should be the same size"};
                     }
 
-                    alpha_return_t ret = alpha_compute_sum_multi(handle,
-                            x_info.size,
-                            (const int32_t*)x_info.ptr,
-                            (const int32_t*)y_info.ptr,
-                            (int32_t*)r_info.ptr);
+                    alpha_dtype_t dtype = get_dtype(x_info);
+                    if(get_dtype(y_info) != dtype || get_dtype(r_info) != dtype) {
+                        throw AlphaException{"Buffers should have the same content type"};
+                    }
+
+                    alpha_return_t ret = alpha_compute_sum_multi_typed(handle,
+                            dtype, x_info.size,
+                            x_info.ptr, y_info.ptr, r_info.ptr);
                     if(ret != ALPHA_SUCCESS) {
                         throw AlphaException{
-                            std::string{"alpha_compute_sum_multi failed with error code "}
+                            std::string{"alpha_compute_sum_multi_typed failed with error code "}
                             + std::to_string(ret)
                         };
                     }
@@ -181,9 +204,11 @@ PYBIND11_MODULE(_pyalpha_client, m) {
             Parameters
             ----------
 
-            x (array[int]): First array of numbers.
-            y (array[int]): Second array of number.
-            r (array[int]): Wrray in which to place the results.
+            x (array): First array of numbers (32 or 64-bit integers,
+                       or single or double precision floats).
+            y (array): Second array of number, of the same type as x.
+            r (array): Array in which to place the results, of the same
+                       type as x.
 
             Returns
             -------
@@ -55,5 +55,53 @@ PYBIND11_MODULE(_pyalpha_server, m) {
             "provider_id"_a,
             "config"_a,
             py::keep_alive<1, 2>())
+        .def("add_resource",
+             [](const AlphaProvider& provider, const std::string& type, const py::dict& config) {
+                auto config_str = dict_to_json(config);
+                uint32_t resource_id = 0;
+                alpha_return_t ret = alpha_provider_add_resource(
+                    provider, type.c_str(), config_str.c_str(), &resource_id);
+                if(ret != ALPHA_SUCCESS) {
+                    throw std::runtime_error{
+                        std::string{"Could not add resource. alpha_provider_add_resource returned "}
+                        + std::to_string(ret)
+                    };
+                }
+                return resource_id;
+             },
+            R"(
+            Add a resource to the provider.
+
+            Parameters
+            ----------
+
+            type (str): Type of backend.
+            config (Optional[dict]): Configuration of the resource.
+
+            Returns
+            -------
+
+            The ID of the new resource.
+            )",
+            "type"_a, "config"_a=py::dict())
+        .def("remove_resource",
+             [](const AlphaProvider& provider, uint32_t resource_id) {
+                alpha_return_t ret = alpha_provider_remove_resource(provider, resource_id);
+                if(ret != ALPHA_SUCCESS) {
+                    throw std::runtime_error{
+                        std::string{"Could not remove resource. alpha_provider_remove_resource returned "}
+                        + std::to_string(ret)
+                    };
+                }
+             },
+            R"(
+            Remove a resource from the provider.
+
+            Parameters
+            ----------
+
+            resource_id (int): ID of the resource to remove.
+            )",
+            "resource_id"_a)
         ;
 }
@@ -0,0 +1,261 @@
+/*
+ * (C) 2020 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "addr-cache.h"
+
+#define ALPHA_ADDR_CACHE_DEFAULT_CAPACITY 64
+
+struct alpha_addr_cache {
+    margo_instance_id   mid;
+    ABT_mutex           mutex;
+    size_t              capacity;    // max number of cached entries
+    size_t              size;        // current number of cached entries
+    size_t              num_buckets; // power of 2
+    alpha_cached_addr** buckets;
+    alpha_cached_addr*  lru_head;    // most recently used
+    alpha_cached_addr*  lru_tail;    // least recently used
+    uint64_t            hits;
+    uint64_t            misses;
+    uint64_t            source_hits; // misses resolved by reusing the source address
+    uint64_t            lookups;     // calls to margo_addr_lookup
+};
+
+static uint64_t hash_string(const char* str)
+{
+    /* FNV-1a */
+    uint64_t h = 14695981039346656037ULL;
+    for(; *str; ++str) {
+        h ^= (unsigned char)*str;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+static void lru_unlink(alpha_addr_cache_t cache, alpha_cached_addr* e)
+{
+    if(e->lru_prev) e->lru_prev->lru_next = e->lru_next;
+    else cache->lru_head = e->lru_next;
+    if(e->lru_next) e->lru_next->lru_prev = e->lru_prev;
+    else cache->lru_tail = e->lru_prev;
+    e->lru_prev = e->lru_next = NULL;
+}
+
+static void lru_push_front(alpha_addr_cache_t cache, alpha_cached_addr* e)
+{
+    e->lru_prev = NULL;
+    e->lru_next = cache->lru_head;
+    if(cache->lru_head) cache->lru_head->lru_prev = e;
+    cache->lru_head = e;
+    if(!cache->lru_tail) cache->lru_tail = e;
+}
+
+static alpha_cached_addr* table_find(
+        alpha_addr_cache_t cache, const char* key, uint64_t hash)
+{
+    alpha_cached_addr* e = cache->buckets[hash & (cache->num_buckets - 1)];
+    for(; e; e = e->bucket_next) {
+        if(e->hash == hash && strcmp(e->key, key) == 0)
+            return e;
+    }
+    return NULL;
+}
+
+static void table_remove(alpha_addr_cache_t cache, alpha_cached_addr* e)
+{
+    alpha_cached_addr** p = &cache->buckets[e->hash & (cache->num_buckets - 1)];
+    while(*p && *p != e) p = &(*p)->bucket_next;
+    if(*p) *p = e->bucket_next;
+    e->bucket_next = NULL;
+}
+
+static void entry_free(alpha_addr_cache_t cache, alpha_cached_addr* e)
+{
+    margo_addr_free(cache->mid, e->addr);
+    free(e->key);
+    free(e);
+}
+
+/* must be called with the mutex locked; returns the entry to free, if any */
+static alpha_cached_addr* evict_one(alpha_addr_cache_t cache)
+{
+    alpha_cached_addr* e = cache->lru_tail;
+    if(!e) return NULL;
+    lru_unlink(cache, e);
+    table_remove(cache, e);
+    e->in_cache = false;
+    cache->size -= 1;
+    return e->refcount == 0 ? e : NULL;
+}
+
+alpha_return_t alpha_addr_cache_create(
+        margo_instance_id mid,
+        struct json_object* config,
+        alpha_addr_cache_t* cache)
+{
+    size_t capacity = ALPHA_ADDR_CACHE_DEFAULT_CAPACITY;
+    if(config) {
+        if(!json_object_is_type(config, json_type_object)) {
+            margo_error(mid, "\"addr_cache\" field should be an object in provider configuration");
+            return ALPHA_ERR_INVALID_CONFIG;
+        }
+        struct json_object* jcapacity = json_object_object_get(config, "capacity");
+        if(jcapacity) {
+            if(!json_object_is_type(jcapacity, json_type_int)
+            || json_object_get_int64(jcapacity) < 0) {
+                margo_error(mid, "\"capacity\" field in address cache configuration should be a positive integer");
+                return ALPHA_ERR_INVALID_CONFIG;
+            }
+            capacity = (size_t)json_object_get_int64(jcapacity);
+        }
+    }
+
+    alpha_addr_cache_t c = (alpha_addr_cache_t)calloc(1, sizeof(*c));
+    if(!c) return ALPHA_ERR_ALLOCATION;
+    c->num_buckets = 1;
+    while(c->num_buckets < 2*capacity) c->num_buckets *= 2;
+    c->buckets = (alpha_cached_addr**)calloc(c->num_buckets, sizeof(*c->buckets));
+    if(!c->buckets) {
+        free(c);
+        return ALPHA_ERR_ALLOCATION;
+    }
+    c->mid      = mid;
+    c->capacity = capacity;
+    ABT_mutex_create(&c->mutex);
+
+    *cache = c;
+    return ALPHA_SUCCESS;
+}
+
+void alpha_addr_cache_destroy(alpha_addr_cache_t cache)
+{
+    if(!cache) return;
+    while(cache->lru_tail) {
+        alpha_cached_addr* e = evict_one(cache);
+        if(e) entry_free(cache, e);
+    }
+    ABT_mutex_free(&cache->mutex);
+    free(cache->buckets);
+    free(cache);
+}
+
+hg_return_t alpha_addr_cache_lookup(
+        alpha_addr_cache_t cache,
+        const char* address,
+        hg_addr_t source,
+        alpha_cached_addr** entry)
+{
+    hg_return_t hret = HG_SUCCESS;
+    uint64_t hash = hash_string(address);
+
+    /* fast path: the address is in the cache */
+    ABT_mutex_lock(cache->mutex);
+    alpha_cached_addr* e = table_find(cache, address, hash);
+    if(e) {
+        e->refcount += 1;
+        lru_unlink(cache, e);
+        lru_push_front(cache, e);
+        cache->hits += 1;
+        ABT_mutex_unlock(cache->mutex);
+        *entry = e;
+        return HG_SUCCESS;
+    }
+    cache->misses += 1;
+    ABT_mutex_unlock(cache->mutex);
+
+    /* slow path: resolve the address without holding the lock */
+    e = (alpha_cached_addr*)calloc(1, sizeof(*e));
+    if(!e) return HG_NOMEM;
+    e->key = strdup(address);
+    if(!e->key) {
+        free(e);
+        return HG_NOMEM;
+    }
+    e->hash     = hash;
+    e->refcount = 1;
+    e->addr     = HG_ADDR_NULL;
+
+    bool from_source = false;
+    if(source != HG_ADDR_NULL) {
+        char source_str[256];
+        hg_size_t source_str_size = sizeof(source_str);
+        hret = margo_addr_to_string(cache->mid, source_str, &source_str_size, source);
+        if(hret == HG_SUCCESS && strcmp(source_str, address) == 0)
+            from_source = margo_addr_dup(cache->mid, source, &e->addr) == HG_SUCCESS;
+    }
+    if(!from_source) {
+        hret = margo_addr_lookup(cache->mid, address, &e->addr);
+        if(hret != HG_SUCCESS) {
+            free(e->key);
+            free(e);
+            return hret;
+        }
+    }
+
+    alpha_cached_addr* to_free = NULL;
+    ABT_mutex_lock(cache->mutex);
+    if(from_source) cache->source_hits += 1;
+    else cache->lookups += 1;
+    alpha_cached_addr* existing = table_find(cache, address, hash);
+    if(existing) {
+        /* another ULT inserted the same address in the meantime */
+        existing->refcount += 1;
+        to_free = e;
+        e = existing;
+    } else if(cache->capacity > 0) {
+        if(cache->size == cache->capacity)
+            to_free = evict_one(cache);
+        size_t b = hash & (cache->num_buckets - 1);
+        e->bucket_next = cache->buckets[b];
+        cache->buckets[b] = e;
+        e->in_cache = true;
+        lru_push_front(cache, e);
+        cache->size += 1;
+    }
+    ABT_mutex_unlock(cache->mutex);
+
+    if(to_free) entry_free(cache, to_free);
+    *entry = e;
+    return HG_SUCCESS;
+}
+
+void alpha_addr_cache_release(
+        alpha_addr_cache_t cache,
+        alpha_cached_addr* entry)
+{
+    if(!entry) return;
+    ABT_mutex_lock(cache->mutex);
+    entry->refcount -= 1;
+    bool must_free = entry->refcount == 0 && !entry->in_cache;
+    ABT_mutex_unlock(cache->mutex);
+    if(must_free) entry_free(cache, entry);
+}
+
+struct json_object* alpha_addr_cache_get_config(alpha_addr_cache_t cache)
+{
+    struct json_object* config = json_object_new_object();
+    json_object_object_add(config, "capacity",
+        json_object_new_int64((int64_t)cache->capacity));
+    return config;
+}
+
+struct json_object* alpha_addr_cache_get_stats(alpha_addr_cache_t cache)
+{
+    struct json_object* stats = json_object_new_object();
+    ABT_mutex_lock(cache->mutex);
+    json_object_object_add(stats, "hits",
+        json_object_new_int64((int64_t)cache->hits));
+    json_object_object_add(stats, "misses",
+        json_object_new_int64((int64_t)cache->misses));
+    json_object_object_add(stats, "source_hits",
+        json_object_new_int64((int64_t)cache->source_hits));
+    json_object_object_add(stats, "lookups",
+        json_object_new_int64((int64_t)cache->lookups));
+    json_object_object_add(stats, "size",
+        json_object_new_int64((int64_t)cache->size));
+    ABT_mutex_unlock(cache->mutex);
+    return stats;
+}
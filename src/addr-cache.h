@@ -0,0 +1,93 @@
+/*
+ * (C) 2020 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef _ADDR_CACHE_H
+#define _ADDR_CACHE_H
+
+#include <margo.h>
+#include <json-c/json.h>
+#include "alpha/alpha-common.h"
+
+/**
+ * @brief Address resolved by an alpha_addr_cache_t.
+ * The addr field may be used until the entry is released.
+ */
+typedef struct alpha_cached_addr {
+    hg_addr_t addr;
+    /* fields below are private to the cache */
+    char*                     key;
+    uint64_t                  hash;
+    uint64_t                  refcount;
+    bool                      in_cache;
+    struct alpha_cached_addr* lru_prev;
+    struct alpha_cached_addr* lru_next;
+    struct alpha_cached_addr* bucket_next;
+} alpha_cached_addr;
+
+/**
+ * @brief Cache mapping address strings to hg_addr_t, with LRU eviction.
+ * Entries are reference-counted, so that an entry evicted while in use
+ * is only freed when its last user releases it.
+ */
+typedef struct alpha_addr_cache* alpha_addr_cache_t;
+
+/**
+ * @brief Creates an address cache from its JSON configuration,
+ * e.g. { "capacity": 64 }. A capacity of 0 disables caching.
+ *
+ * @param[in] mid Margo instance
+ * @param[in] config JSON configuration (may be NULL)
+ * @param[out] cache created cache
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_addr_cache_create(
+        margo_instance_id mid,
+        struct json_object* config,
+        alpha_addr_cache_t* cache);
+
+/**
+ * @brief Destroys the cache. All the entries must have been released.
+ */
+void alpha_addr_cache_destroy(alpha_addr_cache_t cache);
+
+/**
+ * @brief Resolves an address string. If the string is not in the cache
+ * and matches the string representation of source (typically the address
+ * of the process that sent the RPC being handled), source is duplicated
+ * instead of calling margo_addr_lookup.
+ *
+ * @param[in] cache address cache
+ * @param[in] address address string
+ * @param[in] source address to reuse if it matches (may be HG_ADDR_NULL)
+ * @param[out] entry cache entry, to release with alpha_addr_cache_release
+ *
+ * @return HG_SUCCESS or the error returned by Mercury
+ */
+hg_return_t alpha_addr_cache_lookup(
+        alpha_addr_cache_t cache,
+        const char* address,
+        hg_addr_t source,
+        alpha_cached_addr** entry);
+
+/**
+ * @brief Releases an entry obtained by alpha_addr_cache_lookup.
+ * Passing NULL is valid and does nothing.
+ */
+void alpha_addr_cache_release(
+        alpha_addr_cache_t cache,
+        alpha_cached_addr* entry);
+
+/**
+ * @brief Returns the configuration of the cache as a JSON object.
+ */
+struct json_object* alpha_addr_cache_get_config(alpha_addr_cache_t cache);
+
+/**
+ * @brief Returns the hit/miss/lookup counters of the cache as a JSON object.
+ */
+struct json_object* alpha_addr_cache_get_stats(alpha_addr_cache_t cache);
+
+#endif
@@ -0,0 +1,191 @@
+/*
+ * (C) 2020 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#include <stdlib.h>
+#include "admission.h"
+
+#define ALPHA_ADMISSION_DEFAULT_MAX_QUEUE_SIZE 256
+#define ALPHA_ADMISSION_DEFAULT_RETRY_AFTER_MS 10
+
+struct alpha_admission {
+    margo_instance_id mid;
+    bool              enabled;         // false if there is no limit
+    size_t            max_requests;    // 0 for no limit
+    size_t            max_bytes;       // 0 for no limit
+    size_t            max_queue_size;  // max number of waiting RPCs
+    uint32_t          retry_after_ms;  // hint sent with ALPHA_ERR_BUSY
+    ABT_mutex         mutex;
+    ABT_cond          cond;            // signaled when an RPC leaves or is admitted
+    size_t            in_flight_requests;
+    size_t            in_flight_bytes;
+    /* waiting RPCs are admitted in the order of their ticket */
+    uint64_t          next_ticket;
+    uint64_t          head_ticket;
+    size_t            queue_depth;
+    size_t            max_queue_depth;
+    uint64_t          queued;
+    uint64_t          rejected;
+};
+
+static alpha_return_t read_size(
+        margo_instance_id mid, struct json_object* config,
+        const char* name, size_t* value)
+{
+    struct json_object* jvalue = json_object_object_get(config, name);
+    if(!jvalue) return ALPHA_SUCCESS;
+    if(!json_object_is_type(jvalue, json_type_int)
+    || json_object_get_int64(jvalue) < 0) {
+        margo_error(mid, "\"%s\" field in admission configuration should be a positive integer", name);
+        return ALPHA_ERR_INVALID_CONFIG;
+    }
+    *value = (size_t)json_object_get_int64(jvalue);
+    return ALPHA_SUCCESS;
+}
+
+alpha_return_t alpha_admission_create(
+        margo_instance_id mid,
+        struct json_object* config,
+        alpha_admission_t* admission)
+{
+    size_t max_requests   = 0;
+    size_t max_bytes      = 0;
+    size_t max_queue_size = ALPHA_ADMISSION_DEFAULT_MAX_QUEUE_SIZE;
+    size_t retry_after_ms = ALPHA_ADMISSION_DEFAULT_RETRY_AFTER_MS;
+    if(config) {
+        if(!json_object_is_type(config, json_type_object)) {
+            margo_error(mid, "\"admission\" field should be an object in provider configuration");
+            return ALPHA_ERR_INVALID_CONFIG;
+        }
+        alpha_return_t ret;
+        if((ret = read_size(mid, config, "max_requests", &max_requests)) != ALPHA_SUCCESS
+        || (ret = read_size(mid, config, "max_bytes", &max_bytes)) != ALPHA_SUCCESS
+        || (ret = read_size(mid, config, "max_queue_size", &max_queue_size)) != ALPHA_SUCCESS
+        || (ret = read_size(mid, config, "retry_after_ms", &retry_after_ms)) != ALPHA_SUCCESS)
+            return ret;
+        if(retry_after_ms > UINT32_MAX) {
+            margo_error(mid, "\"retry_after_ms\" field in admission configuration is too large");
+            return ALPHA_ERR_INVALID_CONFIG;
+        }
+    }
+
+    alpha_admission_t a = (alpha_admission_t)calloc(1, sizeof(*a));
+    if(!a) return ALPHA_ERR_ALLOCATION;
+    a->mid            = mid;
+    a->enabled        = max_requests || max_bytes;
+    a->max_requests   = max_requests;
+    a->max_bytes      = max_bytes;
+    a->max_queue_size = max_queue_size;
+    a->retry_after_ms = (uint32_t)retry_after_ms;
+    ABT_mutex_create(&a->mutex);
+    ABT_cond_create(&a->cond);
+
+    *admission = a;
+    return ALPHA_SUCCESS;
+}
+
+void alpha_admission_destroy(alpha_admission_t admission)
+{
+    if(!admission) return;
+    ABT_cond_free(&admission->cond);
+    ABT_mutex_free(&admission->mutex);
+    free(admission);
+}
+
+/* must be called with the mutex locked */
+static inline bool fits(alpha_admission_t a, size_t bytes)
+{
+    if(a->max_requests && a->in_flight_requests >= a->max_requests)
+        return false;
+    if(a->max_bytes && a->in_flight_bytes + bytes > a->max_bytes)
+        return false;
+    return true;
+}
+
+alpha_return_t alpha_admission_enter(
+        alpha_admission_t admission,
+        size_t bytes,
+        uint32_t* retry_after_ms)
+{
+    if(!admission->enabled) return ALPHA_SUCCESS;
+    alpha_admission_t a = admission;
+
+    ABT_mutex_lock(a->mutex);
+    /* an RPC that would exceed max_bytes on its own would never fit */
+    if(a->max_bytes && bytes > a->max_bytes) {
+        a->rejected += 1;
+        ABT_mutex_unlock(a->mutex);
+        return ALPHA_ERR_ALLOCATION;
+    }
+    if(a->queue_depth || !fits(a, bytes)) {
+        if(a->queue_depth >= a->max_queue_size) {
+            a->rejected += 1;
+            ABT_mutex_unlock(a->mutex);
+            *retry_after_ms = a->retry_after_ms;
+            return ALPHA_ERR_BUSY;
+        }
+        uint64_t ticket = a->next_ticket++;
+        a->queue_depth += 1;
+        a->queued      += 1;
+        if(a->queue_depth > a->max_queue_depth)
+            a->max_queue_depth = a->queue_depth;
+        while(ticket != a->head_ticket || !fits(a, bytes))
+            ABT_cond_wait(a->cond, a->mutex);
+        a->head_ticket += 1;
+        a->queue_depth -= 1;
+        /* the next RPC in the queue may fit as well */
+        ABT_cond_broadcast(a->cond);
+    }
+    a->in_flight_requests += 1;
+    a->in_flight_bytes    += bytes;
+    ABT_mutex_unlock(a->mutex);
+    return ALPHA_SUCCESS;
+}
+
+void alpha_admission_leave(
+        alpha_admission_t admission,
+        size_t bytes)
+{
+    if(!admission->enabled) return;
+    alpha_admission_t a = admission;
+    ABT_mutex_lock(a->mutex);
+    a->in_flight_requests -= 1;
+    a->in_flight_bytes    -= bytes;
+    if(a->queue_depth) ABT_cond_broadcast(a->cond);
+    ABT_mutex_unlock(a->mutex);
+}
+
+struct json_object* alpha_admission_get_config(alpha_admission_t admission)
+{
+    struct json_object* config = json_object_new_object();
+    json_object_object_add(config, "max_requests",
+        json_object_new_int64((int64_t)admission->max_requests));
+    json_object_object_add(config, "max_bytes",
+        json_object_new_int64((int64_t)admission->max_bytes));
+    json_object_object_add(config, "max_queue_size",
+        json_object_new_int64((int64_t)admission->max_queue_size));
+    json_object_object_add(config, "retry_after_ms",
+        json_object_new_int64((int64_t)admission->retry_after_ms));
+    return config;
+}
+
+struct json_object* alpha_admission_get_stats(alpha_admission_t admission)
+{
+    struct json_object* stats = json_object_new_object();
+    ABT_mutex_lock(admission->mutex);
+    json_object_object_add(stats, "in_flight_requests",
+        json_object_new_int64((int64_t)admission->in_flight_requests));
+    json_object_object_add(stats, "in_flight_bytes",
+        json_object_new_int64((int64_t)admission->in_flight_bytes));
+    json_object_object_add(stats, "queue_depth",
+        json_object_new_int64((int64_t)admission->queue_depth));
+    json_object_object_add(stats, "max_queue_depth",
+        json_object_new_int64((int64_t)admission->max_queue_depth));
+    json_object_object_add(stats, "queued",
+        json_object_new_int64((int64_t)admission->queued));
+    json_object_object_add(stats, "rejected",
+        json_object_new_int64((int64_t)admission->rejected));
+    ABT_mutex_unlock(admission->mutex);
+    return stats;
+}
@@ -0,0 +1,89 @@
+/*
+ * (C) 2020 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef _ADMISSION_H
+#define _ADMISSION_H
+
+#include <margo.h>
+#include <json-c/json.h>
+#include "alpha/alpha-common.h"
+
+/**
+ * @brief Admission control of the RPCs of a provider. An RPC is admitted
+ * if the number of RPCs in flight and the number of bytes of scratch memory
+ * they use stay within the configured limits. Otherwise it waits in a
+ * bounded FIFO queue, and is rejected with ALPHA_ERR_BUSY if the queue
+ * is full.
+ */
+typedef struct alpha_admission* alpha_admission_t;
+
+/**
+ * @brief Creates an admission controller from its JSON configuration, e.g.
+ * { "max_requests": 64, "max_bytes": 1073741824, "max_queue_size": 256,
+ *   "retry_after_ms": 10 }.
+ * A max_requests or max_bytes of 0 means no limit (the default). With no
+ * limit at all, RPCs are admitted without taking any lock. A non-zero
+ * max_bytes should leave room for a pipelined request, i.e. for
+ * 2*ALPHA_PIPELINE_DEPTH chunks.
+ *
+ * @param[in] mid Margo instance
+ * @param[in] config JSON configuration (may be NULL)
+ * @param[out] admission created admission controller
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_admission_create(
+        margo_instance_id mid,
+        struct json_object* config,
+        alpha_admission_t* admission);
+
+/**
+ * @brief Destroys the admission controller. No RPC should be in flight.
+ * Passing NULL is valid and does nothing.
+ */
+void alpha_admission_destroy(alpha_admission_t admission);
+
+/**
+ * @brief Admits an RPC that will use the given number of bytes of scratch
+ * memory, waiting in the queue if needed. An RPC using more bytes than
+ * max_bytes on its own is rejected, since it would never fit (requests
+ * are pipelined so that their scratch memory doesn't grow with their
+ * size, except for sum_strided; inline arrays are bounded by
+ * ALPHA_MAX_INLINE_COUNT).
+ *
+ * @param[in] admission admission controller
+ * @param[in] bytes scratch memory needed by the RPC
+ * @param[out] retry_after_ms delay after which the client should retry,
+ *             set if the RPC is rejected
+ *
+ * @return ALPHA_SUCCESS, ALPHA_ERR_BUSY if the queue is full, or
+ *         ALPHA_ERR_ALLOCATION if the RPC needs more than max_bytes
+ */
+alpha_return_t alpha_admission_enter(
+        alpha_admission_t admission,
+        size_t bytes,
+        uint32_t* retry_after_ms);
+
+/**
+ * @brief Signals the end of an RPC admitted by alpha_admission_enter
+ * with the same number of bytes.
+ */
+void alpha_admission_leave(
+        alpha_admission_t admission,
+        size_t bytes);
+
+/**
+ * @brief Returns the configuration of the admission controller as a JSON object.
+ */
+struct json_object* alpha_admission_get_config(alpha_admission_t admission);
+
+/**
+ * @brief Returns the state of the admission controller (RPCs and bytes in
+ * flight, current and max queue depth, number of queued and rejected RPCs)
+ * as a JSON object.
+ */
+struct json_object* alpha_admission_get_stats(alpha_admission_t admission);
+
+#endif
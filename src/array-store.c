@@ -0,0 +1,256 @@
+/*
+ * (C) 2020 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#include <stdlib.h>
+#include "array-store.h"
+
+#define ALPHA_ARRAY_STORE_DEFAULT_MAX_BYTES  (256*1024*1024)
+#define ALPHA_ARRAY_STORE_DEFAULT_MAX_ARRAYS 1024
+
+struct alpha_array_store {
+    margo_instance_id   mid;
+    size_t              max_bytes;       // 0 if stored arrays are disabled
+    size_t              max_arrays;
+    uint64_t            idle_timeout_ms; // 0 if arrays don't expire
+    ABT_mutex           mutex;
+    alpha_stored_array* arrays;          // published arrays
+    uint64_t            next_id;
+    size_t              num_arrays;      // reserved or published
+    size_t              num_bytes;       // allocated, including removed arrays still in use
+    uint64_t            expired;
+    uint64_t            rejected;
+};
+
+static alpha_return_t read_size(
+        margo_instance_id mid, struct json_object* config,
+        const char* name, size_t* value)
+{
+    struct json_object* jvalue = json_object_object_get(config, name);
+    if(!jvalue) return ALPHA_SUCCESS;
+    if(!json_object_is_type(jvalue, json_type_int)
+    || json_object_get_int64(jvalue) < 0) {
+        margo_error(mid, "\"%s\" field in stored_arrays configuration should be a positive integer", name);
+        return ALPHA_ERR_INVALID_CONFIG;
+    }
+    *value = (size_t)json_object_get_int64(jvalue);
+    return ALPHA_SUCCESS;
+}
+
+alpha_return_t alpha_array_store_create(
+        margo_instance_id mid,
+        struct json_object* config,
+        alpha_array_store_t* store)
+{
+    size_t max_bytes       = ALPHA_ARRAY_STORE_DEFAULT_MAX_BYTES;
+    size_t max_arrays      = ALPHA_ARRAY_STORE_DEFAULT_MAX_ARRAYS;
+    size_t idle_timeout_ms = 0;
+    if(config) {
+        if(!json_object_is_type(config, json_type_object)) {
+            margo_error(mid, "\"stored_arrays\" field should be an object in provider configuration");
+            return ALPHA_ERR_INVALID_CONFIG;
+        }
+        alpha_return_t ret;
+        if((ret = read_size(mid, config, "max_bytes", &max_bytes)) != ALPHA_SUCCESS
+        || (ret = read_size(mid, config, "max_arrays", &max_arrays)) != ALPHA_SUCCESS
+        || (ret = read_size(mid, config, "idle_timeout_ms", &idle_timeout_ms)) != ALPHA_SUCCESS)
+            return ret;
+    }
+
+    alpha_array_store_t s = (alpha_array_store_t)calloc(1, sizeof(*s));
+    if(!s) return ALPHA_ERR_ALLOCATION;
+    s->mid             = mid;
+    s->max_bytes       = max_bytes;
+    s->max_arrays      = max_arrays;
+    s->idle_timeout_ms = idle_timeout_ms;
+    s->next_id         = 1;
+    ABT_mutex_create(&s->mutex);
+
+    *store = s;
+    return ALPHA_SUCCESS;
+}
+
+static void free_array(alpha_stored_array* array)
+{
+    free(array->data);
+    free(array);
+}
+
+void alpha_array_store_destroy(alpha_array_store_t store)
+{
+    if(!store) return;
+    while(store->arrays) {
+        alpha_stored_array* array = store->arrays;
+        store->arrays = array->next;
+        free_array(array);
+    }
+    ABT_mutex_free(&store->mutex);
+    free(store);
+}
+
+/* must be called with the mutex locked */
+static void drop_reference(alpha_array_store_t store, alpha_stored_array* array)
+{
+    array->refcount -= 1;
+    if(array->refcount) return;
+    store->num_arrays -= 1;
+    store->num_bytes  -= array->size;
+    free_array(array);
+}
+
+/* must be called with the mutex locked */
+static void remove_expired(alpha_array_store_t store, double now)
+{
+    if(!store->idle_timeout_ms) return;
+    double timeout = (double)store->idle_timeout_ms / 1000.0;
+    alpha_stored_array** prev = &store->arrays;
+    while(*prev) {
+        alpha_stored_array* array = *prev;
+        if(now - array->last_used >= timeout) {
+            *prev = array->next;
+            store->expired += 1;
+            drop_reference(store, array);
+        } else {
+            prev = &array->next;
+        }
+    }
+}
+
+alpha_return_t alpha_array_store_reserve(
+        alpha_array_store_t store,
+        alpha_dtype_t dtype,
+        size_t count,
+        alpha_stored_array** array)
+{
+    size_t elem_size = alpha_dtype_size(dtype);
+    if(count == 0 || count > SIZE_MAX / elem_size)
+        return ALPHA_ERR_INVALID_ARGS;
+    size_t size = count*elem_size;
+
+    ABT_mutex_lock(store->mutex);
+    remove_expired(store, ABT_get_wtime());
+    if(store->num_arrays >= store->max_arrays
+    || store->num_bytes > store->max_bytes
+    || size > store->max_bytes - store->num_bytes) {
+        store->rejected += 1;
+        ABT_mutex_unlock(store->mutex);
+        return ALPHA_ERR_ALLOCATION;
+    }
+    store->num_arrays += 1;
+    store->num_bytes  += size;
+    ABT_mutex_unlock(store->mutex);
+
+    alpha_stored_array* a = (alpha_stored_array*)calloc(1, sizeof(*a));
+    if(a) a->data = malloc(size);
+    if(!a || !a->data) {
+        free(a);
+        ABT_mutex_lock(store->mutex);
+        store->num_arrays -= 1;
+        store->num_bytes  -= size;
+        ABT_mutex_unlock(store->mutex);
+        return ALPHA_ERR_ALLOCATION;
+    }
+    a->dtype    = dtype;
+    a->count    = count;
+    a->size     = size;
+    a->refcount = 1;
+    *array = a;
+    return ALPHA_SUCCESS;
+}
+
+uint64_t alpha_array_store_publish(
+        alpha_array_store_t store,
+        alpha_stored_array* array)
+{
+    ABT_mutex_lock(store->mutex);
+    array->id        = store->next_id++;
+    array->last_used = ABT_get_wtime();
+    array->next      = store->arrays;
+    store->arrays    = array;
+    ABT_mutex_unlock(store->mutex);
+    return array->id;
+}
+
+void alpha_array_store_discard(
+        alpha_array_store_t store,
+        alpha_stored_array* array)
+{
+    ABT_mutex_lock(store->mutex);
+    drop_reference(store, array);
+    ABT_mutex_unlock(store->mutex);
+}
+
+alpha_stored_array* alpha_array_store_acquire(
+        alpha_array_store_t store,
+        uint64_t id)
+{
+    double now = ABT_get_wtime();
+    ABT_mutex_lock(store->mutex);
+    remove_expired(store, now);
+    alpha_stored_array* array = store->arrays;
+    while(array && array->id != id) array = array->next;
+    if(array) {
+        array->refcount += 1;
+        array->last_used = now;
+    }
+    ABT_mutex_unlock(store->mutex);
+    return array;
+}
+
+void alpha_array_store_release(
+        alpha_array_store_t store,
+        alpha_stored_array* array)
+{
+    if(!array) return;
+    ABT_mutex_lock(store->mutex);
+    array->last_used = ABT_get_wtime();
+    drop_reference(store, array);
+    ABT_mutex_unlock(store->mutex);
+}
+
+alpha_return_t alpha_array_store_remove(
+        alpha_array_store_t store,
+        uint64_t id)
+{
+    alpha_return_t ret = ALPHA_ERR_INVALID_ARRAY;
+    ABT_mutex_lock(store->mutex);
+    alpha_stored_array** prev = &store->arrays;
+    while(*prev && (*prev)->id != id) prev = &(*prev)->next;
+    if(*prev) {
+        alpha_stored_array* array = *prev;
+        *prev = array->next;
+        drop_reference(store, array);
+        ret = ALPHA_SUCCESS;
+    }
+    ABT_mutex_unlock(store->mutex);
+    return ret;
+}
+
+struct json_object* alpha_array_store_get_config(alpha_array_store_t store)
+{
+    struct json_object* config = json_object_new_object();
+    json_object_object_add(config, "max_bytes",
+        json_object_new_int64((int64_t)store->max_bytes));
+    json_object_object_add(config, "max_arrays",
+        json_object_new_int64((int64_t)store->max_arrays));
+    json_object_object_add(config, "idle_timeout_ms",
+        json_object_new_int64((int64_t)store->idle_timeout_ms));
+    return config;
+}
+
+struct json_object* alpha_array_store_get_stats(alpha_array_store_t store)
+{
+    struct json_object* stats = json_object_new_object();
+    ABT_mutex_lock(store->mutex);
+    json_object_object_add(stats, "num_arrays",
+        json_object_new_int64((int64_t)store->num_arrays));
+    json_object_object_add(stats, "num_bytes",
+        json_object_new_int64((int64_t)store->num_bytes));
+    json_object_object_add(stats, "expired",
+        json_object_new_int64((int64_t)store->expired));
+    json_object_object_add(stats, "rejected",
+        json_object_new_int64((int64_t)store->rejected));
+    ABT_mutex_unlock(store->mutex);
+    return stats;
+}
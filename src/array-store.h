@@ -0,0 +1,127 @@
+/*
+ * (C) 2020 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef _ARRAY_STORE_H
+#define _ARRAY_STORE_H
+
+#include <margo.h>
+#include <json-c/json.h>
+#include "alpha/alpha-common.h"
+
+/**
+ * @brief Array uploaded by a client and kept by the provider, so that
+ * it can be used as an operand of later RPCs without being sent again.
+ * The data may be read until the array is released.
+ */
+typedef struct alpha_stored_array {
+    uint64_t      id;
+    alpha_dtype_t dtype;
+    size_t        count;
+    void*         data;
+    /* fields below are private to the store */
+    size_t                     size;
+    uint64_t                   refcount;
+    double                     last_used;
+    struct alpha_stored_array* next;
+} alpha_stored_array;
+
+/**
+ * @brief Arrays stored by a provider. Arrays are reference-counted, so
+ * that an array removed (or expired) while an RPC uses it is only freed
+ * when the RPC releases it.
+ */
+typedef struct alpha_array_store* alpha_array_store_t;
+
+/**
+ * @brief Creates an array store from its JSON configuration, e.g.
+ * { "max_bytes": 268435456, "max_arrays": 1024, "idle_timeout_ms": 0 }.
+ * Storing an array that would exceed max_bytes or max_arrays fails with
+ * ALPHA_ERR_ALLOCATION (a max_bytes of 0 disables stored arrays). Arrays
+ * that no RPC has used for idle_timeout_ms are removed, unless it is 0
+ * (the default), in which case arrays are only removed explicitly.
+ *
+ * @param[in] mid Margo instance
+ * @param[in] config JSON configuration (may be NULL)
+ * @param[out] store created array store
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_array_store_create(
+        margo_instance_id mid,
+        struct json_object* config,
+        alpha_array_store_t* store);
+
+/**
+ * @brief Destroys the array store and the arrays it contains, none of
+ * which should be in use. Passing NULL is valid and does nothing.
+ */
+void alpha_array_store_destroy(alpha_array_store_t store);
+
+/**
+ * @brief Allocates an array of count elements of the given type, counted
+ * against the store's limits but not visible until it is published, so
+ * that the caller can fill it first.
+ *
+ * @return ALPHA_SUCCESS, or ALPHA_ERR_ALLOCATION if the array doesn't fit
+ */
+alpha_return_t alpha_array_store_reserve(
+        alpha_array_store_t store,
+        alpha_dtype_t dtype,
+        size_t count,
+        alpha_stored_array** array);
+
+/**
+ * @brief Makes a reserved array visible under a new id, which is returned.
+ */
+uint64_t alpha_array_store_publish(
+        alpha_array_store_t store,
+        alpha_stored_array* array);
+
+/**
+ * @brief Frees a reserved array that has not been published.
+ */
+void alpha_array_store_discard(
+        alpha_array_store_t store,
+        alpha_stored_array* array);
+
+/**
+ * @brief Finds the array with the given id and takes a reference to it.
+ *
+ * @return the array, or NULL if there is no such array
+ */
+alpha_stored_array* alpha_array_store_acquire(
+        alpha_array_store_t store,
+        uint64_t id);
+
+/**
+ * @brief Releases an array obtained with alpha_array_store_acquire.
+ * Passing NULL is valid and does nothing.
+ */
+void alpha_array_store_release(
+        alpha_array_store_t store,
+        alpha_stored_array* array);
+
+/**
+ * @brief Removes the array with the given id from the store.
+ *
+ * @return ALPHA_SUCCESS, or ALPHA_ERR_INVALID_ARRAY if there is no such array
+ */
+alpha_return_t alpha_array_store_remove(
+        alpha_array_store_t store,
+        uint64_t id);
+
+/**
+ * @brief Returns the configuration of the array store as a JSON object.
+ */
+struct json_object* alpha_array_store_get_config(alpha_array_store_t store);
+
+/**
+ * @brief Returns the state of the array store (number of arrays and bytes
+ * stored, number of arrays that expired, and number of arrays rejected
+ * because the store was full) as a JSON object.
+ */
+struct json_object* alpha_array_store_get_stats(alpha_array_store_t store);
+
+#endif
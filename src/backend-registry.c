@@ -0,0 +1,107 @@
+/*
+ * (C) 2020 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <dlfcn.h>
+#include "backend-registry.h"
+
+/* Open-addressing hash table (linear probing) of backend implementations.
+ * Backends may be registered before Argobots is initialized, hence the
+ * use of a pthread lock rather than an ABT_rwlock. */
+static pthread_rwlock_t     g_registry_lock     = PTHREAD_RWLOCK_INITIALIZER;
+static alpha_backend_impl** g_registry_slots    = NULL;
+static size_t               g_registry_capacity = 0; // power of 2
+static size_t               g_registry_size     = 0;
+
+static uint64_t hash_string(const char* str)
+{
+    /* FNV-1a */
+    uint64_t h = 14695981039346656037ULL;
+    for(; *str; ++str) {
+        h ^= (unsigned char)*str;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+/* Returns the slot holding the backend with the given name, or the empty
+ * slot where it would be inserted. Must be called with the lock held and
+ * a non-zero capacity. */
+static size_t find_slot(alpha_backend_impl** slots, size_t capacity, const char* name)
+{
+    size_t i = hash_string(name) & (capacity - 1);
+    while(slots[i] && strcmp(slots[i]->name, name) != 0)
+        i = (i + 1) & (capacity - 1);
+    return i;
+}
+
+/* Doubles the capacity of the table. Must be called with the write lock held. */
+static alpha_return_t grow_table(void)
+{
+    size_t new_capacity = g_registry_capacity ? 2*g_registry_capacity : 16;
+    alpha_backend_impl** new_slots = (alpha_backend_impl**)calloc(
+        new_capacity, sizeof(*new_slots));
+    if(!new_slots) return ALPHA_ERR_ALLOCATION;
+    for(size_t i = 0; i < g_registry_capacity; ++i) {
+        alpha_backend_impl* impl = g_registry_slots[i];
+        if(impl) new_slots[find_slot(new_slots, new_capacity, impl->name)] = impl;
+    }
+    free(g_registry_slots);
+    g_registry_slots    = new_slots;
+    g_registry_capacity = new_capacity;
+    return ALPHA_SUCCESS;
+}
+
+alpha_backend_impl* alpha_backend_registry_find(const char* name)
+{
+    alpha_backend_impl* impl = NULL;
+    pthread_rwlock_rdlock(&g_registry_lock);
+    if(g_registry_capacity)
+        impl = g_registry_slots[find_slot(g_registry_slots, g_registry_capacity, name)];
+    pthread_rwlock_unlock(&g_registry_lock);
+    return impl;
+}
+
+alpha_return_t alpha_backend_registry_add(alpha_backend_impl* backend)
+{
+    if(!backend || !backend->name)
+        return ALPHA_ERR_INVALID_ARGS;
+    alpha_return_t ret = ALPHA_SUCCESS;
+    pthread_rwlock_wrlock(&g_registry_lock);
+    /* keep the load factor below 1/2 */
+    if(2*(g_registry_size + 1) > g_registry_capacity) {
+        ret = grow_table();
+        if(ret != ALPHA_SUCCESS) goto finish;
+    }
+    size_t i = find_slot(g_registry_slots, g_registry_capacity, backend->name);
+    if(!g_registry_slots[i]) {
+        g_registry_slots[i] = backend;
+        g_registry_size += 1;
+    }
+finish:
+    pthread_rwlock_unlock(&g_registry_lock);
+    return ret;
+}
+
+alpha_return_t alpha_backend_registry_load_library(
+        margo_instance_id mid,
+        const char* path)
+{
+    void* lib = dlopen(path, RTLD_NOW | RTLD_GLOBAL);
+    if(!lib) {
+        margo_error(mid, "Could not load backend library \"%s\": %s", path, dlerror());
+        return ALPHA_ERR_INVALID_BACKEND;
+    }
+    alpha_register_backends_fn register_backends = NULL;
+    /* POSIX-sanctioned way of converting the result of dlsym */
+    *(void**)(&register_backends) = dlsym(lib, "alpha_register_backends");
+    if(!register_backends) return ALPHA_SUCCESS;
+    alpha_return_t ret = register_backends();
+    if(ret != ALPHA_SUCCESS)
+        margo_error(mid, "alpha_register_backends in \"%s\" returned %d", path, ret);
+    return ret;
+}
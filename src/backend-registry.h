@@ -0,0 +1,49 @@
+/*
+ * (C) 2020 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef _BACKEND_REGISTRY_H
+#define _BACKEND_REGISTRY_H
+
+#include <margo.h>
+#include "alpha/alpha-backend.h"
+
+/**
+ * @brief Process-wide registry of backend implementations, indexed by name.
+ * Lookups may run concurrently with each other; registrations take an
+ * exclusive lock. Backends are never removed from the registry.
+ */
+
+/**
+ * @brief Finds the backend implementation with the given name.
+ *
+ * @return the backend implementation, or NULL if none is registered.
+ */
+alpha_backend_impl* alpha_backend_registry_find(const char* name);
+
+/**
+ * @brief Adds a backend implementation to the registry.
+ * Adding a backend with the name of a registered backend
+ * leaves the registered backend in place.
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_backend_registry_add(alpha_backend_impl* backend);
+
+/**
+ * @brief Loads a shared library providing backend implementations.
+ * The library registers its backends either when it is loaded (e.g. from
+ * a constructor function), or by defining an alpha_register_backends
+ * function, which is called after loading. Libraries are never unloaded.
+ *
+ * @param[in] mid Margo instance (used for logging)
+ * @param[in] path name or path of the library, as accepted by dlopen
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_backend_registry_load_library(
+        margo_instance_id mid,
+        const char* path);
+
+#endif
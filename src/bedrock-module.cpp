@@ -17,11 +17,13 @@ class AlphaComponent : public bedrock::AbstractComponent {
     AlphaComponent(const tl::engine& engine,
                    uint16_t  provider_id,
                    const std::string& config,
-                   const tl::pool& pool)
+                   const tl::pool& pool,
+                   const tl::pool& compute_pool)
     {
         margo_instance_id mid = engine.get_margo_instance();
-        struct alpha_provider_args alpha_args = { 0, nullptr };
+        struct alpha_provider_args alpha_args = ALPHA_PROVIDER_ARGS_INIT;
         alpha_args.pool = pool.native_handle();
+        alpha_args.compute_pool = compute_pool.native_handle();
 
         alpha_provider_t provider = nullptr;
         alpha_return_t ret = alpha_provider_register(
@@ -53,8 +55,13 @@ class AlphaComponent : public bedrock::AbstractComponent {
             if(it != args.dependencies.end() && !it->second.empty()) {
                 pool = it->second[0]->getHandle<tl::pool>();
             }
+            tl::pool compute_pool;
+            it = args.dependencies.find("compute_pool");
+            if(it != args.dependencies.end() && !it->second.empty()) {
+                compute_pool = it->second[0]->getHandle<tl::pool>();
+            }
             return std::make_shared<AlphaComponent>(
-                args.engine, args.provider_id, args.config, pool);
+                args.engine, args.provider_id, args.config, pool, compute_pool);
         }
 
     static std::vector<bedrock::Dependency>
@@ -67,6 +74,13 @@ class AlphaComponent : public bedrock::AbstractComponent {
                     /* is_required */ false,
                     /* is_array */ false,
                     /* is_updatable */ false
+                },
+                bedrock::Dependency{
+                    /* name */ "compute_pool",
+                    /* type */ "pool",
+                    /* is_required */ false,
+                    /* is_array */ false,
+                    /* is_updatable */ false
                 }
             };
             return dependencies;
@@ -0,0 +1,247 @@
+/*
+ * (C) 2020 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#include <stdlib.h>
+#include "buffer-pool.h"
+
+#define ALPHA_BUFFER_POOL_DEFAULT_MAX_BYTES (64*1024*1024)
+
+static const hg_size_t default_classes[] = {
+    64*1024, 1024*1024, 16*1024*1024
+};
+
+typedef struct alpha_buffer_class {
+    hg_size_t     size;      // size of the buffers in this class
+    alpha_buffer* free_list; // buffers available for reuse
+} alpha_buffer_class;
+
+struct alpha_buffer_pool {
+    margo_instance_id   mid;
+    ABT_mutex           mutex;
+    hg_size_t           max_bytes;       // max memory owned by the pool
+    hg_size_t           allocated_bytes; // memory currently owned by the pool
+    size_t              num_classes;
+    alpha_buffer_class* classes;         // sorted by increasing size
+    uint64_t            hits;
+    uint64_t            misses;
+};
+
+static alpha_buffer* alpha_buffer_create(
+        margo_instance_id mid, hg_size_t size, int class_index)
+{
+    alpha_buffer* buffer = (alpha_buffer*)calloc(1, sizeof(*buffer));
+    if(!buffer) return NULL;
+    buffer->data = malloc(size);
+    if(!buffer->data) {
+        free(buffer);
+        return NULL;
+    }
+    buffer->size        = size;
+    buffer->class_index = class_index;
+    hg_return_t hret = margo_bulk_create(
+        mid, 1, &buffer->data, &buffer->size, HG_BULK_READWRITE, &buffer->bulk);
+    if(hret != HG_SUCCESS) {
+        margo_error(mid, "Could not register buffer of size %lu (mercury error %d)",
+                    (unsigned long)size, hret);
+        free(buffer->data);
+        free(buffer);
+        return NULL;
+    }
+    return buffer;
+}
+
+static void alpha_buffer_free(alpha_buffer* buffer)
+{
+    margo_bulk_free(buffer->bulk);
+    free(buffer->data);
+    free(buffer);
+}
+
+static int compare_sizes(const void* a, const void* b)
+{
+    hg_size_t x = ((const alpha_buffer_class*)a)->size;
+    hg_size_t y = ((const alpha_buffer_class*)b)->size;
+    return (x > y) - (x < y);
+}
+
+alpha_return_t alpha_buffer_pool_create(
+        margo_instance_id mid,
+        struct json_object* config,
+        alpha_buffer_pool_t* pool)
+{
+    struct json_object* max_bytes = NULL;
+    struct json_object* classes   = NULL;
+
+    if(config) {
+        if(!json_object_is_type(config, json_type_object)) {
+            margo_error(mid, "\"buffer_pool\" field should be an object in provider configuration");
+            return ALPHA_ERR_INVALID_CONFIG;
+        }
+        max_bytes = json_object_object_get(config, "max_bytes");
+        if(max_bytes && !(json_object_is_type(max_bytes, json_type_int)
+                          && json_object_get_int64(max_bytes) >= 0)) {
+            margo_error(mid, "\"max_bytes\" field in buffer pool configuration should be a positive integer");
+            return ALPHA_ERR_INVALID_CONFIG;
+        }
+        classes = json_object_object_get(config, "classes");
+        if(classes && !json_object_is_type(classes, json_type_array)) {
+            margo_error(mid, "\"classes\" field in buffer pool configuration should be an array");
+            return ALPHA_ERR_INVALID_CONFIG;
+        }
+    }
+
+    size_t num_classes = classes ? json_object_array_length(classes)
+                                 : sizeof(default_classes)/sizeof(default_classes[0]);
+
+    alpha_buffer_pool_t p = (alpha_buffer_pool_t)calloc(1, sizeof(*p));
+    if(!p) return ALPHA_ERR_ALLOCATION;
+    p->classes = (alpha_buffer_class*)calloc(num_classes ? num_classes : 1, sizeof(*p->classes));
+    if(!p->classes) {
+        free(p);
+        return ALPHA_ERR_ALLOCATION;
+    }
+    p->mid         = mid;
+    p->num_classes = num_classes;
+    p->max_bytes   = max_bytes ? (hg_size_t)json_object_get_int64(max_bytes)
+                               : ALPHA_BUFFER_POOL_DEFAULT_MAX_BYTES;
+
+    for(size_t i = 0; i < num_classes; ++i) {
+        if(!classes) {
+            p->classes[i].size = default_classes[i];
+            continue;
+        }
+        struct json_object* c = json_object_array_get_idx(classes, i);
+        if(!json_object_is_type(c, json_type_int) || json_object_get_int64(c) <= 0) {
+            margo_error(mid, "Buffer pool classes should be strictly positive integers");
+            free(p->classes);
+            free(p);
+            return ALPHA_ERR_INVALID_CONFIG;
+        }
+        p->classes[i].size = (hg_size_t)json_object_get_int64(c);
+    }
+    qsort(p->classes, num_classes, sizeof(*p->classes), compare_sizes);
+
+    ABT_mutex_create(&p->mutex);
+
+    *pool = p;
+    return ALPHA_SUCCESS;
+}
+
+void alpha_buffer_pool_destroy(alpha_buffer_pool_t pool)
+{
+    if(!pool) return;
+    for(size_t i = 0; i < pool->num_classes; ++i) {
+        alpha_buffer* buffer = pool->classes[i].free_list;
+        while(buffer) {
+            alpha_buffer* next = buffer->next;
+            pool->allocated_bytes -= buffer->size;
+            alpha_buffer_free(buffer);
+            buffer = next;
+        }
+    }
+    if(pool->allocated_bytes != 0)
+        margo_warning(pool->mid,
+            "Buffer pool destroyed while %lu bytes are still in use",
+            (unsigned long)pool->allocated_bytes);
+    ABT_mutex_free(&pool->mutex);
+    free(pool->classes);
+    free(pool);
+}
+
+alpha_return_t alpha_buffer_pool_get(
+        alpha_buffer_pool_t pool,
+        hg_size_t size,
+        alpha_buffer** buffer)
+{
+    alpha_buffer* b = NULL;
+    int class_index = -1;
+
+    /* find the smallest class that fits the requested size */
+    for(size_t i = 0; i < pool->num_classes; ++i) {
+        if(pool->classes[i].size >= size) {
+            class_index = (int)i;
+            break;
+        }
+    }
+
+    ABT_mutex_lock(pool->mutex);
+    if(class_index >= 0) {
+        alpha_buffer_class* c = &pool->classes[class_index];
+        if(c->free_list) {
+            b = c->free_list;
+            c->free_list = b->next;
+            b->next = NULL;
+            pool->hits += 1;
+            ABT_mutex_unlock(pool->mutex);
+            *buffer = b;
+            return ALPHA_SUCCESS;
+        }
+        if(pool->allocated_bytes + c->size <= pool->max_bytes) {
+            pool->allocated_bytes += c->size;
+            size = c->size;
+        } else {
+            class_index = -1;
+        }
+    }
+    pool->misses += 1;
+    ABT_mutex_unlock(pool->mutex);
+
+    /* the buffer is created outside of the critical section
+     * since memory registration may be expensive */
+    b = alpha_buffer_create(pool->mid, size, class_index);
+    if(!b) {
+        if(class_index >= 0) {
+            ABT_mutex_lock(pool->mutex);
+            pool->allocated_bytes -= size;
+            ABT_mutex_unlock(pool->mutex);
+        }
+        return ALPHA_ERR_ALLOCATION;
+    }
+    *buffer = b;
+    return ALPHA_SUCCESS;
+}
+
+void alpha_buffer_pool_release(
+        alpha_buffer_pool_t pool,
+        alpha_buffer* buffer)
+{
+    if(!buffer) return;
+    if(buffer->class_index < 0) {
+        alpha_buffer_free(buffer);
+        return;
+    }
+    ABT_mutex_lock(pool->mutex);
+    alpha_buffer_class* c = &pool->classes[buffer->class_index];
+    buffer->next = c->free_list;
+    c->free_list = buffer;
+    ABT_mutex_unlock(pool->mutex);
+}
+
+struct json_object* alpha_buffer_pool_get_config(alpha_buffer_pool_t pool)
+{
+    struct json_object* config = json_object_new_object();
+    json_object_object_add(config, "max_bytes",
+        json_object_new_int64((int64_t)pool->max_bytes));
+    struct json_object* classes = json_object_new_array();
+    for(size_t i = 0; i < pool->num_classes; ++i)
+        json_object_array_add(classes,
+            json_object_new_int64((int64_t)pool->classes[i].size));
+    json_object_object_add(config, "classes", classes);
+    return config;
+}
+
+struct json_object* alpha_buffer_pool_get_stats(alpha_buffer_pool_t pool)
+{
+    struct json_object* stats = json_object_new_object();
+    ABT_mutex_lock(pool->mutex);
+    json_object_object_add(stats, "hits",
+        json_object_new_int64((int64_t)pool->hits));
+    json_object_object_add(stats, "misses",
+        json_object_new_int64((int64_t)pool->misses));
+    json_object_object_add(stats, "allocated_bytes",
+        json_object_new_int64((int64_t)pool->allocated_bytes));
+    ABT_mutex_unlock(pool->mutex);
+    return stats;
+}
@@ -0,0 +1,86 @@
+/*
+ * (C) 2020 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef _BUFFER_POOL_H
+#define _BUFFER_POOL_H
+
+#include <margo.h>
+#include <json-c/json.h>
+#include "alpha/alpha-common.h"
+
+/**
+ * @brief Buffer registered with Mercury for bulk transfers.
+ * The whole buffer is exposed by bulk, with HG_BULK_READWRITE access.
+ */
+typedef struct alpha_buffer {
+    void*                data;        // registered memory
+    hg_size_t            size;        // capacity of the buffer
+    hg_bulk_t            bulk;        // bulk handle exposing data
+    int                  class_index; // size class, or -1 if not pooled
+    struct alpha_buffer* next;        // next free buffer in the same class
+} alpha_buffer;
+
+/**
+ * @brief Pool of registered buffers, organized in size classes.
+ * Buffers are registered the first time they are needed and kept
+ * registered after being released, as long as the total amount of
+ * memory owned by the pool does not exceed max_bytes. Requests that
+ * cannot be satisfied by the pool fall back to a one-off allocation.
+ */
+typedef struct alpha_buffer_pool* alpha_buffer_pool_t;
+
+/**
+ * @brief Creates a buffer pool from its JSON configuration, e.g.
+ * { "max_bytes": 67108864, "classes": [65536, 1048576, 16777216] }.
+ * Missing fields are set to default values.
+ *
+ * @param[in] mid Margo instance
+ * @param[in] config JSON configuration (may be NULL)
+ * @param[out] pool created pool
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_buffer_pool_create(
+        margo_instance_id mid,
+        struct json_object* config,
+        alpha_buffer_pool_t* pool);
+
+/**
+ * @brief Destroys the pool. All the buffers must have been released.
+ */
+void alpha_buffer_pool_destroy(alpha_buffer_pool_t pool);
+
+/**
+ * @brief Borrows a buffer of at least the requested size from the pool.
+ *
+ * @param[in] pool buffer pool
+ * @param[in] size requested size (must be > 0)
+ * @param[out] buffer borrowed buffer
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_buffer_pool_get(
+        alpha_buffer_pool_t pool,
+        hg_size_t size,
+        alpha_buffer** buffer);
+
+/**
+ * @brief Returns a buffer obtained by alpha_buffer_pool_get to the pool.
+ */
+void alpha_buffer_pool_release(
+        alpha_buffer_pool_t pool,
+        alpha_buffer* buffer);
+
+/**
+ * @brief Returns the configuration of the pool as a JSON object.
+ */
+struct json_object* alpha_buffer_pool_get_config(alpha_buffer_pool_t pool);
+
+/**
+ * @brief Returns the hit/miss counters of the pool as a JSON object.
+ */
+struct json_object* alpha_buffer_pool_get_stats(alpha_buffer_pool_t pool);
+
+#endif
@@ -3,8 +3,12 @@
  *
  * See COPYRIGHT in top-level directory.
  */
+#include <time.h>
+#include <stdio.h>
+#include <unistd.h>
 #include "types.h"
 #include "client.h"
+#include "shm.h"
 #include "alpha/alpha-client.h"
 
 // TUTORIAL
@@ -14,25 +18,115 @@
 // Several example RPCs are provided which pass their data as RPC arguments
 // or using RDMA.
 //
-// Note that contrary the the Thallium microservice template, which provides
-// a non-blocking API (with functions returning Future objects that must be waited
-// on), this template provide blocking functions. Non-blocking functions can crafted
-// using Margo functions such as margo_provider_iforward (instead of margo_provider_forward),
-// margo_provider_iforward_timed (instead of margo_provider_forward_timed), and so on.
-// These functions would return a margo_request object that the caller needs to wait
-// on using margo_wait. Making a non-blocking API in C is arguably more complex since
-// the margo_request needs to be awaited before functions such as margo_get_output,
-// margo_free_output, and margo_destroy can be called to complete the RPC flow.
-// One way to make a non-blocking API would be to encapsulate a margo_request along
-// with other data (such as the hg_handle_t of the on-going RPC) in an opaque alpha_request_t
-// object, and provide an alpha_request_wait function to complete the operation and cleanup.
+// Each RPC comes in a blocking version (e.g. alpha_compute_sum) and a
+// non-blocking version (e.g. alpha_compute_sum_async). Non-blocking functions
+// use margo_provider_iforward and return an alpha_request_t that encapsulates
+// the resulting margo_request along with the hg_handle_t of the on-going RPC
+// and any resource to release once the RPC has completed (e.g. temporary bulk
+// handles). alpha_request_wait completes the operation (margo_wait,
+// margo_get_output, margo_free_output) and cleans up. Blocking
+// functions are implemented by starting the operation in a stack-allocated
+// request and completing it immediately.
+//
+// Rather than calling margo_create and margo_destroy for each RPC, resource
+// handles keep the hg_handle_t of completed RPCs in a small cache, from which
+// subsequent RPCs to the same provider take their handle.
+//
+// When the provider lives in the client's margo instance, alpha_compute_sum_multi
+// bypasses Mercury and calls the provider through the alpha_local_ops it
+// registers (see local.h), on the caller's arrays.
+//
+// When the client's shm_size is set, each resource handle creates a
+// shared-memory segment that a provider on the same node attaches (see
+// shm.h). alpha_compute_sum_multi then places its arrays in the segment,
+// copying those that are not already there, and only sends their offsets.
+//
+// A provider may reject an RPC with ALPHA_ERR_BUSY when it is overloaded.
+// Such RPCs are resent when their request is completed, after a delay based
+// on the one the provider suggests, up to the client's max_retries times.
+
+/* Returns a pseudo-random number: splitmix64 over a shared counter,
+ * so that concurrent callers draw different values without a lock */
+static uint64_t alpha_client_random(alpha_client_t client)
+{
+    uint64_t z = __atomic_add_fetch(&client->retry_seed,
+                                    0x9E3779B97F4A7C15ULL, __ATOMIC_RELAXED);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/* Size reserved in eager buffers for headers added by Margo */
+#define ALPHA_EAGER_HEADER_MARGIN 64
+
+/* Computes the max number of elements for which the input and the output
+ * of an alpha_sum_batch RPC fit in Mercury's eager buffers */
+static size_t alpha_default_eager_threshold(margo_instance_id mid)
+{
+    hg_class_t* hg_class = margo_get_class(mid);
+    hg_size_t in_size  = HG_Class_get_input_eager_size(hg_class);
+    hg_size_t out_size = HG_Class_get_output_eager_size(hg_class);
+    /* input: resource_id + count + x + y,
+     * output: ret + retry_after_ms + count + result */
+    hg_size_t in_header  = ALPHA_EAGER_HEADER_MARGIN + sizeof(uint32_t) + sizeof(uint64_t);
+    hg_size_t out_header = ALPHA_EAGER_HEADER_MARGIN + sizeof(int32_t) + sizeof(uint32_t)
+                         + sizeof(uint64_t);
+    if(in_size <= in_header || out_size <= out_header) return 0;
+    size_t in_count  = (in_size - in_header)/(2*sizeof(int32_t));
+    size_t out_count = (out_size - out_header)/sizeof(int32_t);
+    return in_count < out_count ? in_count : out_count;
+}
 
 alpha_return_t alpha_client_init(margo_instance_id mid, alpha_client_t* client)
 {
+    return alpha_client_init_ext(mid, NULL, client);
+}
+
+alpha_return_t alpha_client_init_ext(
+        margo_instance_id mid,
+        const struct alpha_client_args* args,
+        alpha_client_t* client)
+{
+    struct alpha_client_args a = ALPHA_CLIENT_ARGS_INIT;
+    if(args) a = *args;
+
     alpha_client_t c = (alpha_client_t)calloc(1, sizeof(*c));
     if(!c) return ALPHA_ERR_ALLOCATION;
 
     c->mid = mid;
+    c->eager_threshold = a.eager_threshold == ALPHA_EAGER_THRESHOLD_AUTO ?
+                         alpha_default_eager_threshold(mid) : a.eager_threshold;
+    if(c->eager_threshold > ALPHA_MAX_INLINE_COUNT)
+        c->eager_threshold = ALPHA_MAX_INLINE_COUNT;
+    margo_debug(mid, "ALPHA client sending sum_multi arrays inline up to %lu elements",
+                (unsigned long)c->eager_threshold);
+    c->handle_cache_size = a.handle_cache_size;
+    c->max_retries = a.max_retries;
+    c->retry_seed = (uint64_t)(uintptr_t)c ^ (uint64_t)time(NULL);
+    c->local_shortcut = a.local_shortcut;
+    c->shm_size = a.shm_size;
+
+    /* get the string representation of the client's address once,
+     * since it will be sent along with any bulk handle it exposes */
+    hg_addr_t self_addr = HG_ADDR_NULL;
+    char address[256];
+    hg_size_t address_size = 256;
+    hg_return_t hret = margo_addr_self(mid, &self_addr);
+    if(hret == HG_SUCCESS) {
+        hret = margo_addr_to_string(mid, address, &address_size, self_addr);
+        margo_addr_free(mid, self_addr);
+    }
+    if(hret != HG_SUCCESS) {
+        free(c);
+        return ALPHA_ERR_FROM_MERCURY;
+    }
+    c->self_addr_str = strdup(address);
+    if(!c->self_addr_str) {
+        free(c);
+        return ALPHA_ERR_ALLOCATION;
+    }
+
+    ABT_mutex_create(&c->registered_buffers_mtx);
 
     hg_bool_t flag;
     hg_id_t id;
@@ -41,9 +135,37 @@ alpha_return_t alpha_client_init(margo_instance_id mid, alpha_client_t* client)
     if(flag == HG_TRUE) {
         margo_registered_name(mid, "alpha_sum", &c->sum_id, &flag);
         margo_registered_name(mid, "alpha_sum_multi", &c->sum_multi_id, &flag);
+        margo_registered_name(mid, "alpha_accumulate", &c->accumulate_id, &flag);
+        margo_registered_name(mid, "alpha_reduce", &c->reduce_id, &flag);
+        margo_registered_name(mid, "alpha_sum_strided", &c->sum_strided_id, &flag);
+        margo_registered_name(mid, "alpha_sum_stored", &c->sum_stored_id, &flag);
+        margo_registered_name(mid, "alpha_array_store", &c->array_store_id, &flag);
+        margo_registered_name(mid, "alpha_array_remove", &c->array_remove_id, &flag);
+        margo_registered_name(mid, "alpha_named_create", &c->named_create_id, &flag);
+        margo_registered_name(mid, "alpha_named_io", &c->named_io_id, &flag);
+        margo_registered_name(mid, "alpha_sum_named", &c->sum_named_id, &flag);
+        margo_registered_name(mid, "alpha_sum_batch", &c->sum_batch_id, &flag);
+        margo_registered_name(mid, "alpha_stats", &c->stats_id, &flag);
+        margo_registered_name(mid, "alpha_shm_attach", &c->shm_attach_id, &flag);
+        margo_registered_name(mid, "alpha_shm_detach", &c->shm_detach_id, &flag);
+        margo_registered_name(mid, "alpha_sum_shm", &c->sum_shm_id, &flag);
     } else {
         c->sum_id = MARGO_REGISTER(mid, "alpha_sum", sum_in_t, sum_out_t, NULL);
         c->sum_multi_id = MARGO_REGISTER(mid, "alpha_sum_multi", sum_multi_in_t, sum_multi_out_t, NULL);
+        c->accumulate_id = MARGO_REGISTER(mid, "alpha_accumulate", accumulate_in_t, sum_multi_out_t, NULL);
+        c->reduce_id = MARGO_REGISTER(mid, "alpha_reduce", reduce_in_t, reduce_out_t, NULL);
+        c->sum_strided_id = MARGO_REGISTER(mid, "alpha_sum_strided", sum_strided_in_t, sum_multi_out_t, NULL);
+        c->sum_stored_id = MARGO_REGISTER(mid, "alpha_sum_stored", sum_stored_in_t, sum_multi_out_t, NULL);
+        c->array_store_id = MARGO_REGISTER(mid, "alpha_array_store", array_store_in_t, array_store_out_t, NULL);
+        c->array_remove_id = MARGO_REGISTER(mid, "alpha_array_remove", array_remove_in_t, array_remove_out_t, NULL);
+        c->named_create_id = MARGO_REGISTER(mid, "alpha_named_create", named_create_in_t, named_array_out_t, NULL);
+        c->named_io_id = MARGO_REGISTER(mid, "alpha_named_io", named_io_in_t, named_array_out_t, NULL);
+        c->sum_named_id = MARGO_REGISTER(mid, "alpha_sum_named", sum_named_in_t, sum_multi_out_t, NULL);
+        c->sum_batch_id = MARGO_REGISTER(mid, "alpha_sum_batch", sum_batch_in_t, sum_batch_out_t, NULL);
+        c->stats_id = MARGO_REGISTER(mid, "alpha_stats", void, stats_out_t, NULL);
+        c->shm_attach_id = MARGO_REGISTER(mid, "alpha_shm_attach", shm_attach_in_t, shm_attach_out_t, NULL);
+        c->shm_detach_id = MARGO_REGISTER(mid, "alpha_shm_detach", shm_detach_in_t, shm_detach_out_t, NULL);
+        c->sum_shm_id = MARGO_REGISTER(mid, "alpha_sum_shm", sum_shm_in_t, sum_multi_out_t, NULL);
     }
 
     *client = c;
@@ -57,16 +179,334 @@ alpha_return_t alpha_client_finalize(alpha_client_t client)
             "%ld resource handles not released when alpha_client_finalize was called",
             client->num_resource_handles);
     }
+    if(client->num_registered_buffers != 0) {
+        margo_warning(client->mid,
+            "%lu buffers not unregistered when alpha_client_finalize was called",
+            client->num_registered_buffers);
+    }
+    for(size_t i = 0; i < client->num_registered_buffers; ++i)
+        margo_bulk_free(client->registered_buffers[i].bulk);
+    free(client->registered_buffers);
+    ABT_mutex_free(&client->registered_buffers_mtx);
+    free(client->self_addr_str);
     free(client);
     return ALPHA_SUCCESS;
 }
 
+/* Returns the index of the first registered buffer starting after ptr.
+ * Must be called with the registered_buffers_mtx locked. */
+static size_t find_registered_buffer_index(alpha_client_t client, const char* ptr)
+{
+    size_t lo = 0, hi = client->num_registered_buffers;
+    while(lo < hi) {
+        size_t mid = lo + (hi - lo)/2;
+        if(client->registered_buffers[mid].base <= ptr) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/* Finds the registered buffer containing [ptr, ptr+size), if any,
+ * and sets the corresponding bulk handle and offset. */
+static bool find_registered_buffer(
+        alpha_client_t client, const void* ptr, size_t size,
+        hg_bulk_t* bulk, int64_t* offset)
+{
+    bool found = false;
+    ABT_mutex_lock(client->registered_buffers_mtx);
+    size_t i = find_registered_buffer_index(client, (const char*)ptr);
+    if(i > 0) {
+        alpha_registered_buffer* b = &client->registered_buffers[i-1];
+        size_t o = (size_t)((const char*)ptr - b->base);
+        if(o <= b->size && size <= b->size - o) {
+            *bulk   = b->bulk;
+            *offset = (int64_t)o;
+            found   = true;
+        }
+    }
+    ABT_mutex_unlock(client->registered_buffers_mtx);
+    return found;
+}
+
+alpha_return_t alpha_client_register_buffer(
+        alpha_client_t client,
+        void* ptr,
+        size_t size)
+{
+    if(client == ALPHA_CLIENT_NULL || !ptr || size == 0)
+        return ALPHA_ERR_INVALID_ARGS;
+
+    hg_bulk_t bulk = HG_BULK_NULL;
+    hg_size_t bulk_size = size;
+    hg_return_t hret = margo_bulk_create(client->mid, 1, &ptr, &bulk_size,
+                                         HG_BULK_READWRITE, &bulk);
+    if(hret != HG_SUCCESS)
+        return ALPHA_ERR_FROM_MERCURY;
+
+    alpha_return_t ret = ALPHA_SUCCESS;
+    char* base = (char*)ptr;
+    ABT_mutex_lock(client->registered_buffers_mtx);
+    size_t i = find_registered_buffer_index(client, base);
+    /* check that the new buffer does not overlap with its neighbors */
+    if((i > 0 && client->registered_buffers[i-1].base
+                 + client->registered_buffers[i-1].size > base)
+    || (i < client->num_registered_buffers
+        && base + size > client->registered_buffers[i].base)) {
+        ret = ALPHA_ERR_INVALID_ARGS;
+        goto finish;
+    }
+    if(client->num_registered_buffers == client->registered_buffers_capacity) {
+        size_t new_capacity = client->registered_buffers_capacity ?
+                              2*client->registered_buffers_capacity : 8;
+        alpha_registered_buffer* new_buffers = (alpha_registered_buffer*)realloc(
+            client->registered_buffers, new_capacity*sizeof(*new_buffers));
+        if(!new_buffers) {
+            ret = ALPHA_ERR_ALLOCATION;
+            goto finish;
+        }
+        client->registered_buffers          = new_buffers;
+        client->registered_buffers_capacity = new_capacity;
+    }
+    memmove(&client->registered_buffers[i+1], &client->registered_buffers[i],
+            (client->num_registered_buffers - i)*sizeof(alpha_registered_buffer));
+    client->registered_buffers[i].base = base;
+    client->registered_buffers[i].size = size;
+    client->registered_buffers[i].bulk = bulk;
+    client->num_registered_buffers += 1;
+
+finish:
+    ABT_mutex_unlock(client->registered_buffers_mtx);
+    if(ret != ALPHA_SUCCESS) margo_bulk_free(bulk);
+    return ret;
+}
+
+alpha_return_t alpha_client_unregister_buffer(
+        alpha_client_t client,
+        void* ptr)
+{
+    if(client == ALPHA_CLIENT_NULL)
+        return ALPHA_ERR_INVALID_ARGS;
+
+    hg_bulk_t bulk = HG_BULK_NULL;
+    ABT_mutex_lock(client->registered_buffers_mtx);
+    size_t i = find_registered_buffer_index(client, (const char*)ptr);
+    if(i > 0 && client->registered_buffers[i-1].base == (char*)ptr) {
+        bulk = client->registered_buffers[i-1].bulk;
+        memmove(&client->registered_buffers[i-1], &client->registered_buffers[i],
+                (client->num_registered_buffers - i)*sizeof(alpha_registered_buffer));
+        client->num_registered_buffers -= 1;
+    }
+    ABT_mutex_unlock(client->registered_buffers_mtx);
+
+    if(bulk == HG_BULK_NULL)
+        return ALPHA_ERR_INVALID_ARGS;
+    margo_bulk_free(bulk);
+    return ALPHA_SUCCESS;
+}
+
+alpha_return_t alpha_client_get_provider_stats(
+        alpha_client_t client,
+        hg_addr_t addr,
+        uint16_t provider_id,
+        char** stats)
+{
+    if(client == ALPHA_CLIENT_NULL || !stats)
+        return ALPHA_ERR_INVALID_ARGS;
+
+    hg_handle_t h;
+    stats_out_t out;
+    hg_return_t hret;
+    alpha_return_t ret;
+
+    hret = margo_create(client->mid, addr, client->stats_id, &h);
+    if(hret != HG_SUCCESS)
+        return ALPHA_ERR_FROM_MERCURY;
+
+    hret = margo_provider_forward(provider_id, h, NULL);
+    if(hret != HG_SUCCESS) {
+        ret = ALPHA_ERR_FROM_MERCURY;
+        goto finish;
+    }
+
+    hret = margo_get_output(h, &out);
+    if(hret != HG_SUCCESS) {
+        ret = ALPHA_ERR_FROM_MERCURY;
+        goto finish;
+    }
+
+    ret = out.ret;
+    if(ret == ALPHA_SUCCESS) {
+        *stats = strdup(out.stats ? out.stats : "{}");
+        if(!*stats) ret = ALPHA_ERR_ALLOCATION;
+    }
+
+    margo_free_output(h, &out);
+
+finish:
+    margo_destroy(h);
+    return ret;
+}
+
+/* Creates the resource handle's shared-memory segment and asks the provider
+ * to attach it. The handle is left without segment if any step fails, e.g.
+ * because the provider is on another node or has disabled shm. */
+static void alpha_shm_region_create(alpha_resource_handle_t rh)
+{
+    alpha_client_t client = rh->client;
+    alpha_shm_region* region = &rh->shm;
+
+    char name[64];
+    uint64_t n = __atomic_fetch_add(&client->num_shm_segments, 1, __ATOMIC_RELAXED);
+    snprintf(name, sizeof(name), "/alpha-%ld-%llu", (long)getpid(), (unsigned long long)n);
+    size_t size = ALPHA_SHM_DATA_OFFSET + client->shm_size;
+    void* base = alpha_shm_map(name, size, true);
+    if(!base) {
+        margo_warning(client->mid, "Could not create shared-memory segment %s", name);
+        return;
+    }
+    uint64_t token = alpha_client_random(client);
+    ((alpha_shm_header*)base)->token = token;
+
+    shm_attach_in_t in = {
+        .name  = name,
+        .size  = size,
+        .token = token
+    };
+    shm_attach_out_t out;
+    alpha_return_t ret = ALPHA_ERR_FROM_MERCURY;
+    hg_handle_t h;
+    if(margo_create(client->mid, rh->addr, client->shm_attach_id, &h) == HG_SUCCESS) {
+        if(margo_provider_forward(rh->provider_id, h, &in) == HG_SUCCESS
+        && margo_get_output(h, &out) == HG_SUCCESS) {
+            ret = out.ret;
+            region->segment_id = out.segment_id;
+            margo_free_output(h, &out);
+        }
+        margo_destroy(h);
+    }
+
+    /* the segment remains until both sides have unmapped it */
+    shm_unlink(name);
+    if(ret != ALPHA_SUCCESS) {
+        margo_debug(client->mid, "Provider did not attach shared-memory segment %s (error %d)",
+                    name, ret);
+        munmap(base, size);
+        return;
+    }
+    region->base = (char*)base;
+    region->size = size;
+}
+
+/* Asks the provider to detach the resource handle's segment (on a best
+ * effort basis, the provider unmaps it when finalized anyway) and unmaps it */
+static void alpha_shm_region_destroy(alpha_resource_handle_t handle)
+{
+    alpha_client_t client = handle->client;
+    alpha_shm_region* region = &handle->shm;
+    if(region->base) {
+        shm_detach_in_t in = { .segment_id = region->segment_id };
+        shm_detach_out_t out;
+        hg_handle_t h;
+        if(margo_create(client->mid, handle->addr, client->shm_detach_id, &h) == HG_SUCCESS) {
+            if(margo_provider_forward(handle->provider_id, h, &in) == HG_SUCCESS
+            && margo_get_output(h, &out) == HG_SUCCESS)
+                margo_free_output(h, &out);
+            margo_destroy(h);
+        }
+        munmap(region->base, region->size);
+    }
+    free(region->blocks);
+    ABT_mutex_free(&region->mutex);
+}
+
+/* Allocates a block of the given size in the segment (first fit),
+ * returns NULL if the segment has no room for it */
+static void* alpha_shm_region_alloc(alpha_shm_region* region, size_t size)
+{
+    if(!region->base || size == 0 || size > region->size) return NULL;
+    size = (size + ALPHA_SHM_ALIGNMENT - 1) & ~(size_t)(ALPHA_SHM_ALIGNMENT - 1);
+
+    void* ptr = NULL;
+    ABT_mutex_lock(region->mutex);
+    if(region->num_blocks == region->capacity) {
+        size_t new_capacity = region->capacity ? 2*region->capacity : 8;
+        alpha_shm_block* new_blocks = (alpha_shm_block*)realloc(
+            region->blocks, new_capacity*sizeof(*new_blocks));
+        if(!new_blocks) goto finish;
+        region->blocks   = new_blocks;
+        region->capacity = new_capacity;
+    }
+    size_t offset = ALPHA_SHM_DATA_OFFSET;
+    size_t i = 0;
+    for(; i < region->num_blocks; ++i) {
+        if(region->blocks[i].offset - offset >= size) break;
+        offset = region->blocks[i].offset + region->blocks[i].size;
+    }
+    if(i == region->num_blocks && region->size - offset < size)
+        goto finish;
+    memmove(&region->blocks[i+1], &region->blocks[i],
+            (region->num_blocks - i)*sizeof(alpha_shm_block));
+    region->blocks[i].offset = offset;
+    region->blocks[i].size   = size;
+    region->num_blocks += 1;
+    ptr = region->base + offset;
+
+finish:
+    ABT_mutex_unlock(region->mutex);
+    return ptr;
+}
+
+/* Frees a block allocated by alpha_shm_region_alloc,
+ * returns false if ptr is not the start of such a block */
+static bool alpha_shm_region_free(alpha_shm_region* region, const void* ptr)
+{
+    if(!region->base || (const char*)ptr < region->base) return false;
+    size_t offset = (size_t)((const char*)ptr - region->base);
+    bool found = false;
+    ABT_mutex_lock(region->mutex);
+    for(size_t i = 0; i < region->num_blocks; ++i) {
+        if(region->blocks[i].offset != offset) continue;
+        memmove(&region->blocks[i], &region->blocks[i+1],
+                (region->num_blocks - i - 1)*sizeof(alpha_shm_block));
+        region->num_blocks -= 1;
+        found = true;
+        break;
+    }
+    ABT_mutex_unlock(region->mutex);
+    return found;
+}
+
+/* Sets the offset of [ptr, ptr+size) if it lies within the segment */
+static bool alpha_shm_region_find(
+        const alpha_shm_region* region, const void* ptr,
+        size_t size, uint64_t* offset)
+{
+    const char* p = (const char*)ptr;
+    if(!region->base || p < region->base + ALPHA_SHM_DATA_OFFSET) return false;
+    size_t o = (size_t)(p - region->base);
+    if(!alpha_shm_range_valid(region->size, o, size)) return false;
+    *offset = o;
+    return true;
+}
+
 alpha_return_t alpha_resource_handle_create(
         alpha_client_t client,
         hg_addr_t addr,
         uint16_t provider_id,
         bool check,
         alpha_resource_handle_t* handle)
+{
+    return alpha_resource_handle_create_with_id(
+            client, addr, provider_id, 0, check, handle);
+}
+
+alpha_return_t alpha_resource_handle_create_with_id(
+        alpha_client_t client,
+        hg_addr_t addr,
+        uint16_t provider_id,
+        uint32_t resource_id,
+        bool check,
+        alpha_resource_handle_t* handle)
 {
     if(client == ALPHA_CLIENT_NULL)
         return ALPHA_ERR_INVALID_ARGS;
@@ -86,15 +526,39 @@ alpha_return_t alpha_resource_handle_create(
 
     if(!rh) return ALPHA_ERR_ALLOCATION;
 
+    if(client->handle_cache_size) {
+        rh->handle_cache.entries = (alpha_cached_handle*)calloc(
+            client->handle_cache_size, sizeof(alpha_cached_handle));
+        if(!rh->handle_cache.entries) {
+            free(rh);
+            return ALPHA_ERR_ALLOCATION;
+        }
+    }
+
     ret = margo_addr_dup(client->mid, addr, &(rh->addr));
     if(ret != HG_SUCCESS) {
+        free(rh->handle_cache.entries);
         free(rh);
         return ALPHA_ERR_FROM_MERCURY;
     }
 
     rh->client      = client;
     rh->provider_id = provider_id;
+    rh->resource_id = resource_id;
     rh->refcount    = 1;
+    if(client->local_shortcut) {
+        hg_addr_t self_addr = HG_ADDR_NULL;
+        if(margo_addr_self(client->mid, &self_addr) == HG_SUCCESS) {
+            rh->is_local = margo_addr_cmp(client->mid, addr, self_addr);
+            margo_addr_free(client->mid, self_addr);
+        }
+    }
+    ABT_mutex_create(&rh->coalescer.mutex);
+    rh->handle_cache.capacity = client->handle_cache_size;
+    ABT_mutex_create(&rh->handle_cache.mutex);
+    ABT_mutex_create(&rh->shm.mutex);
+    if(client->shm_size)
+        alpha_shm_region_create(rh);
 
     client->num_resource_handles += 1;
 
@@ -107,7 +571,9 @@ alpha_return_t alpha_resource_handle_ref_incr(
 {
     if(handle == ALPHA_RESOURCE_HANDLE_NULL)
         return ALPHA_ERR_INVALID_ARGS;
-    handle->refcount += 1;
+    /* the reference count is atomic since batches of coalesced
+     * sums hold a reference and are released by their own ULT */
+    __atomic_add_fetch(&handle->refcount, 1, __ATOMIC_RELAXED);
     return ALPHA_SUCCESS;
 }
 
@@ -115,8 +581,13 @@ alpha_return_t alpha_resource_handle_release(alpha_resource_handle_t handle)
 {
     if(handle == ALPHA_RESOURCE_HANDLE_NULL)
         return ALPHA_ERR_INVALID_ARGS;
-    handle->refcount -= 1;
-    if(handle->refcount == 0) {
+    if(__atomic_sub_fetch(&handle->refcount, 1, __ATOMIC_ACQ_REL) == 0) {
+        ABT_mutex_free(&handle->coalescer.mutex);
+        for(size_t i = 0; i < handle->handle_cache.size; ++i)
+            margo_destroy(handle->handle_cache.entries[i].h);
+        free(handle->handle_cache.entries);
+        ABT_mutex_free(&handle->handle_cache.mutex);
+        alpha_shm_region_destroy(handle);
         margo_addr_free(handle->client->mid, handle->addr);
         handle->client->num_resource_handles -= 1;
         free(handle);
@@ -124,171 +595,1045 @@ alpha_return_t alpha_resource_handle_release(alpha_resource_handle_t handle)
     return ALPHA_SUCCESS;
 }
 
-alpha_return_t alpha_compute_sum(
+alpha_return_t alpha_resource_handle_set_coalescing(
         alpha_resource_handle_t handle,
-        int32_t x,
-        int32_t y,
-        int32_t* result)
+        size_t max_batch_size,
+        double max_delay_us)
 {
-    hg_handle_t   h;
-    sum_in_t     in;
-    sum_out_t   out;
-    hg_return_t hret;
-    alpha_return_t ret;
+    if(handle == ALPHA_RESOURCE_HANDLE_NULL)
+        return ALPHA_ERR_INVALID_ARGS;
+    if(max_batch_size > 1 && max_delay_us <= 0)
+        return ALPHA_ERR_INVALID_ARGS;
+    if(max_batch_size > ALPHA_MAX_INLINE_COUNT)
+        return ALPHA_ERR_INVALID_ARGS;
+    ABT_mutex_lock(handle->coalescer.mutex);
+    handle->coalescer.max_batch_size = max_batch_size;
+    handle->coalescer.max_delay_us   = max_delay_us;
+    ABT_mutex_unlock(handle->coalescer.mutex);
+    return ALPHA_SUCCESS;
+}
 
-    in.x = x;
-    in.y = y;
+alpha_return_t alpha_resource_handle_shm_alloc(
+        alpha_resource_handle_t handle,
+        size_t size,
+        void** ptr)
+{
+    if(handle == ALPHA_RESOURCE_HANDLE_NULL || !ptr || size == 0)
+        return ALPHA_ERR_INVALID_ARGS;
+    if(!handle->shm.base)
+        return ALPHA_ERR_OP_UNSUPPORTED;
+    void* p = alpha_shm_region_alloc(&handle->shm, size);
+    if(!p) return ALPHA_ERR_ALLOCATION;
+    *ptr = p;
+    return ALPHA_SUCCESS;
+}
 
-    hret = margo_create(handle->client->mid, handle->addr, handle->client->sum_id, &h);
-    if(hret != HG_SUCCESS)
-        return ALPHA_ERR_FROM_MERCURY;
+alpha_return_t alpha_resource_handle_shm_free(
+        alpha_resource_handle_t handle,
+        void* ptr)
+{
+    if(handle == ALPHA_RESOURCE_HANDLE_NULL)
+        return ALPHA_ERR_INVALID_ARGS;
+    if(!alpha_shm_region_free(&handle->shm, ptr))
+        return ALPHA_ERR_INVALID_ARGS;
+    return ALPHA_SUCCESS;
+}
 
-    hret = margo_provider_forward(handle->provider_id, h, &in);
-    if(hret != HG_SUCCESS) {
-        ret = ALPHA_ERR_FROM_MERCURY;
-        goto finish;
-    }
+/* Takes a handle for the given RPC from the resource handle's cache,
+ * preferably one last used for the same RPC, otherwise resetting one
+ * used for another RPC. Creates a new handle if the cache is empty. */
+static hg_return_t alpha_handle_acquire(
+        alpha_resource_handle_t handle,
+        hg_id_t rpc_id,
+        hg_handle_t* h)
+{
+    alpha_handle_cache* cache = &handle->handle_cache;
+    hg_handle_t cached = HG_HANDLE_NULL;
+    bool must_reset = false;
 
-    hret = margo_get_output(h, &out);
-    if(hret != HG_SUCCESS) {
-        ret = ALPHA_ERR_FROM_MERCURY;
-        goto finish;
+    ABT_mutex_lock(cache->mutex);
+    if(cache->size) {
+        size_t i = cache->size;
+        while(i > 0 && cache->entries[i-1].rpc_id != rpc_id) --i;
+        if(i == 0) {
+            i = cache->size;
+            must_reset = true;
+        }
+        cached = cache->entries[i-1].h;
+        cache->entries[i-1] = cache->entries[cache->size-1];
+        cache->size -= 1;
     }
+    ABT_mutex_unlock(cache->mutex);
 
-    ret = out.ret;
-    if(ret == ALPHA_SUCCESS)
-        *result = out.result;
-
-    margo_free_output(h, &out);
-
-finish:
-    margo_destroy(h);
-    return ret;
+    if(cached != HG_HANDLE_NULL) {
+        if(!must_reset || margo_reset(cached, handle->addr, rpc_id) == HG_SUCCESS) {
+            *h = cached;
+            return HG_SUCCESS;
+        }
+        /* Mercury refuses to reset a handle it still references */
+        margo_destroy(cached);
+    }
+    return margo_create(handle->client->mid, handle->addr, rpc_id, h);
 }
 
-alpha_return_t alpha_compute_sum_timed(
+/* Gives a handle back to the resource handle's cache, or destroys it if
+ * the cache is full or if the handle is not reusable (e.g. its RPC failed
+ * or timed out, and Mercury may still be holding on to it) */
+static void alpha_handle_release(
         alpha_resource_handle_t handle,
-        int32_t x,
-        int32_t y,
-        double timeout_ms,
-        int32_t* result)
+        hg_id_t rpc_id,
+        hg_handle_t h,
+        bool reusable)
 {
-    hg_handle_t   h;
-    sum_in_t     in;
-    sum_out_t   out;
-    hg_return_t hret;
-    alpha_return_t ret;
+    alpha_handle_cache* cache = &handle->handle_cache;
+    if(reusable) {
+        ABT_mutex_lock(cache->mutex);
+        if(cache->size < cache->capacity) {
+            cache->entries[cache->size].h      = h;
+            cache->entries[cache->size].rpc_id = rpc_id;
+            cache->size += 1;
+            h = HG_HANDLE_NULL;
+        }
+        ABT_mutex_unlock(cache->mutex);
+    }
+    if(h != HG_HANDLE_NULL) margo_destroy(h);
+}
 
-    in.x = x;
-    in.y = y;
+/* Sleeps before an RPC rejected with ALPHA_ERR_BUSY is resent. The delay
+ * suggested by the provider is doubled at each attempt, and a random jitter
+ * of up to the same amount is added, so that clients rejected at the same
+ * time don't all come back at the same time. */
+static void alpha_backoff(
+        alpha_client_t client,
+        uint32_t retry_after_ms,
+        unsigned attempt)
+{
+    uint64_t z = alpha_client_random(client);
+    double delay_ms = retry_after_ms ? (double)retry_after_ms : 1.0;
+    delay_ms *= (double)(1u << (attempt < 10 ? attempt : 10));
+    delay_ms += delay_ms * (double)(z >> 11) / (double)(1ULL << 53);
+    margo_thread_sleep(client->mid, delay_ms);
+}
 
-    hret = margo_create(handle->client->mid, handle->addr, handle->client->sum_id, &h);
-    if(hret != HG_SUCCESS)
-        return ALPHA_ERR_FROM_MERCURY;
+/* Initializes a request that is already completed with the provided value */
+static inline void alpha_request_init_completed(alpha_request* req, alpha_return_t ret)
+{
+    memset(req, 0, sizeof(*req));
+    req->ret = ret;
+}
 
-    hret = margo_provider_forward_timed(handle->provider_id, h, &in, timeout_ms);
+static void alpha_sum_batch_release(alpha_sum_batch* batch)
+{
+    if(__atomic_sub_fetch(&batch->refcount, 1, __ATOMIC_ACQ_REL) != 0)
+        return;
+    ABT_eventual_free(&batch->ev);
+    alpha_resource_handle_release(batch->handle);
+    free(batch->x);
+    free(batch->y);
+    free(batch->results);
+    free(batch);
+}
 
-    if(hret == HG_TIMEOUT) {
-        ret = ALPHA_TIMEOUT;
-        goto finish;
-    }
+/* Sends the batch, places the results, and completes the batch's
+ * requests. Releases the reference held by the sender. */
+static void alpha_sum_batch_send(alpha_sum_batch* batch)
+{
+    alpha_resource_handle_t handle = batch->handle;
+    hg_handle_t     h;
+    sum_batch_in_t  in = {
+        .resource_id = handle->resource_id,
+        .count = batch->count,
+        .x     = batch->x,
+        .y     = batch->y
+    };
+    sum_batch_out_t out;
+    hg_return_t hret;
 
+    hret = alpha_handle_acquire(handle, handle->client->sum_batch_id, &h);
     if(hret != HG_SUCCESS) {
-        ret = ALPHA_ERR_FROM_MERCURY;
-        goto finish;
+        batch->ret = ALPHA_ERR_FROM_MERCURY;
+        goto complete;
     }
 
-    hret = margo_get_output(h, &out);
+    for(unsigned num_retries = 0; ; ++num_retries) {
+        hret = margo_provider_forward(handle->provider_id, h, &in);
+        if(hret != HG_SUCCESS) {
+            batch->ret = ALPHA_ERR_FROM_MERCURY;
+            goto finish;
+        }
 
-    if(hret != HG_SUCCESS) {
-        ret = ALPHA_ERR_FROM_MERCURY;
-        goto finish;
+        hret = margo_get_output(h, &out);
+        if(hret != HG_SUCCESS) {
+            batch->ret = ALPHA_ERR_FROM_MERCURY;
+            goto finish;
+        }
+
+        if(out.ret != ALPHA_ERR_BUSY || num_retries >= handle->client->max_retries)
+            break;
+        uint32_t retry_after_ms = out.retry_after_ms;
+        margo_free_output(h, &out);
+        alpha_backoff(handle->client, retry_after_ms, num_retries);
     }
 
-    ret = out.ret;
-    if(ret == ALPHA_SUCCESS)
-        *result = out.result;
+    batch->ret = out.ret;
+    if(out.ret == ALPHA_SUCCESS && out.count != batch->count)
+        batch->ret = ALPHA_ERR_OTHER;
+    if(batch->ret == ALPHA_SUCCESS) {
+        for(size_t i = 0; i < batch->count; ++i)
+            *(batch->results[i]) = out.result[i];
+    }
 
     margo_free_output(h, &out);
 
 finish:
-    margo_destroy(h);
-    return ret;
+    alpha_handle_release(handle, handle->client->sum_batch_id, h, hret == HG_SUCCESS);
+complete:
+    ABT_eventual_set(batch->ev, NULL, 0);
+    alpha_sum_batch_release(batch);
 }
 
-alpha_return_t alpha_compute_sum_multi(
-        alpha_resource_handle_t handle,
-        size_t count,
-        const int32_t* x,
-        const int32_t* y,
-        int32_t* result)
+static void alpha_sum_batch_send_ult(void* arg)
 {
-    alpha_return_t ret    = ALPHA_SUCCESS;
-    hg_return_t hret      = HG_SUCCESS;
-    hg_addr_t self_addr   = HG_ADDR_NULL;
-    hg_bulk_t input_bulk  = HG_BULK_NULL;
-    hg_bulk_t output_bulk = HG_BULK_NULL;
-    margo_instance_id mid = handle->client->mid;
+    alpha_sum_batch_send((alpha_sum_batch*)arg);
+}
 
-    void* input_ptrs[] = {(void*)x, (void*)y};
-    hg_size_t input_sizes[] = {count*sizeof(int32_t), count*sizeof(int32_t)};
-    void* output_ptrs[] = {(void*)result};
-    hg_size_t output_sizes[] = {count*sizeof(int32_t)};
+/* Waits for the coalescer's delay and sends the batch
+ * if it hasn't been sent already because it was full */
+static void alpha_sum_batch_timer_ult(void* arg)
+{
+    alpha_sum_batch* batch = (alpha_sum_batch*)arg;
+    alpha_coalescer* coalescer = &batch->handle->coalescer;
 
-    char address[256];
-    hg_size_t address_size = 256;
-    hret = margo_addr_self(mid, &self_addr);
-    if(hret != HG_SUCCESS) {
-        ret = ALPHA_ERR_FROM_MERCURY;
-        goto finish;
-    }
-    margo_addr_to_string(mid, address, &address_size, self_addr);
-    if(hret != HG_SUCCESS) {
-        ret = ALPHA_ERR_FROM_MERCURY;
-        goto finish;
-    }
+    ABT_mutex_lock(coalescer->mutex);
+    double delay_ms = coalescer->max_delay_us/1000.0;
+    ABT_mutex_unlock(coalescer->mutex);
 
-    hret = margo_bulk_create(mid, 2, input_ptrs, input_sizes, HG_BULK_READ_ONLY, &input_bulk);
-    if(hret != HG_SUCCESS) {
-        ret = ALPHA_ERR_FROM_MERCURY;
-        goto finish;
-    }
-    hret = margo_bulk_create(mid, 1, output_ptrs, output_sizes, HG_BULK_WRITE_ONLY, &output_bulk);
-    if(hret != HG_SUCCESS) {
-        ret = ALPHA_ERR_FROM_MERCURY;
-        goto finish;
-    }
+    margo_thread_sleep(batch->handle->client->mid, delay_ms);
 
-    alpha_bulk_location_t x_bl = {
-        .bulk = input_bulk,
-        .address = address,
-        .offset = 0,
-        .size = count*sizeof(int32_t)
-    };
-    alpha_bulk_location_t y_bl = {
-        .bulk = input_bulk,
-        .address = address,
-        .offset = count*sizeof(int32_t),
-        .size = count*sizeof(int32_t)
-    };
-    alpha_bulk_location_t result_bl = {
-        .bulk = output_bulk,
-        .address = address,
-        .offset = 0,
-        .size = count*sizeof(int32_t)
-    };
+    ABT_mutex_lock(coalescer->mutex);
+    bool must_send = coalescer->current == batch;
+    if(must_send) coalescer->current = NULL;
+    ABT_mutex_unlock(coalescer->mutex);
 
-    ret = alpha_compute_sum_bulk(handle, count, &x_bl, &y_bl, &result_bl);
+    if(must_send) alpha_sum_batch_send(batch);
+    alpha_sum_batch_release(batch);
+}
 
-finish:
+/* Creates a batch with a reference for its sender and one for its timer ULT */
+static alpha_return_t alpha_sum_batch_create(
+        alpha_resource_handle_t handle,
+        size_t capacity,
+        alpha_sum_batch** batch)
+{
+    alpha_sum_batch* b = (alpha_sum_batch*)calloc(1, sizeof(*b));
+    if(!b) return ALPHA_ERR_ALLOCATION;
+    b->x       = (int32_t*)malloc(capacity*sizeof(int32_t));
+    b->y       = (int32_t*)malloc(capacity*sizeof(int32_t));
+    b->results = (int32_t**)malloc(capacity*sizeof(int32_t*));
+    if(!b->x || !b->y || !b->results) goto error;
+    if(ABT_eventual_create(0, &b->ev) != ABT_SUCCESS) goto error;
+    b->capacity = capacity;
+    b->handle   = handle;
+    b->refcount = 2;
+    alpha_resource_handle_ref_incr(handle);
 
-    margo_addr_free(mid, self_addr);
+    ABT_pool pool = ABT_POOL_NULL;
+    margo_get_handler_pool(handle->client->mid, &pool);
+    if(ABT_thread_create(pool, alpha_sum_batch_timer_ult, b,
+                         ABT_THREAD_ATTR_NULL, NULL) != ABT_SUCCESS) {
+        b->refcount = 1;
+        alpha_sum_batch_release(b);
+        return ALPHA_ERR_FROM_ARGOBOTS;
+    }
+
+    *batch = b;
+    return ALPHA_SUCCESS;
+
+error:
+    free(b->x);
+    free(b->y);
+    free(b->results);
+    free(b);
+    return ALPHA_ERR_ALLOCATION;
+}
+
+/* Adds a sum to the resource handle's current batch, creating it if needed,
+ * and hands the batch over to a sender ULT if the batch is full */
+static alpha_return_t alpha_sum_coalesce(
+        alpha_resource_handle_t handle,
+        int32_t x,
+        int32_t y,
+        int32_t* result,
+        alpha_request* req)
+{
+    alpha_coalescer* coalescer = &handle->coalescer;
+    alpha_sum_batch* full_batch = NULL;
+
+    ABT_mutex_lock(coalescer->mutex);
+    alpha_sum_batch* batch = coalescer->current;
+    if(!batch) {
+        alpha_return_t ret = alpha_sum_batch_create(handle, coalescer->max_batch_size, &batch);
+        if(ret != ALPHA_SUCCESS) {
+            ABT_mutex_unlock(coalescer->mutex);
+            return ret;
+        }
+        coalescer->current = batch;
+    }
+    size_t i = batch->count++;
+    batch->x[i]       = x;
+    batch->y[i]       = y;
+    batch->results[i] = result;
+    __atomic_add_fetch(&batch->refcount, 1, __ATOMIC_RELAXED);
+    if(batch->count == batch->capacity) {
+        coalescer->current = NULL;
+        full_batch = batch;
+    }
+    ABT_mutex_unlock(coalescer->mutex);
+
+    alpha_request_init_completed(req, ALPHA_SUCCESS);
+    req->batch = batch;
+
+    if(full_batch) {
+        ABT_pool pool = ABT_POOL_NULL;
+        margo_get_handler_pool(handle->client->mid, &pool);
+        if(ABT_thread_create(pool, alpha_sum_batch_send_ult, full_batch,
+                             ABT_THREAD_ATTR_NULL, NULL) != ABT_SUCCESS)
+            alpha_sum_batch_send(full_batch);
+    }
+    return ALPHA_SUCCESS;
+}
+
+/* Forwards the request's input with its handle */
+static hg_return_t alpha_request_iforward(alpha_request* req)
+{
+    uint16_t provider_id = req->handle->provider_id;
+    if(req->timeout_ms > 0)
+        return margo_provider_iforward_timed(provider_id, req->h, &req->in,
+                                             req->timeout_ms, &req->req);
+    else
+        return margo_provider_iforward(provider_id, req->h, &req->in, &req->req);
+}
+
+/* Waits for the operation of a request and releases the resources it uses
+ * (but not the request itself, which may live on the stack) */
+static alpha_return_t alpha_request_complete(alpha_request* req)
+{
+    alpha_return_t ret = req->ret;
+    if(req->batch) {
+        ABT_eventual_wait(req->batch->ev, NULL);
+        ret = req->batch->ret;
+        alpha_sum_batch_release(req->batch);
+        req->batch = NULL;
+    }
+    if(req->h != HG_HANDLE_NULL) {
+        alpha_client_t client = req->handle->client;
+        hg_return_t hret;
+        while(true) {
+            hret = margo_wait(req->req);
+            if(hret == HG_TIMEOUT)
+                ret = ALPHA_TIMEOUT;
+            else if(hret != HG_SUCCESS)
+                ret = ALPHA_ERR_FROM_MERCURY;
+            else
+                ret = req->output_fn(req);
+            if(ret != ALPHA_ERR_BUSY || req->num_retries >= client->max_retries)
+                break;
+            /* the provider is overloaded, resend the
+             * same RPC with the same handle later */
+            alpha_backoff(client, req->retry_after_ms, req->num_retries);
+            req->num_retries += 1;
+            hret = alpha_request_iforward(req);
+            if(hret != HG_SUCCESS) {
+                ret = ALPHA_ERR_FROM_MERCURY;
+                break;
+            }
+        }
+        alpha_handle_release(req->handle, req->rpc_id, req->h, hret == HG_SUCCESS);
+        req->h = HG_HANDLE_NULL;
+        if(req->shm_staging) {
+            alpha_shm_region_free(&req->handle->shm, req->shm_staging);
+            req->shm_staging = NULL;
+        }
+        alpha_resource_handle_release(req->handle);
+    }
+    for(int i = 0; i < 2; ++i) {
+        margo_bulk_free(req->bulks[i]);
+        req->bulks[i] = HG_BULK_NULL;
+    }
+    return ret;
+}
+
+/* Gets a handle for the given RPC and forwards the request's input (which
+ * the caller must have set), the request's h and req fields are set if the
+ * function succeeds, in which case the request holds a reference to the
+ * resource handle */
+static alpha_return_t alpha_request_forward(
+        alpha_resource_handle_t handle,
+        hg_id_t rpc_id,
+        double timeout_ms,
+        alpha_request* req)
+{
+    hg_return_t hret;
+
+    hret = alpha_handle_acquire(handle, rpc_id, &req->h);
+    if(hret != HG_SUCCESS) {
+        req->h = HG_HANDLE_NULL;
+        return ALPHA_ERR_FROM_MERCURY;
+    }
+
+    req->handle     = handle;
+    req->rpc_id     = rpc_id;
+    req->timeout_ms = timeout_ms;
+    hret = alpha_request_iforward(req);
+    if(hret != HG_SUCCESS) {
+        margo_destroy(req->h);
+        req->h = HG_HANDLE_NULL;
+        return ALPHA_ERR_FROM_MERCURY;
+    }
+
+    alpha_resource_handle_ref_incr(handle);
+    return ALPHA_SUCCESS;
+}
+
+static alpha_return_t alpha_sum_output(alpha_request* req)
+{
+    sum_out_t out;
+    hg_return_t hret = margo_get_output(req->h, &out);
+    if(hret != HG_SUCCESS)
+        return ALPHA_ERR_FROM_MERCURY;
+    alpha_return_t ret = out.ret;
+    req->retry_after_ms = out.retry_after_ms;
+    if(ret == ALPHA_SUCCESS)
+        *(int32_t*)req->result = out.result;
+    margo_free_output(req->h, &out);
+    return ret;
+}
+
+static alpha_return_t alpha_sum_start(
+        alpha_resource_handle_t handle,
+        int32_t x,
+        int32_t y,
+        double timeout_ms,
+        int32_t* result,
+        alpha_request* req)
+{
+    if(timeout_ms <= 0 && handle->coalescer.max_batch_size > 1)
+        return alpha_sum_coalesce(handle, x, y, result, req);
+
+    alpha_request_init_completed(req, ALPHA_SUCCESS);
+    req->in.sum.resource_id = handle->resource_id;
+    req->in.sum.x = x;
+    req->in.sum.y = y;
+    req->output_fn = alpha_sum_output;
+    req->result    = result;
+
+    return alpha_request_forward(handle, handle->client->sum_id, timeout_ms, req);
+}
+
+static alpha_return_t alpha_sum_multi_output(alpha_request* req)
+{
+    sum_multi_out_t out;
+    hg_return_t hret = margo_get_output(req->h, &out);
+    if(hret != HG_SUCCESS)
+        return ALPHA_ERR_FROM_MERCURY;
+    alpha_return_t ret = out.ret;
+    req->retry_after_ms = out.retry_after_ms;
+    margo_free_output(req->h, &out);
+    return ret;
+}
+
+static alpha_return_t alpha_sum_bulk_start(
+        alpha_resource_handle_t handle,
+        alpha_dtype_t dtype,
+        size_t count,
+        const alpha_bulk_location_t* x,
+        const alpha_bulk_location_t* y,
+        const alpha_bulk_location_t* result,
+        alpha_request* req)
+{
+    alpha_request_init_completed(req, ALPHA_SUCCESS);
+    req->in.sum_multi.resource_id = handle->resource_id;
+    req->in.sum_multi.dtype       = dtype;
+    req->in.sum_multi.count       = count;
+    req->in.sum_multi.x           = *x;
+    req->in.sum_multi.y           = *y;
+    req->in.sum_multi.result      = *result;
+    req->output_fn = alpha_sum_multi_output;
+
+    return alpha_request_forward(handle, handle->client->sum_multi_id, 0, req);
+}
+
+static alpha_return_t alpha_accumulate_bulk_start(
+        alpha_resource_handle_t handle,
+        alpha_dtype_t dtype,
+        size_t count,
+        const alpha_bulk_location_t* x,
+        const alpha_bulk_location_t* y,
+        alpha_request* req)
+{
+    alpha_request_init_completed(req, ALPHA_SUCCESS);
+    req->in.accumulate.resource_id = handle->resource_id;
+    req->in.accumulate.dtype       = dtype;
+    req->in.accumulate.count       = count;
+    req->in.accumulate.x           = *x;
+    req->in.accumulate.y           = *y;
+    req->output_fn = alpha_sum_multi_output;
+
+    return alpha_request_forward(handle, handle->client->accumulate_id, 0, req);
+}
+
+static alpha_return_t alpha_sum_strided_start(
+        alpha_resource_handle_t handle,
+        alpha_dtype_t dtype,
+        size_t count,
+        const alpha_strided_location_t* x,
+        const alpha_strided_location_t* y,
+        const alpha_strided_location_t* result,
+        alpha_request* req)
+{
+    if(dtype > ALPHA_DTYPE_F64 || !x || !y || !result)
+        return ALPHA_ERR_INVALID_ARGS;
+    alpha_request_init_completed(req, ALPHA_SUCCESS);
+    req->in.sum_strided.resource_id = handle->resource_id;
+    req->in.sum_strided.dtype       = dtype;
+    req->in.sum_strided.count       = count;
+    req->in.sum_strided.x           = *x;
+    req->in.sum_strided.y           = *y;
+    req->in.sum_strided.result      = *result;
+    req->output_fn = alpha_sum_multi_output;
+
+    return alpha_request_forward(handle, handle->client->sum_strided_id, 0, req);
+}
+
+/* Fills a bulk location exposing [ptr, ptr+size), with the bulk handle of
+ * a registered buffer when possible, otherwise with a new bulk handle also
+ * stored in tmp_bulk, for the caller to free once the transfer is done */
+static alpha_return_t alpha_expose_array(
+        alpha_client_t client, const void* ptr, hg_size_t size, hg_uint8_t flags,
+        alpha_bulk_location_t* bl, hg_bulk_t* tmp_bulk)
+{
+    bl->address = client->self_addr_str;
+    bl->size    = (int64_t)size;
+    *tmp_bulk   = HG_BULK_NULL;
+    if(find_registered_buffer(client, ptr, size, &bl->bulk, &bl->offset))
+        return ALPHA_SUCCESS;
+    void* ptrs[1] = {(void*)ptr};
+    hg_size_t sizes[1] = {size};
+    hg_return_t hret = margo_bulk_create(client->mid, 1, ptrs, sizes, flags, tmp_bulk);
+    if(hret != HG_SUCCESS) return ALPHA_ERR_FROM_MERCURY;
+    bl->bulk   = *tmp_bulk;
+    bl->offset = 0;
+    return ALPHA_SUCCESS;
+}
+
+static alpha_return_t alpha_sum_stored_bulk_start(
+        alpha_resource_handle_t handle,
+        alpha_dtype_t dtype,
+        size_t count,
+        const alpha_bulk_location_t* x,
+        uint64_t y_id,
+        const alpha_bulk_location_t* result,
+        alpha_request* req)
+{
+    if(dtype > ALPHA_DTYPE_F64)
+        return ALPHA_ERR_INVALID_ARGS;
+    alpha_request_init_completed(req, ALPHA_SUCCESS);
+    req->in.sum_stored.resource_id = handle->resource_id;
+    req->in.sum_stored.dtype       = dtype;
+    req->in.sum_stored.count       = count;
+    req->in.sum_stored.x           = *x;
+    req->in.sum_stored.y_id        = y_id;
+    req->in.sum_stored.result      = *result;
+    req->output_fn = alpha_sum_multi_output;
+
+    return alpha_request_forward(handle, handle->client->sum_stored_id, 0, req);
+}
+
+static alpha_return_t alpha_sum_stored_start(
+        alpha_resource_handle_t handle,
+        alpha_dtype_t dtype,
+        size_t count,
+        const void* x,
+        uint64_t y_id,
+        void* result,
+        alpha_request* req)
+{
+    alpha_return_t ret    = ALPHA_SUCCESS;
+    hg_bulk_t input_bulk  = HG_BULK_NULL;
+    hg_bulk_t output_bulk = HG_BULK_NULL;
+    alpha_bulk_location_t x_bl, result_bl;
+
+    if(dtype > ALPHA_DTYPE_F64)
+        return ALPHA_ERR_INVALID_ARGS;
+    alpha_request_init_completed(req, ALPHA_SUCCESS);
+    if(count == 0) return ALPHA_SUCCESS;
+    hg_size_t size = count*alpha_dtype_size(dtype);
+
+    ret = alpha_expose_array(handle->client, x, size, HG_BULK_READ_ONLY, &x_bl, &input_bulk);
+    if(ret != ALPHA_SUCCESS) goto error;
+    ret = alpha_expose_array(handle->client, result, size, HG_BULK_WRITE_ONLY, &result_bl, &output_bulk);
+    if(ret != ALPHA_SUCCESS) goto error;
+
+    ret = alpha_sum_stored_bulk_start(handle, dtype, count, &x_bl, y_id, &result_bl, req);
+    if(ret != ALPHA_SUCCESS) goto error;
+
+    /* the temporary bulk handles are freed when the request completes */
+    req->bulks[0] = input_bulk;
+    req->bulks[1] = output_bulk;
+    return ALPHA_SUCCESS;
+
+error:
     margo_bulk_free(input_bulk);
     margo_bulk_free(output_bulk);
+    return ret;
+}
+
+static alpha_return_t alpha_array_store_output(alpha_request* req)
+{
+    array_store_out_t out;
+    hg_return_t hret = margo_get_output(req->h, &out);
+    if(hret != HG_SUCCESS)
+        return ALPHA_ERR_FROM_MERCURY;
+    alpha_return_t ret = out.ret;
+    if(ret == ALPHA_SUCCESS)
+        *(uint64_t*)req->result = out.array_id;
+    margo_free_output(req->h, &out);
+    return ret;
+}
+
+static alpha_return_t alpha_array_remove_output(alpha_request* req)
+{
+    array_remove_out_t out;
+    hg_return_t hret = margo_get_output(req->h, &out);
+    if(hret != HG_SUCCESS)
+        return ALPHA_ERR_FROM_MERCURY;
+    alpha_return_t ret = out.ret;
+    margo_free_output(req->h, &out);
+    return ret;
+}
+
+static alpha_return_t alpha_named_array_output(alpha_request* req)
+{
+    named_array_out_t out;
+    hg_return_t hret = margo_get_output(req->h, &out);
+    if(hret != HG_SUCCESS)
+        return ALPHA_ERR_FROM_MERCURY;
+    alpha_return_t ret = out.ret;
+    margo_free_output(req->h, &out);
+    return ret;
+}
+
+static alpha_return_t alpha_reduce_output(alpha_request* req)
+{
+    reduce_out_t out;
+    hg_return_t hret = margo_get_output(req->h, &out);
+    if(hret != HG_SUCCESS)
+        return ALPHA_ERR_FROM_MERCURY;
+    alpha_return_t ret = out.ret;
+    req->retry_after_ms = out.retry_after_ms;
+    if(ret == ALPHA_SUCCESS)
+        *(int64_t*)req->result = out.result;
+    margo_free_output(req->h, &out);
+    return ret;
+}
 
+static alpha_return_t alpha_reduce_bulk_start(
+        alpha_resource_handle_t handle,
+        alpha_reduce_op_t op,
+        size_t count,
+        const alpha_bulk_location_t* x,
+        const alpha_bulk_location_t* y,
+        int64_t* result,
+        alpha_request* req)
+{
+    if(!x || !result || (op == ALPHA_REDUCE_DOT && !y))
+        return ALPHA_ERR_INVALID_ARGS;
+    alpha_request_init_completed(req, ALPHA_SUCCESS);
+    req->in.reduce.resource_id = handle->resource_id;
+    req->in.reduce.op          = op;
+    req->in.reduce.count       = count;
+    req->in.reduce.x           = *x;
+    /* y is only sent for a dot product */
+    if(op == ALPHA_REDUCE_DOT)
+        req->in.reduce.y = *y;
+    req->output_fn = alpha_reduce_output;
+    req->result    = result;
+
+    return alpha_request_forward(handle, handle->client->reduce_id, 0, req);
+}
+
+static alpha_return_t alpha_sum_inline_output(alpha_request* req)
+{
+    sum_batch_out_t out;
+    hg_return_t hret = margo_get_output(req->h, &out);
+    if(hret != HG_SUCCESS)
+        return ALPHA_ERR_FROM_MERCURY;
+    alpha_return_t ret = out.ret;
+    req->retry_after_ms = out.retry_after_ms;
+    if(ret == ALPHA_SUCCESS && out.count != req->count)
+        ret = ALPHA_ERR_OTHER;
+    if(ret == ALPHA_SUCCESS)
+        memcpy(req->result, out.result, req->count*sizeof(int32_t));
+    margo_free_output(req->h, &out);
+    return ret;
+}
+
+/* Sends the x and y arrays inline in an alpha_sum_batch RPC */
+static alpha_return_t alpha_sum_inline_start(
+        alpha_resource_handle_t handle,
+        size_t count,
+        const int32_t* x,
+        const int32_t* y,
+        int32_t* result,
+        alpha_request* req)
+{
+    alpha_request_init_completed(req, ALPHA_SUCCESS);
+    req->in.sum_batch.resource_id = handle->resource_id;
+    req->in.sum_batch.count       = count;
+    req->in.sum_batch.x           = (int32_t*)x;
+    req->in.sum_batch.y           = (int32_t*)y;
+    req->output_fn = alpha_sum_inline_output;
+    req->result    = result;
+    req->count     = count;
+
+    return alpha_request_forward(handle, handle->client->sum_batch_id, 0, req);
+}
+
+static alpha_return_t alpha_sum_shm_output(alpha_request* req)
+{
+    sum_multi_out_t out;
+    hg_return_t hret = margo_get_output(req->h, &out);
+    if(hret != HG_SUCCESS)
+        return ALPHA_ERR_FROM_MERCURY;
+    alpha_return_t ret = out.ret;
+    req->retry_after_ms = out.retry_after_ms;
+    if(ret == ALPHA_SUCCESS && req->shm_result)
+        memcpy(req->result, req->shm_result, req->count*sizeof(int32_t));
+    margo_free_output(req->h, &out);
     return ret;
 }
 
+/* Places the arrays in the resource handle's segment, copying those that
+ * are not already in it, and sends their offsets in an alpha_sum_shm RPC.
+ * Returns ALPHA_ERR_OP_UNSUPPORTED if the segment has no room for them. */
+static alpha_return_t alpha_sum_shm_start(
+        alpha_resource_handle_t handle,
+        size_t count,
+        const int32_t* x,
+        const int32_t* y,
+        int32_t* result,
+        alpha_request* req)
+{
+    alpha_shm_region* region = &handle->shm;
+    size_t size = count*sizeof(int32_t);
+    uint64_t x_offset = 0, y_offset = 0, r_offset = 0;
+    bool x_in_shm = alpha_shm_region_find(region, x, size, &x_offset);
+    bool y_in_shm = alpha_shm_region_find(region, y, size, &y_offset);
+    bool r_in_shm = alpha_shm_region_find(region, result, size, &r_offset);
+
+    /* stage the other arrays in a single block */
+    char* staging = NULL;
+    size_t num_staged = !x_in_shm + !y_in_shm + !r_in_shm;
+    size_t aligned_size = (size + ALPHA_SHM_ALIGNMENT - 1) & ~(size_t)(ALPHA_SHM_ALIGNMENT - 1);
+    if(num_staged) {
+        if(size > region->size) return ALPHA_ERR_OP_UNSUPPORTED;
+        staging = (char*)alpha_shm_region_alloc(region, num_staged*aligned_size);
+        if(!staging) return ALPHA_ERR_OP_UNSUPPORTED;
+    }
+
+    alpha_request_init_completed(req, ALPHA_SUCCESS);
+    char* next = staging;
+    if(!x_in_shm) {
+        memcpy(next, x, size);
+        x_offset = (uint64_t)(next - region->base);
+        next += aligned_size;
+    }
+    if(!y_in_shm) {
+        memcpy(next, y, size);
+        y_offset = (uint64_t)(next - region->base);
+        next += aligned_size;
+    }
+    if(!r_in_shm) {
+        r_offset = (uint64_t)(next - region->base);
+        req->shm_result = (const int32_t*)next;
+    }
+    req->in.sum_shm.resource_id   = handle->resource_id;
+    req->in.sum_shm.segment_id    = region->segment_id;
+    req->in.sum_shm.count         = count;
+    req->in.sum_shm.x_offset      = x_offset;
+    req->in.sum_shm.y_offset      = y_offset;
+    req->in.sum_shm.result_offset = r_offset;
+    req->output_fn = alpha_sum_shm_output;
+    req->result    = result;
+    req->count     = count;
+
+    alpha_return_t ret = alpha_request_forward(handle, handle->client->sum_shm_id, 0, req);
+    if(ret != ALPHA_SUCCESS) {
+        if(staging) alpha_shm_region_free(region, staging);
+        return ret;
+    }
+    /* the staging block is freed when the request completes */
+    req->shm_staging = staging;
+    return ALPHA_SUCCESS;
+}
+
+/* Returns the operations of the target provider if it lives in the client's
+ * margo instance, NULL otherwise. The lookup is done for each operation since
+ * the provider may be destroyed at any time (the operations then fail with
+ * ALPHA_ERR_INVALID_PROVIDER, see local.h). */
+static alpha_local_ops* alpha_find_local_ops(alpha_resource_handle_t handle)
+{
+    if(!handle->is_local) return NULL;
+    margo_instance_id mid = handle->client->mid;
+    hg_id_t id;
+    hg_bool_t flag = HG_FALSE;
+    hg_return_t hret = margo_provider_registered_name(
+        mid, ALPHA_LOCAL_RPC_NAME, handle->provider_id, &id, &flag);
+    if(hret != HG_SUCCESS || flag != HG_TRUE) return NULL;
+    return (alpha_local_ops*)margo_registered_data(mid, id);
+}
+
+/* Calls sum_multi on a co-located provider, with the same retry
+ * policy as RPCs if the provider is busy */
+static alpha_return_t alpha_sum_multi_local(
+        alpha_resource_handle_t handle,
+        alpha_local_ops* ops,
+        size_t count,
+        const int32_t* x,
+        const int32_t* y,
+        int32_t* result)
+{
+    alpha_client_t client = handle->client;
+    for(unsigned num_retries = 0; ; ++num_retries) {
+        uint32_t retry_after_ms = 0;
+        alpha_return_t ret = ops->sum_multi(ops->context, handle->resource_id,
+                                            count, x, y, result, &retry_after_ms);
+        if(ret != ALPHA_ERR_BUSY || num_retries >= client->max_retries)
+            return ret;
+        alpha_backoff(client, retry_after_ms, num_retries);
+    }
+}
+
+/* Exposes the arrays through bulk handles (those of registered buffers
+ * when possible) and sends them in an alpha_sum_multi RPC */
+static alpha_return_t alpha_sum_multi_rdma_start(
+        alpha_resource_handle_t handle,
+        alpha_dtype_t dtype,
+        size_t count,
+        const void* x,
+        const void* y,
+        void* result,
+        alpha_request* req)
+{
+    alpha_return_t ret    = ALPHA_SUCCESS;
+    hg_return_t hret      = HG_SUCCESS;
+    hg_bulk_t input_bulk  = HG_BULK_NULL;
+    hg_bulk_t output_bulk = HG_BULK_NULL;
+    alpha_client_t client = handle->client;
+    margo_instance_id mid = client->mid;
+    hg_size_t size        = count*alpha_dtype_size(dtype);
+
+    alpha_bulk_location_t x_bl = {
+        .bulk = HG_BULK_NULL,
+        .address = client->self_addr_str,
+        .offset = 0,
+        .size = size
+    };
+    alpha_bulk_location_t y_bl = x_bl;
+    alpha_bulk_location_t result_bl = x_bl;
+
+    /* use the bulk handles of registered buffers when possible */
+    bool x_registered = find_registered_buffer(client, x, size, &x_bl.bulk, &x_bl.offset);
+    bool y_registered = find_registered_buffer(client, y, size, &y_bl.bulk, &y_bl.offset);
+    bool r_registered = find_registered_buffer(client, result, size, &result_bl.bulk, &result_bl.offset);
+
+    /* register the arrays that are not part of a registered buffer */
+    void* input_ptrs[2];
+    hg_size_t input_sizes[2];
+    uint32_t num_inputs = 0;
+    if(!x_registered) {
+        input_ptrs[num_inputs]  = (void*)x;
+        input_sizes[num_inputs] = size;
+        num_inputs += 1;
+    }
+    if(!y_registered) {
+        input_ptrs[num_inputs]  = (void*)y;
+        input_sizes[num_inputs] = size;
+        num_inputs += 1;
+    }
+    if(num_inputs) {
+        hret = margo_bulk_create(mid, num_inputs, input_ptrs, input_sizes, HG_BULK_READ_ONLY, &input_bulk);
+        if(hret != HG_SUCCESS) {
+            ret = ALPHA_ERR_FROM_MERCURY;
+            goto error;
+        }
+        if(!x_registered) {
+            x_bl.bulk   = input_bulk;
+            x_bl.offset = 0;
+        }
+        if(!y_registered) {
+            y_bl.bulk   = input_bulk;
+            y_bl.offset = x_registered ? 0 : size;
+        }
+    }
+    if(!r_registered) {
+        void* output_ptrs[] = {(void*)result};
+        hg_size_t output_sizes[] = {size};
+        hret = margo_bulk_create(mid, 1, output_ptrs, output_sizes, HG_BULK_WRITE_ONLY, &output_bulk);
+        if(hret != HG_SUCCESS) {
+            ret = ALPHA_ERR_FROM_MERCURY;
+            goto error;
+        }
+        result_bl.bulk   = output_bulk;
+        result_bl.offset = 0;
+    }
+
+    ret = alpha_sum_bulk_start(handle, dtype, count, &x_bl, &y_bl, &result_bl, req);
+    if(ret != ALPHA_SUCCESS) goto error;
+
+    /* the temporary bulk handles are freed when the request completes */
+    req->bulks[0] = input_bulk;
+    req->bulks[1] = output_bulk;
+    return ALPHA_SUCCESS;
+
+error:
+    margo_bulk_free(input_bulk);
+    margo_bulk_free(output_bulk);
+    return ret;
+}
+
+static alpha_return_t alpha_sum_multi_start(
+        alpha_resource_handle_t handle,
+        size_t count,
+        const int32_t* x,
+        const int32_t* y,
+        int32_t* result,
+        alpha_request* req)
+{
+    alpha_request_init_completed(req, ALPHA_SUCCESS);
+    if(count == 0) return ALPHA_SUCCESS;
+
+    /* co-located providers work directly on the caller's arrays */
+    alpha_local_ops* ops = alpha_find_local_ops(handle);
+    if(ops) {
+        req->ret = alpha_sum_multi_local(handle, ops, count, x, y, result);
+        return ALPHA_SUCCESS;
+    }
+
+    /* providers on the same node work on the handle's shared-memory
+     * segment, unless it has no room left for the arrays */
+    if(handle->shm.base) {
+        alpha_return_t ret = alpha_sum_shm_start(handle, count, x, y, result, req);
+        if(ret != ALPHA_ERR_OP_UNSUPPORTED) return ret;
+    }
+
+    /* small arrays are cheaper to send inline than through RDMA */
+    if(count <= handle->client->eager_threshold)
+        return alpha_sum_inline_start(handle, count, x, y, result, req);
+
+    return alpha_sum_multi_rdma_start(handle, ALPHA_DTYPE_I32, count, x, y, result, req);
+}
+
+/* Arrays of int32_t take the same paths as in alpha_compute_sum_multi,
+ * those of other types are always exchanged through RDMA */
+static alpha_return_t alpha_sum_multi_typed_start(
+        alpha_resource_handle_t handle,
+        alpha_dtype_t dtype,
+        size_t count,
+        const void* x,
+        const void* y,
+        void* result,
+        alpha_request* req)
+{
+    if(dtype > ALPHA_DTYPE_F64)
+        return ALPHA_ERR_INVALID_ARGS;
+    if(dtype == ALPHA_DTYPE_I32)
+        return alpha_sum_multi_start(handle, count,
+                (const int32_t*)x, (const int32_t*)y, (int32_t*)result, req);
+    alpha_request_init_completed(req, ALPHA_SUCCESS);
+    if(count == 0) return ALPHA_SUCCESS;
+    return alpha_sum_multi_rdma_start(handle, dtype, count, x, y, result, req);
+}
+
+/* Moves a request started in a stack-allocated alpha_request
+ * to a heap-allocated one that can be returned to the user */
+static alpha_return_t alpha_request_detach(alpha_request* tmp, alpha_request_t* req)
+{
+    alpha_request_t r = (alpha_request_t)malloc(sizeof(*r));
+    if(!r) {
+        alpha_request_complete(tmp);
+        return ALPHA_ERR_ALLOCATION;
+    }
+    *r = *tmp;
+    *req = r;
+    return ALPHA_SUCCESS;
+}
+
+alpha_return_t alpha_compute_sum(
+        alpha_resource_handle_t handle,
+        int32_t x,
+        int32_t y,
+        int32_t* result)
+{
+    alpha_request req;
+    alpha_return_t ret = alpha_sum_start(handle, x, y, 0, result, &req);
+    if(ret != ALPHA_SUCCESS) return ret;
+    return alpha_request_complete(&req);
+}
+
+alpha_return_t alpha_compute_sum_async(
+        alpha_resource_handle_t handle,
+        int32_t x,
+        int32_t y,
+        int32_t* result,
+        alpha_request_t* req)
+{
+    alpha_request tmp;
+    alpha_return_t ret = alpha_sum_start(handle, x, y, 0, result, &tmp);
+    if(ret != ALPHA_SUCCESS) return ret;
+    return alpha_request_detach(&tmp, req);
+}
+
+alpha_return_t alpha_compute_sum_timed(
+        alpha_resource_handle_t handle,
+        int32_t x,
+        int32_t y,
+        double timeout_ms,
+        int32_t* result)
+{
+    alpha_request req;
+    alpha_return_t ret = alpha_sum_start(handle, x, y, timeout_ms, result, &req);
+    if(ret != ALPHA_SUCCESS) return ret;
+    return alpha_request_complete(&req);
+}
+
+alpha_return_t alpha_compute_sum_multi(
+        alpha_resource_handle_t handle,
+        size_t count,
+        const int32_t* x,
+        const int32_t* y,
+        int32_t* result)
+{
+    alpha_request req;
+    alpha_return_t ret = alpha_sum_multi_start(handle, count, x, y, result, &req);
+    if(ret != ALPHA_SUCCESS) return ret;
+    return alpha_request_complete(&req);
+}
+
+alpha_return_t alpha_compute_sum_multi_async(
+        alpha_resource_handle_t handle,
+        size_t count,
+        const int32_t* x,
+        const int32_t* y,
+        int32_t* result,
+        alpha_request_t* req)
+{
+    alpha_request tmp;
+    alpha_return_t ret = alpha_sum_multi_start(handle, count, x, y, result, &tmp);
+    if(ret != ALPHA_SUCCESS) return ret;
+    return alpha_request_detach(&tmp, req);
+}
+
 alpha_return_t alpha_compute_sum_bulk(
           alpha_resource_handle_t handle,
           size_t count,
@@ -296,39 +1641,433 @@ alpha_return_t alpha_compute_sum_bulk(
           const alpha_bulk_location_t* y,
           const alpha_bulk_location_t* result)
 {
+    alpha_request req;
+    alpha_return_t ret = alpha_sum_bulk_start(handle, ALPHA_DTYPE_I32, count, x, y, result, &req);
+    if(ret != ALPHA_SUCCESS) return ret;
+    return alpha_request_complete(&req);
+}
 
-    hg_handle_t     h;
-    sum_multi_in_t  in = {
-        .count  = count,
-        .x      = *x,
-        .y      = *y,
-        .result = *result
-    };
-    sum_multi_out_t out;
-    hg_return_t hret;
-    alpha_return_t ret;
+alpha_return_t alpha_compute_sum_bulk_async(
+          alpha_resource_handle_t handle,
+          size_t count,
+          const alpha_bulk_location_t* x,
+          const alpha_bulk_location_t* y,
+          const alpha_bulk_location_t* result,
+          alpha_request_t* req)
+{
+    alpha_request tmp;
+    alpha_return_t ret = alpha_sum_bulk_start(handle, ALPHA_DTYPE_I32, count, x, y, result, &tmp);
+    if(ret != ALPHA_SUCCESS) return ret;
+    return alpha_request_detach(&tmp, req);
+}
 
-    hret = margo_create(handle->client->mid, handle->addr, handle->client->sum_multi_id, &h);
-    if(hret != HG_SUCCESS)
-        return ALPHA_ERR_FROM_MERCURY;
+alpha_return_t alpha_compute_accumulate_bulk(
+        alpha_resource_handle_t handle,
+        size_t count,
+        const alpha_bulk_location_t* x,
+        const alpha_bulk_location_t* y)
+{
+    alpha_request req;
+    alpha_return_t ret = alpha_accumulate_bulk_start(handle, ALPHA_DTYPE_I32, count, x, y, &req);
+    if(ret != ALPHA_SUCCESS) return ret;
+    return alpha_request_complete(&req);
+}
 
-    hret = margo_provider_forward(handle->provider_id, h, &in);
-    if(hret != HG_SUCCESS) {
-        ret = ALPHA_ERR_FROM_MERCURY;
-        goto finish;
-    }
+alpha_return_t alpha_compute_accumulate_bulk_async(
+        alpha_resource_handle_t handle,
+        size_t count,
+        const alpha_bulk_location_t* x,
+        const alpha_bulk_location_t* y,
+        alpha_request_t* req)
+{
+    alpha_request tmp;
+    alpha_return_t ret = alpha_accumulate_bulk_start(handle, ALPHA_DTYPE_I32, count, x, y, &tmp);
+    if(ret != ALPHA_SUCCESS) return ret;
+    return alpha_request_detach(&tmp, req);
+}
 
-    hret = margo_get_output(h, &out);
-    if(hret != HG_SUCCESS) {
-        ret = ALPHA_ERR_FROM_MERCURY;
-        goto finish;
-    }
+alpha_return_t alpha_compute_sum_multi_typed(
+        alpha_resource_handle_t handle,
+        alpha_dtype_t dtype,
+        size_t count,
+        const void* x,
+        const void* y,
+        void* result)
+{
+    alpha_request req;
+    alpha_return_t ret = alpha_sum_multi_typed_start(handle, dtype, count, x, y, result, &req);
+    if(ret != ALPHA_SUCCESS) return ret;
+    return alpha_request_complete(&req);
+}
 
-    ret = out.ret;
+alpha_return_t alpha_compute_sum_multi_typed_async(
+        alpha_resource_handle_t handle,
+        alpha_dtype_t dtype,
+        size_t count,
+        const void* x,
+        const void* y,
+        void* result,
+        alpha_request_t* req)
+{
+    alpha_request tmp;
+    alpha_return_t ret = alpha_sum_multi_typed_start(handle, dtype, count, x, y, result, &tmp);
+    if(ret != ALPHA_SUCCESS) return ret;
+    return alpha_request_detach(&tmp, req);
+}
 
-    margo_free_output(h, &out);
+alpha_return_t alpha_compute_sum_bulk_typed(
+        alpha_resource_handle_t handle,
+        alpha_dtype_t dtype,
+        size_t count,
+        const alpha_bulk_location_t* x,
+        const alpha_bulk_location_t* y,
+        const alpha_bulk_location_t* result)
+{
+    if(dtype > ALPHA_DTYPE_F64) return ALPHA_ERR_INVALID_ARGS;
+    alpha_request req;
+    alpha_return_t ret = alpha_sum_bulk_start(handle, dtype, count, x, y, result, &req);
+    if(ret != ALPHA_SUCCESS) return ret;
+    return alpha_request_complete(&req);
+}
+
+alpha_return_t alpha_compute_accumulate_bulk_typed(
+        alpha_resource_handle_t handle,
+        alpha_dtype_t dtype,
+        size_t count,
+        const alpha_bulk_location_t* x,
+        const alpha_bulk_location_t* y)
+{
+    if(dtype > ALPHA_DTYPE_F64) return ALPHA_ERR_INVALID_ARGS;
+    alpha_request req;
+    alpha_return_t ret = alpha_accumulate_bulk_start(handle, dtype, count, x, y, &req);
+    if(ret != ALPHA_SUCCESS) return ret;
+    return alpha_request_complete(&req);
+}
+
+alpha_return_t alpha_compute_sum_strided(
+        alpha_resource_handle_t handle,
+        alpha_dtype_t dtype,
+        size_t count,
+        const alpha_strided_location_t* x,
+        const alpha_strided_location_t* y,
+        const alpha_strided_location_t* result)
+{
+    alpha_request req;
+    alpha_return_t ret = alpha_sum_strided_start(handle, dtype, count, x, y, result, &req);
+    if(ret != ALPHA_SUCCESS) return ret;
+    return alpha_request_complete(&req);
+}
+
+alpha_return_t alpha_compute_sum_strided_async(
+        alpha_resource_handle_t handle,
+        alpha_dtype_t dtype,
+        size_t count,
+        const alpha_strided_location_t* x,
+        const alpha_strided_location_t* y,
+        const alpha_strided_location_t* result,
+        alpha_request_t* req)
+{
+    alpha_request tmp;
+    alpha_return_t ret = alpha_sum_strided_start(handle, dtype, count, x, y, result, &tmp);
+    if(ret != ALPHA_SUCCESS) return ret;
+    return alpha_request_detach(&tmp, req);
+}
+
+alpha_return_t alpha_store_array_bulk(
+        alpha_resource_handle_t handle,
+        alpha_dtype_t dtype,
+        size_t count,
+        const alpha_bulk_location_t* data,
+        uint64_t* array_id)
+{
+    if(dtype > ALPHA_DTYPE_F64 || !data || !array_id)
+        return ALPHA_ERR_INVALID_ARGS;
+    alpha_request req;
+    alpha_request_init_completed(&req, ALPHA_SUCCESS);
+    req.in.array_store.dtype = dtype;
+    req.in.array_store.count = count;
+    req.in.array_store.data  = *data;
+    req.output_fn = alpha_array_store_output;
+    req.result    = array_id;
+    alpha_return_t ret = alpha_request_forward(handle, handle->client->array_store_id, 0, &req);
+    if(ret != ALPHA_SUCCESS) return ret;
+    return alpha_request_complete(&req);
+}
+
+alpha_return_t alpha_store_array(
+        alpha_resource_handle_t handle,
+        alpha_dtype_t dtype,
+        size_t count,
+        const void* data,
+        uint64_t* array_id)
+{
+    if(dtype > ALPHA_DTYPE_F64 || count == 0)
+        return ALPHA_ERR_INVALID_ARGS;
+    alpha_bulk_location_t bl;
+    hg_bulk_t bulk = HG_BULK_NULL;
+    alpha_return_t ret = alpha_expose_array(handle->client, data,
+            count*alpha_dtype_size(dtype), HG_BULK_READ_ONLY, &bl, &bulk);
+    if(ret != ALPHA_SUCCESS) return ret;
+    ret = alpha_store_array_bulk(handle, dtype, count, &bl, array_id);
+    margo_bulk_free(bulk);
+    return ret;
+}
+
+alpha_return_t alpha_remove_array(
+        alpha_resource_handle_t handle,
+        uint64_t array_id)
+{
+    alpha_request req;
+    alpha_request_init_completed(&req, ALPHA_SUCCESS);
+    req.in.array_remove.array_id = array_id;
+    req.output_fn = alpha_array_remove_output;
+    alpha_return_t ret = alpha_request_forward(handle, handle->client->array_remove_id, 0, &req);
+    if(ret != ALPHA_SUCCESS) return ret;
+    return alpha_request_complete(&req);
+}
+
+alpha_return_t alpha_compute_sum_stored(
+        alpha_resource_handle_t handle,
+        alpha_dtype_t dtype,
+        size_t count,
+        const void* x,
+        uint64_t y_id,
+        void* result)
+{
+    alpha_request req;
+    alpha_return_t ret = alpha_sum_stored_start(handle, dtype, count, x, y_id, result, &req);
+    if(ret != ALPHA_SUCCESS) return ret;
+    return alpha_request_complete(&req);
+}
+
+alpha_return_t alpha_compute_sum_stored_async(
+        alpha_resource_handle_t handle,
+        alpha_dtype_t dtype,
+        size_t count,
+        const void* x,
+        uint64_t y_id,
+        void* result,
+        alpha_request_t* req)
+{
+    alpha_request tmp;
+    alpha_return_t ret = alpha_sum_stored_start(handle, dtype, count, x, y_id, result, &tmp);
+    if(ret != ALPHA_SUCCESS) return ret;
+    return alpha_request_detach(&tmp, req);
+}
+
+alpha_return_t alpha_compute_sum_stored_bulk(
+        alpha_resource_handle_t handle,
+        alpha_dtype_t dtype,
+        size_t count,
+        const alpha_bulk_location_t* x,
+        uint64_t y_id,
+        const alpha_bulk_location_t* result)
+{
+    alpha_request req;
+    alpha_return_t ret = alpha_sum_stored_bulk_start(handle, dtype, count, x, y_id, result, &req);
+    if(ret != ALPHA_SUCCESS) return ret;
+    return alpha_request_complete(&req);
+}
+
+alpha_return_t alpha_create_named_array(
+        alpha_resource_handle_t handle,
+        const char* name,
+        size_t count)
+{
+    if(!name) return ALPHA_ERR_INVALID_ARGS;
+    alpha_request req;
+    alpha_request_init_completed(&req, ALPHA_SUCCESS);
+    req.in.named_create.resource_id = handle->resource_id;
+    req.in.named_create.name        = (char*)name;
+    req.in.named_create.count       = count;
+    req.output_fn = alpha_named_array_output;
+    alpha_return_t ret = alpha_request_forward(handle, handle->client->named_create_id, 0, &req);
+    if(ret != ALPHA_SUCCESS) return ret;
+    return alpha_request_complete(&req);
+}
+
+static alpha_return_t alpha_named_io(
+        alpha_resource_handle_t handle,
+        const char* name,
+        bool write,
+        size_t offset,
+        size_t count,
+        void* data)
+{
+    if(!name) return ALPHA_ERR_INVALID_ARGS;
+    if(count == 0) return ALPHA_SUCCESS;
+    alpha_bulk_location_t bl;
+    hg_bulk_t bulk = HG_BULK_NULL;
+    alpha_return_t ret = alpha_expose_array(handle->client, data, count*sizeof(int32_t),
+            write ? HG_BULK_READ_ONLY : HG_BULK_WRITE_ONLY, &bl, &bulk);
+    if(ret != ALPHA_SUCCESS) return ret;
+    alpha_request req;
+    alpha_request_init_completed(&req, ALPHA_SUCCESS);
+    req.in.named_io.resource_id = handle->resource_id;
+    req.in.named_io.name        = (char*)name;
+    req.in.named_io.write       = write;
+    req.in.named_io.offset      = offset;
+    req.in.named_io.count       = count;
+    req.in.named_io.data        = bl;
+    req.output_fn = alpha_named_array_output;
+    ret = alpha_request_forward(handle, handle->client->named_io_id, 0, &req);
+    if(ret == ALPHA_SUCCESS) ret = alpha_request_complete(&req);
+    margo_bulk_free(bulk);
+    return ret;
+}
+
+alpha_return_t alpha_write_named_array(
+        alpha_resource_handle_t handle,
+        const char* name,
+        size_t offset,
+        size_t count,
+        const int32_t* data)
+{
+    return alpha_named_io(handle, name, true, offset, count, (void*)data);
+}
+
+alpha_return_t alpha_read_named_array(
+        alpha_resource_handle_t handle,
+        const char* name,
+        size_t offset,
+        size_t count,
+        int32_t* data)
+{
+    return alpha_named_io(handle, name, false, offset, count, data);
+}
+
+alpha_return_t alpha_compute_sum_named(
+        alpha_resource_handle_t handle,
+        size_t count,
+        const int32_t* x,
+        const char* y_name,
+        size_t y_offset,
+        int32_t* result)
+{
+    alpha_return_t ret    = ALPHA_SUCCESS;
+    hg_bulk_t input_bulk  = HG_BULK_NULL;
+    hg_bulk_t output_bulk = HG_BULK_NULL;
+    alpha_bulk_location_t x_bl, result_bl;
+    alpha_request req;
+
+    if(!y_name) return ALPHA_ERR_INVALID_ARGS;
+    if(count == 0) return ALPHA_SUCCESS;
+    hg_size_t size = count*sizeof(int32_t);
+
+    ret = alpha_expose_array(handle->client, x, size, HG_BULK_READ_ONLY, &x_bl, &input_bulk);
+    if(ret != ALPHA_SUCCESS) goto finish;
+    ret = alpha_expose_array(handle->client, result, size, HG_BULK_WRITE_ONLY, &result_bl, &output_bulk);
+    if(ret != ALPHA_SUCCESS) goto finish;
+
+    alpha_request_init_completed(&req, ALPHA_SUCCESS);
+    req.in.sum_named.resource_id = handle->resource_id;
+    req.in.sum_named.count       = count;
+    req.in.sum_named.x           = x_bl;
+    req.in.sum_named.y_name      = (char*)y_name;
+    req.in.sum_named.y_offset    = y_offset;
+    req.in.sum_named.result      = result_bl;
+    req.output_fn = alpha_sum_multi_output;
+    ret = alpha_request_forward(handle, handle->client->sum_named_id, 0, &req);
+    if(ret == ALPHA_SUCCESS) ret = alpha_request_complete(&req);
 
 finish:
-    margo_destroy(h);
+    margo_bulk_free(input_bulk);
+    margo_bulk_free(output_bulk);
+    return ret;
+}
+
+alpha_return_t alpha_compute_reduce_bulk(
+        alpha_resource_handle_t handle,
+        alpha_reduce_op_t op,
+        size_t count,
+        const alpha_bulk_location_t* x,
+        const alpha_bulk_location_t* y,
+        int64_t* result)
+{
+    alpha_request req;
+    alpha_return_t ret = alpha_reduce_bulk_start(handle, op, count, x, y, result, &req);
+    if(ret != ALPHA_SUCCESS) return ret;
+    return alpha_request_complete(&req);
+}
+
+alpha_return_t alpha_compute_reduce_bulk_async(
+        alpha_resource_handle_t handle,
+        alpha_reduce_op_t op,
+        size_t count,
+        const alpha_bulk_location_t* x,
+        const alpha_bulk_location_t* y,
+        int64_t* result,
+        alpha_request_t* req)
+{
+    alpha_request tmp;
+    alpha_return_t ret = alpha_reduce_bulk_start(handle, op, count, x, y, result, &tmp);
+    if(ret != ALPHA_SUCCESS) return ret;
+    return alpha_request_detach(&tmp, req);
+}
+
+alpha_return_t alpha_request_wait(alpha_request_t req)
+{
+    if(req == ALPHA_REQUEST_NULL)
+        return ALPHA_ERR_INVALID_ARGS;
+    alpha_return_t ret = alpha_request_complete(req);
+    free(req);
+    return ret;
+}
+
+alpha_return_t alpha_request_test(alpha_request_t req, int* flag)
+{
+    if(req == ALPHA_REQUEST_NULL)
+        return ALPHA_ERR_INVALID_ARGS;
+    if(req->batch) {
+        ABT_bool is_ready = ABT_FALSE;
+        int ret = ABT_eventual_test(req->batch->ev, NULL, &is_ready);
+        *flag = is_ready == ABT_TRUE;
+        return ret == ABT_SUCCESS ? ALPHA_SUCCESS : ALPHA_ERR_FROM_ARGOBOTS;
+    }
+    if(req->h == HG_HANDLE_NULL) {
+        *flag = 1;
+        return ALPHA_SUCCESS;
+    }
+    int ret = margo_test(req->req, flag);
+    return ret == 0 ? ALPHA_SUCCESS : ALPHA_ERR_FROM_ARGOBOTS;
+}
+
+alpha_return_t alpha_request_wait_any(
+        size_t count,
+        alpha_request_t* reqs,
+        size_t* index)
+{
+    /* same approach as margo_wait_any: poll the requests,
+     * yielding to other ULTs (e.g. the progress loop) between rounds */
+    while(true) {
+        bool found = false;
+        for(size_t i = 0; i < count; ++i) {
+            if(reqs[i] == ALPHA_REQUEST_NULL) continue;
+            found = true;
+            int flag = 0;
+            alpha_return_t ret = alpha_request_test(reqs[i], &flag);
+            if(ret != ALPHA_SUCCESS) return ret;
+            if(!flag) continue;
+            ret = alpha_request_wait(reqs[i]);
+            reqs[i] = ALPHA_REQUEST_NULL;
+            *index  = i;
+            return ret;
+        }
+        if(!found) return ALPHA_ERR_INVALID_ARGS;
+        ABT_thread_yield();
+    }
+}
+
+alpha_return_t alpha_request_wait_all(
+        size_t count,
+        alpha_request_t* reqs)
+{
+    alpha_return_t ret = ALPHA_SUCCESS;
+    for(size_t i = 0; i < count; ++i) {
+        if(reqs[i] == ALPHA_REQUEST_NULL) continue;
+        alpha_return_t r = alpha_request_wait(reqs[i]);
+        reqs[i] = ALPHA_REQUEST_NULL;
+        if(ret == ALPHA_SUCCESS) ret = r;
+    }
     return ret;
 }
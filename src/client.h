@@ -7,21 +7,157 @@
 #define _CLIENT_H
 
 #include "types.h"
+#include "local.h"
 #include "alpha/alpha-client.h"
 #include "alpha/alpha-resource.h"
+#include "alpha/alpha-request.h"
+
+typedef struct alpha_registered_buffer {
+    char*     base; // start of the registered memory
+    size_t    size; // size of the registered memory
+    hg_bulk_t bulk; // bulk handle exposing [base, base+size)
+} alpha_registered_buffer;
 
 typedef struct alpha_client {
    margo_instance_id mid;
    hg_id_t           sum_id;
    hg_id_t           sum_multi_id;
+   hg_id_t           accumulate_id;
+   hg_id_t           reduce_id;
+   hg_id_t           sum_strided_id;
+   hg_id_t           sum_stored_id;
+   hg_id_t           array_store_id;
+   hg_id_t           array_remove_id;
+   hg_id_t           named_create_id;
+   hg_id_t           named_io_id;
+   hg_id_t           sum_named_id;
+   hg_id_t           sum_batch_id;
+   hg_id_t           stats_id;
+   hg_id_t           shm_attach_id;
+   hg_id_t           shm_detach_id;
+   hg_id_t           sum_shm_id;
    uint64_t          num_resource_handles;
+   size_t            eager_threshold; // max count for which sum_multi data is sent inline
+   size_t            handle_cache_size; // capacity of each resource handle's handle cache
+   unsigned          max_retries; // max number of times an RPC rejected with ALPHA_ERR_BUSY is resent
+   uint64_t          retry_seed;  // state of the generator of retry jitters
+   bool              local_shortcut; // whether to call co-located providers directly
+   size_t            shm_size;       // size of the resource handles' segments (0 if disabled)
+   uint64_t          num_shm_segments; // number of segments created, used to name them
+   char*             self_addr_str; // address of the client, sent along bulk handles
+   /* buffers registered with alpha_client_register_buffer, sorted by address */
+   ABT_mutex                registered_buffers_mtx;
+   alpha_registered_buffer* registered_buffers;
+   size_t                   num_registered_buffers;
+   size_t                   registered_buffers_capacity;
 } alpha_client;
 
+typedef struct alpha_sum_batch alpha_sum_batch;
+
+typedef struct alpha_coalescer {
+    ABT_mutex        mutex;
+    size_t           max_batch_size; // 0 or 1 if coalescing is disabled
+    double           max_delay_us;   // max time a sum waits in a batch
+    alpha_sum_batch* current;        // batch being filled, if any
+} alpha_coalescer;
+
+typedef struct alpha_cached_handle {
+    hg_handle_t h;      // handle whose RPC has completed
+    hg_id_t     rpc_id; // RPC the handle was last used for
+} alpha_cached_handle;
+
+/* Free list of hg_handle_t kept by a resource handle, so that
+ * RPCs don't need a margo_create/margo_destroy each */
+typedef struct alpha_handle_cache {
+    ABT_mutex            mutex;
+    size_t               capacity;
+    size_t               size;
+    alpha_cached_handle* entries;
+} alpha_handle_cache;
+
+typedef struct alpha_shm_block {
+    size_t offset; // offset of the block in the segment
+    size_t size;   // size of the block
+} alpha_shm_block;
+
+/* Shared-memory segment of a resource handle, attached by its provider
+ * (see shm.h), with the blocks allocated in it sorted by offset */
+typedef struct alpha_shm_region {
+    char*            base; // NULL if the resource handle has no segment
+    size_t           size;
+    uint64_t         segment_id; // id of the segment in the provider
+    ABT_mutex        mutex;
+    alpha_shm_block* blocks;
+    size_t           num_blocks;
+    size_t           capacity;
+} alpha_shm_region;
+
 typedef struct alpha_resource_handle {
     alpha_client_t      client;
     hg_addr_t           addr;
     uint16_t            provider_id;
+    uint32_t            resource_id;
+    bool                is_local; // the target address is the client's own address
     uint64_t            refcount;
+    alpha_coalescer     coalescer;
+    alpha_handle_cache  handle_cache;
+    alpha_shm_region    shm;
 } alpha_resource_handle;
 
+/* Batch of scalar sums sent as a single alpha_sum_batch RPC.
+ * A batch is referenced by the requests of the sums it contains,
+ * by the ULT in charge of sending it, and by the ULT in charge of
+ * flushing it after the coalescer's delay. */
+typedef struct alpha_sum_batch {
+    alpha_resource_handle_t handle;   // resource handle (holds a reference)
+    size_t                  count;    // number of sums in the batch
+    size_t                  capacity; // max number of sums in the batch
+    int32_t*                x;
+    int32_t*                y;
+    int32_t**               results;  // where to place the result of each sum
+    alpha_return_t          ret;      // return value of the RPC
+    ABT_eventual            ev;       // set when the RPC has completed
+    uint64_t                refcount;
+} alpha_sum_batch;
+
+typedef struct alpha_request alpha_request;
+
+/* Function called when the RPC of a request has completed,
+ * to deserialize its output and set the caller's results */
+typedef alpha_return_t (*alpha_request_output_fn)(alpha_request*);
+
+typedef struct alpha_request {
+    alpha_resource_handle_t handle;    // resource handle (holds a reference if h is set)
+    hg_id_t                 rpc_id;    // RPC h was created for
+    hg_handle_t             h;         // handle of the RPC in flight (may be NULL)
+    margo_request           req;       // margo request of the RPC in flight
+    /* input of the RPC in flight, kept to resend it if the provider is busy */
+    union {
+        sum_in_t       sum;
+        sum_multi_in_t sum_multi;
+        accumulate_in_t accumulate;
+        reduce_in_t    reduce;
+        sum_strided_in_t sum_strided;
+        sum_stored_in_t  sum_stored;
+        array_store_in_t array_store;
+        array_remove_in_t array_remove;
+        named_create_in_t named_create;
+        named_io_in_t    named_io;
+        sum_named_in_t   sum_named;
+        sum_batch_in_t sum_batch;
+        sum_shm_in_t   sum_shm;
+    } in;
+    double                  timeout_ms;     // timeout of each attempt (0 for none)
+    uint32_t                retry_after_ms; // delay suggested along with ALPHA_ERR_BUSY
+    unsigned                num_retries;    // number of times the RPC has been resent
+    alpha_request_output_fn output_fn; // function processing the output
+    void*                   result;    // where to place the result
+    size_t                  count;     // number of elements expected in the result
+    hg_bulk_t               bulks[2];  // temporary bulk handles to free on completion
+    alpha_sum_batch*        batch;     // batch the request belongs to, if coalesced
+    void*                   shm_staging; // block of the handle's segment to free on completion
+    const int32_t*          shm_result;  // result in the segment, to copy to result
+    alpha_return_t          ret;       // return value if h and batch are NULL
+} alpha_request;
+
 #endif
@@ -8,9 +8,18 @@
 #include "alpha/alpha-backend.h"
 #include "../provider.h"
 #include "dummy-backend.h"
+#include "dummy-kernels.h"
+
+/* The dummy backend accepts an optional "sum_delay_ms" field in its
+ * configuration, making each scalar sum sleep for that long, so that
+ * tests can keep an RPC in flight for a known amount of time. */
 
 typedef struct dummy_context {
+    margo_instance_id   mid;
     struct json_object* config;
+    double              sum_delay_ms;
+    dummy_sum_kernel_fn sum_kernel; // kernel selected for the current CPU
+    dummy_reduce_kernels reduce_kernels;
     /* ... */
 } dummy_context;
 
@@ -43,8 +52,23 @@ static alpha_return_t dummy_create_resource(
         config = json_object_new_object();
     }
 
+    struct json_object* sum_delay_ms = json_object_object_get(config, "sum_delay_ms");
+    if (sum_delay_ms && !json_object_is_type(sum_delay_ms, json_type_int)
+                     && !json_object_is_type(sum_delay_ms, json_type_double)) {
+        margo_error(mid, "\"sum_delay_ms\" field in dummy configuration should be a number");
+        json_object_put(config);
+        return ALPHA_ERR_INVALID_CONFIG;
+    }
+
     dummy_context* ctx = (dummy_context*)calloc(1, sizeof(*ctx));
+    ctx->mid    = mid;
     ctx->config = config;
+    if (sum_delay_ms) ctx->sum_delay_ms = json_object_get_double(sum_delay_ms);
+    const char* kernel_name = NULL;
+    ctx->sum_kernel = dummy_select_sum_kernel(&kernel_name);
+    margo_debug(mid, "Dummy backend using %s sum kernel", kernel_name);
+    dummy_select_reduce_kernels(&ctx->reduce_kernels, &kernel_name);
+    margo_debug(mid, "Dummy backend using %s reduce kernels", kernel_name);
     *context = (void*)ctx;
     return ALPHA_SUCCESS;
 }
@@ -65,10 +89,37 @@ static char* dummy_get_config(void* ctx)
 
 static int32_t dummy_compute_sum(void* ctx, int32_t x, int32_t y)
 {
-    (void)ctx;
+    dummy_context* context = (dummy_context*)ctx;
+    if (context->sum_delay_ms > 0)
+        margo_thread_sleep(context->mid, context->sum_delay_ms);
     return x+y;
 }
 
+static void dummy_compute_sum_batch(
+        void* ctx, size_t count, const int32_t* x, const int32_t* y, int32_t* r)
+{
+    dummy_context* context = (dummy_context*)ctx;
+    context->sum_kernel(count, x, y, r);
+}
+
+static int64_t dummy_compute_reduce(
+        void* ctx, alpha_reduce_op_t op, size_t count, const int32_t* x)
+{
+    dummy_context* context = (dummy_context*)ctx;
+    switch(op) {
+    case ALPHA_REDUCE_MIN: return context->reduce_kernels.min(count, x);
+    case ALPHA_REDUCE_MAX: return context->reduce_kernels.max(count, x);
+    default:               return context->reduce_kernels.sum(count, x);
+    }
+}
+
+static int64_t dummy_compute_dot(
+        void* ctx, size_t count, const int32_t* x, const int32_t* y)
+{
+    dummy_context* context = (dummy_context*)ctx;
+    return context->reduce_kernels.dot(count, x, y);
+}
+
 static alpha_backend_impl dummy_backend = {
     .name             = "dummy",
 
@@ -76,7 +127,10 @@ static alpha_backend_impl dummy_backend = {
     .destroy_resource = dummy_destroy_resource,
     .get_config       = dummy_get_config,
 
-    .sum              = dummy_compute_sum
+    .sum              = dummy_compute_sum,
+    .sum_batch        = dummy_compute_sum_batch,
+    .reduce           = dummy_compute_reduce,
+    .dot              = dummy_compute_dot
 };
 
 alpha_return_t alpha_register_dummy_backend(void)
@@ -0,0 +1,228 @@
+/*
+ * (C) 2020 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#include "dummy-kernels.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define DUMMY_HAVE_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+// Note: additions are done on unsigned integers so that overflows
+// wrap around the same way in the scalar and in the SIMD kernels.
+
+static int64_t reduce_sum_kernel_scalar(size_t count, const int32_t* x)
+{
+    uint64_t s = 0;
+    for(size_t i = 0; i < count; ++i)
+        s += (uint64_t)(int64_t)x[i];
+    return (int64_t)s;
+}
+
+static int32_t reduce_min_kernel_scalar(size_t count, const int32_t* x)
+{
+    int32_t m = INT32_MAX;
+    for(size_t i = 0; i < count; ++i)
+        m = x[i] < m ? x[i] : m;
+    return m;
+}
+
+static int32_t reduce_max_kernel_scalar(size_t count, const int32_t* x)
+{
+    int32_t m = INT32_MIN;
+    for(size_t i = 0; i < count; ++i)
+        m = x[i] > m ? x[i] : m;
+    return m;
+}
+
+static int64_t dot_kernel_scalar(size_t count, const int32_t* x, const int32_t* y)
+{
+    uint64_t s = 0;
+    for(size_t i = 0; i < count; ++i)
+        s += (uint64_t)((int64_t)x[i]*(int64_t)y[i]);
+    return (int64_t)s;
+}
+
+static void sum_kernel_scalar(
+        size_t count, const int32_t* x, const int32_t* y, int32_t* r)
+{
+    for(size_t i = 0; i < count; ++i)
+        r[i] = (int32_t)((uint32_t)x[i] + (uint32_t)y[i]);
+}
+
+#ifdef DUMMY_HAVE_X86_KERNELS
+
+__attribute__((target("sse4.2")))
+static void sum_kernel_sse42(
+        size_t count, const int32_t* x, const int32_t* y, int32_t* r)
+{
+    size_t i = 0;
+    for(; i + 4 <= count; i += 4) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(x + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(y + i));
+        _mm_storeu_si128((__m128i*)(r + i), _mm_add_epi32(a, b));
+    }
+    sum_kernel_scalar(count - i, x + i, y + i, r + i);
+}
+
+__attribute__((target("avx2")))
+static void sum_kernel_avx2(
+        size_t count, const int32_t* x, const int32_t* y, int32_t* r)
+{
+    size_t i = 0;
+    for(; i + 16 <= count; i += 16) {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(x + i));
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)(y + i));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(x + i + 8));
+        __m256i b1 = _mm256_loadu_si256((const __m256i*)(y + i + 8));
+        _mm256_storeu_si256((__m256i*)(r + i), _mm256_add_epi32(a0, b0));
+        _mm256_storeu_si256((__m256i*)(r + i + 8), _mm256_add_epi32(a1, b1));
+    }
+    for(; i + 8 <= count; i += 8) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(x + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(y + i));
+        _mm256_storeu_si256((__m256i*)(r + i), _mm256_add_epi32(a, b));
+    }
+    sum_kernel_scalar(count - i, x + i, y + i, r + i);
+}
+
+__attribute__((target("avx512f")))
+static void sum_kernel_avx512(
+        size_t count, const int32_t* x, const int32_t* y, int32_t* r)
+{
+    size_t i = 0;
+    for(; i + 16 <= count; i += 16) {
+        __m512i a = _mm512_loadu_si512((const void*)(x + i));
+        __m512i b = _mm512_loadu_si512((const void*)(y + i));
+        _mm512_storeu_si512((void*)(r + i), _mm512_add_epi32(a, b));
+    }
+    if(i < count) {
+        __mmask16 mask = (__mmask16)((1u << (count - i)) - 1);
+        __m512i a = _mm512_maskz_loadu_epi32(mask, (const void*)(x + i));
+        __m512i b = _mm512_maskz_loadu_epi32(mask, (const void*)(y + i));
+        _mm512_mask_storeu_epi32((void*)(r + i), mask, _mm512_add_epi32(a, b));
+    }
+}
+
+/* Adds the four 64-bit lanes of v */
+__attribute__((target("avx2")))
+static inline uint64_t hsum_epi64_avx2(__m256i v)
+{
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, v);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+__attribute__((target("avx2")))
+static int64_t reduce_sum_kernel_avx2(size_t count, const int32_t* x)
+{
+    /* elements are sign-extended to 64 bits before being added */
+    __m256i s0 = _mm256_setzero_si256();
+    __m256i s1 = _mm256_setzero_si256();
+    size_t i = 0;
+    for(; i + 8 <= count; i += 8) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(x + i));
+        s0 = _mm256_add_epi64(s0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(a)));
+        s1 = _mm256_add_epi64(s1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(a, 1)));
+    }
+    uint64_t s = hsum_epi64_avx2(_mm256_add_epi64(s0, s1));
+    return (int64_t)(s + (uint64_t)reduce_sum_kernel_scalar(count - i, x + i));
+}
+
+__attribute__((target("avx2")))
+static int32_t reduce_min_kernel_avx2(size_t count, const int32_t* x)
+{
+    __m256i m0 = _mm256_set1_epi32(INT32_MAX);
+    __m256i m1 = m0;
+    size_t i = 0;
+    for(; i + 16 <= count; i += 16) {
+        m0 = _mm256_min_epi32(m0, _mm256_loadu_si256((const __m256i*)(x + i)));
+        m1 = _mm256_min_epi32(m1, _mm256_loadu_si256((const __m256i*)(x + i + 8)));
+    }
+    int32_t lanes[8];
+    _mm256_storeu_si256((__m256i*)lanes, _mm256_min_epi32(m0, m1));
+    int32_t m = reduce_min_kernel_scalar(8, lanes);
+    int32_t t = reduce_min_kernel_scalar(count - i, x + i);
+    return t < m ? t : m;
+}
+
+__attribute__((target("avx2")))
+static int32_t reduce_max_kernel_avx2(size_t count, const int32_t* x)
+{
+    __m256i m0 = _mm256_set1_epi32(INT32_MIN);
+    __m256i m1 = m0;
+    size_t i = 0;
+    for(; i + 16 <= count; i += 16) {
+        m0 = _mm256_max_epi32(m0, _mm256_loadu_si256((const __m256i*)(x + i)));
+        m1 = _mm256_max_epi32(m1, _mm256_loadu_si256((const __m256i*)(x + i + 8)));
+    }
+    int32_t lanes[8];
+    _mm256_storeu_si256((__m256i*)lanes, _mm256_max_epi32(m0, m1));
+    int32_t m = reduce_max_kernel_scalar(8, lanes);
+    int32_t t = reduce_max_kernel_scalar(count - i, x + i);
+    return t > m ? t : m;
+}
+
+__attribute__((target("avx2")))
+static int64_t dot_kernel_avx2(size_t count, const int32_t* x, const int32_t* y)
+{
+    /* _mm256_mul_epi32 multiplies the even 32-bit lanes into 64-bit
+     * products, the odd lanes are shifted into even positions first */
+    __m256i s0 = _mm256_setzero_si256();
+    __m256i s1 = _mm256_setzero_si256();
+    size_t i = 0;
+    for(; i + 8 <= count; i += 8) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(x + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(y + i));
+        s0 = _mm256_add_epi64(s0, _mm256_mul_epi32(a, b));
+        s1 = _mm256_add_epi64(s1, _mm256_mul_epi32(_mm256_srli_epi64(a, 32),
+                                                   _mm256_srli_epi64(b, 32)));
+    }
+    uint64_t s = hsum_epi64_avx2(_mm256_add_epi64(s0, s1));
+    return (int64_t)(s + (uint64_t)dot_kernel_scalar(count - i, x + i, y + i));
+}
+
+#endif
+
+void dummy_select_reduce_kernels(dummy_reduce_kernels* kernels, const char** name)
+{
+#ifdef DUMMY_HAVE_X86_KERNELS
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")) {
+        kernels->sum = reduce_sum_kernel_avx2;
+        kernels->min = reduce_min_kernel_avx2;
+        kernels->max = reduce_max_kernel_avx2;
+        kernels->dot = dot_kernel_avx2;
+        if(name) *name = "avx2";
+        return;
+    }
+#endif
+    kernels->sum = reduce_sum_kernel_scalar;
+    kernels->min = reduce_min_kernel_scalar;
+    kernels->max = reduce_max_kernel_scalar;
+    kernels->dot = dot_kernel_scalar;
+    if(name) *name = "scalar";
+}
+
+dummy_sum_kernel_fn dummy_select_sum_kernel(const char** name)
+{
+#ifdef DUMMY_HAVE_X86_KERNELS
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f")) {
+        if(name) *name = "avx512";
+        return sum_kernel_avx512;
+    }
+    if(__builtin_cpu_supports("avx2")) {
+        if(name) *name = "avx2";
+        return sum_kernel_avx2;
+    }
+    if(__builtin_cpu_supports("sse4.2")) {
+        if(name) *name = "sse4.2";
+        return sum_kernel_sse42;
+    }
+#endif
+    if(name) *name = "scalar";
+    return sum_kernel_scalar;
+}
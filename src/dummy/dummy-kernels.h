@@ -0,0 +1,49 @@
+/*
+ * (C) 2020 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef _DUMMY_KERNELS_H
+#define _DUMMY_KERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Kernel computing r[i] = x[i] + y[i] for i in [0, count).
+ * r may alias x or y.
+ */
+typedef void (*dummy_sum_kernel_fn)(size_t, const int32_t*, const int32_t*, int32_t*);
+
+/**
+ * @brief Returns the fastest sum kernel supported by the CPU
+ * the process is running on (AVX-512, AVX2, SSE4.2, or scalar).
+ *
+ * @param[out] name if not NULL, set to the name of the selected kernel.
+ *
+ * @return a sum kernel (never NULL).
+ */
+dummy_sum_kernel_fn dummy_select_sum_kernel(const char** name);
+
+/**
+ * @brief Kernels reducing arrays to a single value. Sums and dot products
+ * are computed on 64 bits, wrapping around on overflow. min and max return
+ * INT32_MAX and INT32_MIN respectively for empty arrays.
+ */
+typedef struct dummy_reduce_kernels {
+    int64_t (*sum)(size_t, const int32_t*);
+    int32_t (*min)(size_t, const int32_t*);
+    int32_t (*max)(size_t, const int32_t*);
+    int64_t (*dot)(size_t, const int32_t*, const int32_t*);
+} dummy_reduce_kernels;
+
+/**
+ * @brief Selects the fastest reduction kernels supported by the CPU
+ * the process is running on (AVX2 or scalar).
+ *
+ * @param[out] kernels selected kernels.
+ * @param[out] name if not NULL, set to the name of the selected kernels.
+ */
+void dummy_select_reduce_kernels(dummy_reduce_kernels* kernels, const char** name);
+
+#endif
@@ -0,0 +1,289 @@
+/*
+ * (C) 2020 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <json-c/json.h>
+#include "alpha/alpha-backend.h"
+#include "../provider.h"
+#include "../typed-kernels.h"
+#include "files-backend.h"
+
+/* The "files" backend keeps named arrays of int32_t in files of a directory,
+ * e.g. { "path": "/scratch/alpha" }, an array named "foo" being stored in
+ * the file "foo.i32" in native byte order. Files are memory-mapped the first
+ * time their array is used, so that arrays larger than memory are paged in
+ * on demand and a restarted provider serves its arrays without loading them. */
+
+#define FILES_SUFFIX ".i32"
+
+typedef struct files_array {
+    char*               name;
+    int32_t*            data;
+    size_t              count;
+    struct files_array* next;
+} files_array;
+
+typedef struct files_context {
+    margo_instance_id mid;
+    char*             path;
+    ABT_mutex         mutex;
+    files_array*      arrays; // arrays mapped so far
+} files_context;
+
+static alpha_return_t files_create_resource(
+        margo_instance_id mid,
+        alpha_provider_t provider,
+        const char* config_str,
+        void** context)
+{
+    (void)provider;
+    struct json_object* config = NULL;
+
+    // read JSON config from provided string argument
+    if (config_str) {
+        struct json_tokener*    tokener = json_tokener_new();
+        enum json_tokener_error jerr;
+        config = json_tokener_parse_ex(
+                tokener, config_str,
+                strlen(config_str));
+        if (!config) {
+            jerr = json_tokener_get_error(tokener);
+            margo_error(mid, "JSON parse error: %s",
+                      json_tokener_error_desc(jerr));
+            json_tokener_free(tokener);
+            return ALPHA_ERR_INVALID_CONFIG;
+        }
+        json_tokener_free(tokener);
+    }
+
+    struct json_object* path = config ? json_object_object_get(config, "path") : NULL;
+    if (!path || !json_object_is_type(path, json_type_string)) {
+        margo_error(mid, "Files backend needs a \"path\" field (string) in its configuration");
+        json_object_put(config);
+        return ALPHA_ERR_INVALID_CONFIG;
+    }
+    const char* path_str = json_object_get_string(path);
+
+    // create the directory if it doesn't exist
+    struct stat st;
+    if (mkdir(path_str, 0755) != 0 && errno != EEXIST) {
+        margo_error(mid, "Could not create directory %s (%s)", path_str, strerror(errno));
+        json_object_put(config);
+        return ALPHA_ERR_INVALID_CONFIG;
+    }
+    if (stat(path_str, &st) != 0 || !S_ISDIR(st.st_mode)) {
+        margo_error(mid, "%s is not a directory", path_str);
+        json_object_put(config);
+        return ALPHA_ERR_INVALID_CONFIG;
+    }
+
+    files_context* ctx = (files_context*)calloc(1, sizeof(*ctx));
+    if (ctx) ctx->path = strdup(path_str);
+    json_object_put(config);
+    if (!ctx || !ctx->path) {
+        free(ctx);
+        return ALPHA_ERR_ALLOCATION;
+    }
+    ctx->mid = mid;
+    ABT_mutex_create(&ctx->mutex);
+    *context = (void*)ctx;
+    return ALPHA_SUCCESS;
+}
+
+static alpha_return_t files_destroy_resource(void* ctx)
+{
+    files_context* context = (files_context*)ctx;
+    // the kernel writes the modified pages back to the files
+    while (context->arrays) {
+        files_array* array = context->arrays;
+        context->arrays = array->next;
+        munmap(array->data, array->count*sizeof(int32_t));
+        free(array->name);
+        free(array);
+    }
+    ABT_mutex_free(&context->mutex);
+    free(context->path);
+    free(context);
+    return ALPHA_SUCCESS;
+}
+
+static char* files_get_config(void* ctx)
+{
+    files_context* context = (files_context*)ctx;
+    struct json_object* config = json_object_new_object();
+    json_object_object_add(config, "path", json_object_new_string(context->path));
+    char* result = strdup(json_object_to_json_string(config));
+    json_object_put(config);
+    return result;
+}
+
+static int32_t files_compute_sum(void* ctx, int32_t x, int32_t y)
+{
+    (void)ctx;
+    return (int32_t)((uint32_t)x + (uint32_t)y);
+}
+
+static void files_compute_sum_batch(
+        void* ctx, size_t count, const int32_t* x, const int32_t* y, int32_t* r)
+{
+    (void)ctx;
+    alpha_typed_sum(ALPHA_DTYPE_I32, count, x, y, r);
+}
+
+/* Names are used as file names, hence restricted to
+ * letters, digits, '_', '-', and '.' (except first) */
+static bool files_valid_name(const char* name)
+{
+    size_t len = strlen(name);
+    if (len == 0 || len > NAME_MAX - strlen(FILES_SUFFIX) || name[0] == '.')
+        return false;
+    for (size_t i = 0; i < len; ++i) {
+        char c = name[i];
+        if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')
+           || (c >= '0' && c <= '9') || c == '_' || c == '-' || c == '.'))
+            return false;
+    }
+    return true;
+}
+
+/* must be called with the mutex locked */
+static files_array* files_lookup(files_context* context, const char* name)
+{
+    files_array* array = context->arrays;
+    while (array && strcmp(array->name, name) != 0) array = array->next;
+    return array;
+}
+
+/* Maps the file of an array, creating it with count elements if create
+ * is true. Must be called with the mutex locked. */
+static alpha_return_t files_map(
+        files_context* context, const char* name,
+        bool create, size_t count, files_array** result)
+{
+    char filename[PATH_MAX];
+    if (snprintf(filename, sizeof(filename), "%s/%s%s",
+                 context->path, name, FILES_SUFFIX) >= (int)sizeof(filename))
+        return ALPHA_ERR_INVALID_ARGS;
+
+    int fd = open(filename, O_RDWR | (create ? O_CREAT | O_EXCL : 0), 0644);
+    if (fd < 0) {
+        if (create && errno == EEXIST) return ALPHA_ERR_INVALID_ARGS;
+        if (!create && errno == ENOENT) return ALPHA_ERR_INVALID_ARRAY;
+        margo_error(context->mid, "Could not open %s (%s)", filename, strerror(errno));
+        return ALPHA_ERR_OTHER;
+    }
+    size_t size = count*sizeof(int32_t);
+    if (create && ftruncate(fd, (off_t)size) != 0) {
+        margo_error(context->mid, "Could not resize %s (%s)", filename, strerror(errno));
+        close(fd);
+        unlink(filename);
+        return ALPHA_ERR_OTHER;
+    }
+    if (!create) {
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0 || st.st_size % sizeof(int32_t)) {
+            margo_error(context->mid, "%s is not a valid array file", filename);
+            close(fd);
+            return ALPHA_ERR_OTHER;
+        }
+        size  = (size_t)st.st_size;
+        count = size / sizeof(int32_t);
+    }
+    void* data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        margo_error(context->mid, "Could not map %s (%s)", filename, strerror(errno));
+        if (create) unlink(filename);
+        return ALPHA_ERR_OTHER;
+    }
+    /* arrays are mostly streamed through, so let the
+     * kernel read ahead aggressively and drop pages early */
+    madvise(data, size, MADV_SEQUENTIAL);
+
+    files_array* array = (files_array*)calloc(1, sizeof(*array));
+    if (array) array->name = strdup(name);
+    if (!array || !array->name) {
+        free(array);
+        munmap(data, size);
+        return ALPHA_ERR_ALLOCATION;
+    }
+    array->data  = (int32_t*)data;
+    array->count = count;
+    array->next  = context->arrays;
+    context->arrays = array;
+    *result = array;
+    return ALPHA_SUCCESS;
+}
+
+static alpha_return_t files_create_array(
+        void* ctx, const char* name, size_t count, int32_t** data)
+{
+    files_context* context = (files_context*)ctx;
+    if (!files_valid_name(name) || count == 0 || count > SIZE_MAX / sizeof(int32_t))
+        return ALPHA_ERR_INVALID_ARGS;
+    alpha_return_t ret = ALPHA_ERR_INVALID_ARGS;
+    files_array* array = NULL;
+    ABT_mutex_lock(context->mutex);
+    if (!files_lookup(context, name))
+        ret = files_map(context, name, true, count, &array);
+    ABT_mutex_unlock(context->mutex);
+    if (ret == ALPHA_SUCCESS) *data = array->data;
+    return ret;
+}
+
+static alpha_return_t files_find_array(
+        void* ctx, const char* name, int32_t** data, size_t* count)
+{
+    files_context* context = (files_context*)ctx;
+    if (!files_valid_name(name))
+        return ALPHA_ERR_INVALID_ARRAY;
+    alpha_return_t ret = ALPHA_SUCCESS;
+    ABT_mutex_lock(context->mutex);
+    files_array* array = files_lookup(context, name);
+    if (!array)
+        ret = files_map(context, name, false, 0, &array);
+    ABT_mutex_unlock(context->mutex);
+    if (ret != ALPHA_SUCCESS) return ret;
+    *data  = array->data;
+    *count = array->count;
+    return ALPHA_SUCCESS;
+}
+
+static void files_prefetch(void* ctx, const int32_t* data, size_t count)
+{
+    (void)ctx;
+    if (count == 0) return;
+    uintptr_t page  = (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t start = (uintptr_t)data & ~(page - 1);
+    uintptr_t end   = (uintptr_t)(data + count);
+    madvise((void*)start, end - start, MADV_WILLNEED);
+}
+
+static alpha_backend_impl files_backend = {
+    .name             = "files",
+
+    .create_resource  = files_create_resource,
+    .destroy_resource = files_destroy_resource,
+    .get_config       = files_get_config,
+
+    .sum              = files_compute_sum,
+    .sum_batch        = files_compute_sum_batch,
+
+    .create_array     = files_create_array,
+    .find_array       = files_find_array,
+    .prefetch         = files_prefetch
+};
+
+alpha_return_t alpha_register_files_backend(void)
+{
+    return alpha_register_backend(&files_backend);
+}
@@ -0,0 +1,13 @@
+/*
+ * (C) 2020 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef _FILES_BACKEND_H
+#define _FILES_BACKEND_H
+
+#include "alpha/alpha-server.h"
+
+alpha_return_t alpha_register_files_backend(void);
+
+#endif
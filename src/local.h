@@ -0,0 +1,40 @@
+/*
+ * (C) 2020 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef _LOCAL_H
+#define _LOCAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "alpha/alpha-common.h"
+
+/* Name of the RPC a provider registers (without handler) to expose its
+ * local operations. Its registered data is an alpha_local_ops structure,
+ * which a client sharing the provider's margo instance finds with
+ * margo_provider_registered_name and margo_registered_data. This way the
+ * client library calls into the provider without linking against the
+ * server library. */
+#define ALPHA_LOCAL_RPC_NAME "alpha_local"
+
+typedef struct alpha_local_ops {
+    /* Passed to the operations below. It remains valid until the margo
+     * instance is finalized, even if the provider is destroyed in the
+     * meantime, in which case the operations return
+     * ALPHA_ERR_INVALID_PROVIDER. A provider being destroyed waits for
+     * the operations in progress to complete. */
+    void* context;
+    /* Computes result[i] = x[i] + y[i] directly on the caller's arrays,
+     * in a ULT of the provider's pool. Sets retry_after_ms along with
+     * ALPHA_ERR_BUSY, as the corresponding RPC would. */
+    alpha_return_t (*sum_multi)(void* context,
+                                uint32_t resource_id,
+                                size_t count,
+                                const int32_t* x,
+                                const int32_t* y,
+                                int32_t* result,
+                                uint32_t* retry_after_ms);
+} alpha_local_ops;
+
+#endif
@@ -0,0 +1,165 @@
+/*
+ * (C) 2020 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "metrics.h"
+
+static const char* const rpc_names[ALPHA_METRICS_NUM_RPCS] = {
+    "sum", "sum_multi", "sum_batch", "accumulate", "reduce", "sum_strided",
+    "sum_stored", "sum_named", "sum_shm"
+};
+
+static const char* const phase_names[ALPHA_METRICS_NUM_PHASES] = {
+    "deserialize", "queue", "addr_lookup", "bulk_pull", "compute", "bulk_push", "respond"
+};
+
+static const char* const return_names[] = {
+    "ALPHA_SUCCESS",
+    "ALPHA_TIMEOUT",
+    "ALPHA_ERR_ALLOCATION",
+    "ALPHA_ERR_INVALID_ARGS",
+    "ALPHA_ERR_INVALID_PROVIDER",
+    "ALPHA_ERR_INVALID_RESOURCE",
+    "ALPHA_ERR_INVALID_BACKEND",
+    "ALPHA_ERR_INVALID_CONFIG",
+    "ALPHA_ERR_INVALID_TOKEN",
+    "ALPHA_ERR_FROM_MERCURY",
+    "ALPHA_ERR_FROM_ARGOBOTS",
+    "ALPHA_ERR_OP_UNSUPPORTED",
+    "ALPHA_ERR_OP_FORBIDDEN",
+    "ALPHA_ERR_BUSY",
+    "ALPHA_ERR_INVALID_ARRAY",
+    "ALPHA_ERR_OTHER"
+};
+_Static_assert(sizeof(return_names)/sizeof(return_names[0]) == ALPHA_ERR_OTHER + 1,
+               "return_names should have one entry per alpha_return_t value");
+
+#define SUB_BUCKETS (1 << ALPHA_HISTOGRAM_SUB_BITS)
+
+static inline size_t bucket_index(uint64_t value)
+{
+    if(value < SUB_BUCKETS) return (size_t)value;
+    int e = 63 - __builtin_clzll(value);
+    if(e > ALPHA_HISTOGRAM_MAX_EXP) return ALPHA_HISTOGRAM_NUM_BUCKETS - 1;
+    size_t sub = (size_t)(value >> (e - ALPHA_HISTOGRAM_SUB_BITS)) & (SUB_BUCKETS - 1);
+    return ((size_t)(e - ALPHA_HISTOGRAM_SUB_BITS + 1) << ALPHA_HISTOGRAM_SUB_BITS) + sub;
+}
+
+static inline uint64_t bucket_lower_bound(size_t index)
+{
+    if(index < SUB_BUCKETS) return index;
+    int e = (int)(index >> ALPHA_HISTOGRAM_SUB_BITS) + ALPHA_HISTOGRAM_SUB_BITS - 1;
+    uint64_t sub = index & (SUB_BUCKETS - 1);
+    return (SUB_BUCKETS + sub) << (e - ALPHA_HISTOGRAM_SUB_BITS);
+}
+
+static inline uint64_t bucket_upper_bound(size_t index)
+{
+    if(index < SUB_BUCKETS) return index;
+    return bucket_lower_bound(index + 1) - 1;
+}
+
+alpha_metrics* alpha_metrics_create(void)
+{
+    return (alpha_metrics*)calloc(1, sizeof(alpha_metrics));
+}
+
+void alpha_metrics_destroy(alpha_metrics* metrics)
+{
+    free(metrics);
+}
+
+void alpha_histogram_record(alpha_histogram* histogram, uint64_t value)
+{
+    __atomic_add_fetch(&histogram->count, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&histogram->sum, value, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&histogram->buckets[bucket_index(value)], 1, __ATOMIC_RELAXED);
+    uint64_t max = __atomic_load_n(&histogram->max, __ATOMIC_RELAXED);
+    while(value > max
+       && !__atomic_compare_exchange_n(&histogram->max, &max, value, true,
+                                       __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+/* Converts a histogram into JSON. Since the histogram may be updated
+ * concurrently, its buckets are first copied and the percentiles are
+ * computed from the copy. */
+static struct json_object* histogram_to_json(alpha_histogram* histogram)
+{
+    static const double percentiles[] = { 50.0, 90.0, 99.0, 99.9 };
+    static const char* const percentile_names[] = { "p50", "p90", "p99", "p999" };
+
+    uint64_t buckets[ALPHA_HISTOGRAM_NUM_BUCKETS];
+    uint64_t count = 0;
+    for(size_t i = 0; i < ALPHA_HISTOGRAM_NUM_BUCKETS; ++i) {
+        buckets[i] = __atomic_load_n(&histogram->buckets[i], __ATOMIC_RELAXED);
+        count += buckets[i];
+    }
+    uint64_t sum = __atomic_load_n(&histogram->sum, __ATOMIC_RELAXED);
+    uint64_t max = __atomic_load_n(&histogram->max, __ATOMIC_RELAXED);
+
+    struct json_object* result = json_object_new_object();
+    json_object_object_add(result, "count", json_object_new_int64((int64_t)count));
+    if(count == 0) return result;
+    json_object_object_add(result, "mean_ns", json_object_new_double((double)sum/count));
+    json_object_object_add(result, "max_ns", json_object_new_int64((int64_t)max));
+
+    /* percentiles are reported as the upper bound of their bucket */
+    size_t p = 0;
+    uint64_t seen = 0;
+    for(size_t i = 0; i < ALPHA_HISTOGRAM_NUM_BUCKETS && p < 4; ++i) {
+        seen += buckets[i];
+        while(p < 4 && seen >= percentiles[p]*count/100.0) {
+            uint64_t v = bucket_upper_bound(i);
+            if(v > max) v = max;
+            char name[16];
+            snprintf(name, sizeof(name), "%s_ns", percentile_names[p]);
+            json_object_object_add(result, name, json_object_new_int64((int64_t)v));
+            p += 1;
+        }
+    }
+
+    struct json_object* jbuckets = json_object_new_object();
+    for(size_t i = 0; i < ALPHA_HISTOGRAM_NUM_BUCKETS; ++i) {
+        if(!buckets[i]) continue;
+        char key[24];
+        snprintf(key, sizeof(key), "%llu", (unsigned long long)bucket_lower_bound(i));
+        json_object_object_add(jbuckets, key, json_object_new_int64((int64_t)buckets[i]));
+    }
+    json_object_object_add(result, "buckets", jbuckets);
+    return result;
+}
+
+struct json_object* alpha_metrics_to_json(alpha_metrics* metrics)
+{
+    struct json_object* result = json_object_new_object();
+    json_object_object_add(result, "bytes_pulled", json_object_new_int64(
+        (int64_t)__atomic_load_n(&metrics->bytes_pulled, __ATOMIC_RELAXED)));
+    json_object_object_add(result, "bytes_pushed", json_object_new_int64(
+        (int64_t)__atomic_load_n(&metrics->bytes_pushed, __ATOMIC_RELAXED)));
+
+    struct json_object* rpcs = json_object_new_object();
+    json_object_object_add(result, "rpcs", rpcs);
+    for(size_t r = 0; r < ALPHA_METRICS_NUM_RPCS; ++r) {
+        alpha_rpc_metrics* m = &metrics->rpcs[r];
+        struct json_object* rpc = json_object_new_object();
+        json_object_object_add(rpcs, rpc_names[r], rpc);
+        json_object_object_add(rpc, "calls", json_object_new_int64(
+            (int64_t)__atomic_load_n(&m->calls, __ATOMIC_RELAXED)));
+        struct json_object* errors = json_object_new_object();
+        json_object_object_add(rpc, "errors", errors);
+        for(size_t e = 0; e <= ALPHA_ERR_OTHER; ++e) {
+            uint64_t n = __atomic_load_n(&m->errors[e], __ATOMIC_RELAXED);
+            if(n) json_object_object_add(errors, return_names[e], json_object_new_int64((int64_t)n));
+        }
+        struct json_object* phases = json_object_new_object();
+        json_object_object_add(rpc, "phases", phases);
+        for(size_t ph = 0; ph < ALPHA_METRICS_NUM_PHASES; ++ph) {
+            if(__atomic_load_n(&m->phases[ph].count, __ATOMIC_RELAXED) == 0) continue;
+            json_object_object_add(phases, phase_names[ph], histogram_to_json(&m->phases[ph]));
+        }
+    }
+    return result;
+}
@@ -0,0 +1,192 @@
+/*
+ * (C) 2020 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef _METRICS_H
+#define _METRICS_H
+
+#include <stdint.h>
+#include <time.h>
+#include <json-c/json.h>
+#include "alpha/alpha-common.h"
+
+/* RPCs for which the provider collects metrics */
+typedef enum alpha_metrics_rpc {
+    ALPHA_METRICS_SUM,
+    ALPHA_METRICS_SUM_MULTI,
+    ALPHA_METRICS_SUM_BATCH,
+    ALPHA_METRICS_ACCUMULATE,
+    ALPHA_METRICS_REDUCE,
+    ALPHA_METRICS_SUM_STRIDED,
+    ALPHA_METRICS_SUM_STORED,
+    ALPHA_METRICS_SUM_NAMED,
+    ALPHA_METRICS_SUM_SHM,
+    ALPHA_METRICS_NUM_RPCS
+} alpha_metrics_rpc;
+
+/* Phases of an RPC handler that are timed separately */
+typedef enum alpha_metrics_phase {
+    ALPHA_PHASE_DESERIALIZE,
+    ALPHA_PHASE_QUEUE,       // waiting for admission (see admission.h)
+    ALPHA_PHASE_ADDR_LOOKUP,
+    ALPHA_PHASE_BULK_PULL,
+    ALPHA_PHASE_COMPUTE,
+    ALPHA_PHASE_BULK_PUSH,
+    ALPHA_PHASE_RESPOND,
+    ALPHA_METRICS_NUM_PHASES
+} alpha_metrics_phase;
+
+/* Latencies are recorded in nanoseconds in log-linear buckets: values below
+ * 2^ALPHA_HISTOGRAM_SUB_BITS have their own bucket, and each power of two
+ * above is split into 2^ALPHA_HISTOGRAM_SUB_BITS buckets, bounding the
+ * relative error to 1/2^ALPHA_HISTOGRAM_SUB_BITS. Values of
+ * 2^(ALPHA_HISTOGRAM_MAX_EXP+1)ns (~36 minutes) or more all land in the
+ * last bucket. */
+#define ALPHA_HISTOGRAM_SUB_BITS    3
+#define ALPHA_HISTOGRAM_MAX_EXP     40
+#define ALPHA_HISTOGRAM_NUM_BUCKETS \
+    ((ALPHA_HISTOGRAM_MAX_EXP - ALPHA_HISTOGRAM_SUB_BITS + 2) << ALPHA_HISTOGRAM_SUB_BITS)
+
+/* All the fields below are updated with relaxed atomic operations,
+ * so that recording a value never takes a lock */
+typedef struct alpha_histogram {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t max;
+    uint64_t buckets[ALPHA_HISTOGRAM_NUM_BUCKETS];
+} alpha_histogram;
+
+typedef struct alpha_rpc_metrics {
+    uint64_t        calls;
+    uint64_t        errors[ALPHA_ERR_OTHER + 1]; // indexed by alpha_return_t
+    alpha_histogram phases[ALPHA_METRICS_NUM_PHASES];
+} alpha_rpc_metrics;
+
+typedef struct alpha_metrics {
+    uint64_t          bytes_pulled;
+    uint64_t          bytes_pushed;
+    alpha_rpc_metrics rpcs[ALPHA_METRICS_NUM_RPCS];
+} alpha_metrics;
+
+/**
+ * @brief Allocates zeroed metrics.
+ */
+alpha_metrics* alpha_metrics_create(void);
+
+/**
+ * @brief Frees the metrics. Passing NULL is valid and does nothing.
+ */
+void alpha_metrics_destroy(alpha_metrics* metrics);
+
+/**
+ * @brief Returns the current time in nanoseconds, from a monotonic clock.
+ */
+static inline uint64_t alpha_metrics_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec*1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Returns the current time if metrics are enabled (i.e. metrics
+ * is not NULL), 0 otherwise, so that disabled metrics don't cost a
+ * clock_gettime call.
+ */
+static inline uint64_t alpha_metrics_start(alpha_metrics* metrics)
+{
+    return metrics ? alpha_metrics_now() : 0;
+}
+
+/**
+ * @brief Returns the time elapsed since start if metrics are enabled,
+ * 0 otherwise.
+ */
+static inline uint64_t alpha_metrics_elapsed(alpha_metrics* metrics, uint64_t start)
+{
+    return metrics ? alpha_metrics_now() - start : 0;
+}
+
+/**
+ * @brief Records a value (in nanoseconds) in the histogram.
+ */
+void alpha_histogram_record(alpha_histogram* histogram, uint64_t value);
+
+/**
+ * @brief Records the time elapsed since start in the histogram of a phase,
+ * and returns the current time, so that consecutive phases can be chained:
+ *
+ *     uint64_t t = alpha_metrics_now();
+ *     ... deserialize ...
+ *     t = alpha_metrics_record_phase(m, ALPHA_METRICS_SUM, ALPHA_PHASE_DESERIALIZE, t);
+ *     ... compute ...
+ *     t = alpha_metrics_record_phase(m, ALPHA_METRICS_SUM, ALPHA_PHASE_COMPUTE, t);
+ *
+ * Does nothing if metrics is NULL (i.e. if metrics are disabled).
+ */
+static inline uint64_t alpha_metrics_record_phase(
+        alpha_metrics* metrics,
+        alpha_metrics_rpc rpc,
+        alpha_metrics_phase phase,
+        uint64_t start)
+{
+    if(!metrics) return 0;
+    uint64_t now = alpha_metrics_now();
+    alpha_histogram_record(&metrics->rpcs[rpc].phases[phase], now - start);
+    return now;
+}
+
+/**
+ * @brief Records a duration (in nanoseconds) in the histogram of a phase,
+ * for phases that are not timed in one go (e.g. pipelined transfers).
+ * Does nothing if metrics is NULL.
+ */
+static inline void alpha_metrics_record_duration(
+        alpha_metrics* metrics,
+        alpha_metrics_rpc rpc,
+        alpha_metrics_phase phase,
+        uint64_t duration)
+{
+    if(!metrics) return;
+    alpha_histogram_record(&metrics->rpcs[rpc].phases[phase], duration);
+}
+
+/**
+ * @brief Counts a call to an RPC, along with its return value.
+ * Does nothing if metrics is NULL.
+ */
+static inline void alpha_metrics_record_call(
+        alpha_metrics* metrics,
+        alpha_metrics_rpc rpc,
+        alpha_return_t ret)
+{
+    if(!metrics) return;
+    __atomic_add_fetch(&metrics->rpcs[rpc].calls, 1, __ATOMIC_RELAXED);
+    if(ret != ALPHA_SUCCESS) {
+        size_t i = (size_t)ret <= ALPHA_ERR_OTHER ? (size_t)ret : ALPHA_ERR_OTHER;
+        __atomic_add_fetch(&metrics->rpcs[rpc].errors[i], 1, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief Counts bytes transferred by RDMA. Does nothing if metrics is NULL.
+ */
+static inline void alpha_metrics_record_bytes(
+        alpha_metrics* metrics,
+        uint64_t pulled,
+        uint64_t pushed)
+{
+    if(!metrics) return;
+    if(pulled) __atomic_add_fetch(&metrics->bytes_pulled, pulled, __ATOMIC_RELAXED);
+    if(pushed) __atomic_add_fetch(&metrics->bytes_pushed, pushed, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Returns the metrics as a JSON object. Histograms are summarized
+ * by their count, mean, max, and percentiles, along with their non-empty
+ * buckets (keyed by the lower bound of the bucket).
+ */
+struct json_object* alpha_metrics_to_json(alpha_metrics* metrics);
+
+#endif
@@ -3,33 +3,144 @@
  *
  * See COPYRIGHT in top-level directory.
  */
+#include <string.h>
 #include "alpha/alpha-server.h"
 #include "provider.h"
 #include "types.h"
+#include "wait-all.h"
+#include "backend-registry.h"
+#include "shm.h"
+#include "typed-kernels.h"
+#include "strided.h"
 
 /* backends that we want to add at compile time */
 #include "dummy/dummy-backend.h"
+#include "files/files-backend.h"
 /* Note: other backends can be added dynamically using
- * alpha_register_backend */
+ * alpha_register_backend, or loaded from shared libraries
+ * (see backend-registry.h) */
 
 static void alpha_finalize_provider(void* p);
 
-/* global array of up to 64 registered backends */
-#define ALPHA_MAX_NUM_BACKENDS 64
-static alpha_backend_impl* g_alpha_backend_types[ALPHA_MAX_NUM_BACKENDS] = {0};
+/* resource ids index a dense array, hence they are bounded */
+#define ALPHA_MAX_NUM_RESOURCES 65536
+#define ALPHA_RESOURCE_ID_ANY   (-1)
 
-/* Functions to manipulate the list of backend types */
-static inline alpha_backend_impl* find_backend_impl(const char* name);
-static inline alpha_return_t add_backend_impl(alpha_backend_impl* backend);
+/* Functions to manipulate the provider's resources */
+static alpha_return_t alpha_provider_insert_resource(
+        alpha_provider_t provider, alpha_backend_impl* backend,
+        const char* library, const char* config, int64_t requested_id,
+        uint32_t* resource_id);
+static alpha_return_t alpha_provider_add_resource_from_json(
+        alpha_provider_t provider, struct json_object* resource,
+        int64_t default_id);
+static inline alpha_resource* alpha_provider_acquire_resource(
+        alpha_provider_t provider, uint32_t resource_id);
+static inline void alpha_resource_release(alpha_resource* resource);
 
 /* Client RPCs */
 static DECLARE_MARGO_RPC_HANDLER(alpha_sum_ult)
 static void alpha_sum_ult(hg_handle_t h);
 static DECLARE_MARGO_RPC_HANDLER(alpha_sum_multi_ult)
 static void alpha_sum_multi_ult(hg_handle_t h);
+static DECLARE_MARGO_RPC_HANDLER(alpha_accumulate_ult)
+static void alpha_accumulate_ult(hg_handle_t h);
+static DECLARE_MARGO_RPC_HANDLER(alpha_reduce_ult)
+static void alpha_reduce_ult(hg_handle_t h);
+static DECLARE_MARGO_RPC_HANDLER(alpha_sum_strided_ult)
+static void alpha_sum_strided_ult(hg_handle_t h);
+static DECLARE_MARGO_RPC_HANDLER(alpha_sum_stored_ult)
+static void alpha_sum_stored_ult(hg_handle_t h);
+static DECLARE_MARGO_RPC_HANDLER(alpha_array_store_ult)
+static void alpha_array_store_ult(hg_handle_t h);
+static DECLARE_MARGO_RPC_HANDLER(alpha_array_remove_ult)
+static void alpha_array_remove_ult(hg_handle_t h);
+static DECLARE_MARGO_RPC_HANDLER(alpha_named_create_ult)
+static void alpha_named_create_ult(hg_handle_t h);
+static DECLARE_MARGO_RPC_HANDLER(alpha_named_io_ult)
+static void alpha_named_io_ult(hg_handle_t h);
+static DECLARE_MARGO_RPC_HANDLER(alpha_sum_named_ult)
+static void alpha_sum_named_ult(hg_handle_t h);
+static DECLARE_MARGO_RPC_HANDLER(alpha_sum_batch_ult)
+static void alpha_sum_batch_ult(hg_handle_t h);
+static DECLARE_MARGO_RPC_HANDLER(alpha_stats_ult)
+static void alpha_stats_ult(hg_handle_t h);
+static DECLARE_MARGO_RPC_HANDLER(alpha_shm_attach_ult)
+static void alpha_shm_attach_ult(hg_handle_t h);
+static DECLARE_MARGO_RPC_HANDLER(alpha_shm_detach_ult)
+static void alpha_shm_detach_ult(hg_handle_t h);
+static DECLARE_MARGO_RPC_HANDLER(alpha_sum_shm_ult)
+static void alpha_sum_shm_ult(hg_handle_t h);
+
+/* Functions to manipulate the shared-memory segments of the provider */
+static alpha_shm_segment* alpha_provider_acquire_shm_segment(
+        alpha_provider_t provider, uint64_t segment_id);
+static void alpha_shm_segment_release(alpha_shm_segment* segment);
+
+/* Operations for clients in the same margo instance (see local.h). Their
+ * context is allocated separately from the provider and only freed when
+ * margo finalizes, since a client may have looked it up right before the
+ * provider is destroyed. Local calls hold the lock for reading while they
+ * use the provider, which is cleared under the lock held for writing. */
+typedef struct alpha_local_context {
+    alpha_local_ops  ops;
+    ABT_rwlock       lock;
+    alpha_provider_t provider; // NULL once the provider is destroyed
+} alpha_local_context;
+
+static void alpha_local_context_free(void* context);
+
+static alpha_return_t alpha_local_sum_multi(
+        void* context, uint32_t resource_id, size_t count,
+        const int32_t* x, const int32_t* y, int32_t* result,
+        uint32_t* retry_after_ms);
 
 /* FIXME: add other RPC declarations here */
 
+/* default size of the chunks used to pipeline large sum_multi requests */
+#define ALPHA_DEFAULT_PIPELINE_CHUNK_SIZE (1024*1024)
+/* number of chunks that can be in flight in a pipelined sum_multi */
+#define ALPHA_PIPELINE_DEPTH 3
+
+static alpha_return_t alpha_sum_multi_pipelined(
+        alpha_provider_t provider, alpha_resource* resource,
+        alpha_metrics_rpc rpc, const sum_multi_in_t* in,
+        hg_addr_t x_addr, hg_addr_t y_addr, hg_addr_t r_addr,
+        const char* local_y);
+
+/* default minimum number of elements per task in the compute pool */
+#define ALPHA_DEFAULT_COMPUTE_MIN_TASK_SIZE 32768
+/* default maximum number of tasks a computation is split into */
+#define ALPHA_DEFAULT_COMPUTE_MAX_TASKS 64
+
+/* Computes r[i] = x[i] + y[i] using the resource's backend */
+static inline void alpha_resource_sum_batch(
+        alpha_resource* resource, size_t count,
+        const int32_t* x, const int32_t* y, int32_t* r);
+
+/* Same as alpha_resource_sum_batch, splitting large computations
+ * into tasks that run in the provider's compute pool, if any */
+static void alpha_provider_compute_sum(
+        alpha_provider_t provider, alpha_resource* resource, size_t count,
+        const int32_t* x, const int32_t* y, int32_t* r);
+
+/* Computes r[i] = x[i] + y[i] on elements of the given type, with the
+ * resource's sum_batch function for ALPHA_DTYPE_I32, otherwise with its
+ * sum_typed function or the generic typed kernels, splitting large
+ * computations like alpha_provider_compute_sum */
+static void alpha_provider_compute_typed(
+        alpha_provider_t provider, alpha_resource* resource, alpha_dtype_t dtype,
+        size_t count, const void* x, const void* y, void* r);
+
+/* Same as alpha_provider_compute_typed for the sums of sum_multi and
+ * sum_batch RPCs and co-located sum_multi calls, which are looked up in the
+ * provider's result cache first, if enabled. sum_shm RPCs are not cached:
+ * their operands stay in memory the client may modify while the sum is
+ * computed, so the result might not match the copies kept by the cache. */
+static void alpha_provider_compute_cached(
+        alpha_provider_t provider, alpha_resource* resource, alpha_metrics_rpc rpc,
+        alpha_dtype_t dtype, size_t count, const void* x, const void* y, void* r);
+
 alpha_return_t alpha_provider_register(
         margo_instance_id mid,
         uint16_t provider_id,
@@ -94,6 +205,9 @@ alpha_return_t alpha_provider_register(
     p->mid = mid;
     p->provider_id = provider_id;
     p->pool = a.pool;
+    p->compute_pool = a.compute_pool;
+    ABT_rwlock_create(&p->resources_lock);
+    ABT_mutex_create(&p->shm_lock);
 
     /* Client RPCs */
 
@@ -109,53 +223,291 @@ alpha_return_t alpha_provider_register(
     margo_register_data(mid, id, (void*)p, NULL);
     p->sum_multi_id = id;
 
+    id = MARGO_REGISTER_PROVIDER(mid, "alpha_accumulate",
+            accumulate_in_t, sum_multi_out_t,
+            alpha_accumulate_ult, provider_id, p->pool);
+    margo_register_data(mid, id, (void*)p, NULL);
+    p->accumulate_id = id;
+
+    id = MARGO_REGISTER_PROVIDER(mid, "alpha_reduce",
+            reduce_in_t, reduce_out_t,
+            alpha_reduce_ult, provider_id, p->pool);
+    margo_register_data(mid, id, (void*)p, NULL);
+    p->reduce_id = id;
+
+    id = MARGO_REGISTER_PROVIDER(mid, "alpha_sum_strided",
+            sum_strided_in_t, sum_multi_out_t,
+            alpha_sum_strided_ult, provider_id, p->pool);
+    margo_register_data(mid, id, (void*)p, NULL);
+    p->sum_strided_id = id;
+
+    id = MARGO_REGISTER_PROVIDER(mid, "alpha_sum_stored",
+            sum_stored_in_t, sum_multi_out_t,
+            alpha_sum_stored_ult, provider_id, p->pool);
+    margo_register_data(mid, id, (void*)p, NULL);
+    p->sum_stored_id = id;
+
+    id = MARGO_REGISTER_PROVIDER(mid, "alpha_array_store",
+            array_store_in_t, array_store_out_t,
+            alpha_array_store_ult, provider_id, p->pool);
+    margo_register_data(mid, id, (void*)p, NULL);
+    p->array_store_id = id;
+
+    id = MARGO_REGISTER_PROVIDER(mid, "alpha_array_remove",
+            array_remove_in_t, array_remove_out_t,
+            alpha_array_remove_ult, provider_id, p->pool);
+    margo_register_data(mid, id, (void*)p, NULL);
+    p->array_remove_id = id;
+
+    id = MARGO_REGISTER_PROVIDER(mid, "alpha_named_create",
+            named_create_in_t, named_array_out_t,
+            alpha_named_create_ult, provider_id, p->pool);
+    margo_register_data(mid, id, (void*)p, NULL);
+    p->named_create_id = id;
+
+    id = MARGO_REGISTER_PROVIDER(mid, "alpha_named_io",
+            named_io_in_t, named_array_out_t,
+            alpha_named_io_ult, provider_id, p->pool);
+    margo_register_data(mid, id, (void*)p, NULL);
+    p->named_io_id = id;
+
+    id = MARGO_REGISTER_PROVIDER(mid, "alpha_sum_named",
+            sum_named_in_t, sum_multi_out_t,
+            alpha_sum_named_ult, provider_id, p->pool);
+    margo_register_data(mid, id, (void*)p, NULL);
+    p->sum_named_id = id;
+
+    id = MARGO_REGISTER_PROVIDER(mid, "alpha_sum_batch",
+            sum_batch_in_t, sum_batch_out_t,
+            alpha_sum_batch_ult, provider_id, p->pool);
+    margo_register_data(mid, id, (void*)p, NULL);
+    p->sum_batch_id = id;
+
+    id = MARGO_REGISTER_PROVIDER(mid, "alpha_stats",
+            void, stats_out_t,
+            alpha_stats_ult, provider_id, p->pool);
+    margo_register_data(mid, id, (void*)p, NULL);
+    p->stats_id = id;
+
+    id = MARGO_REGISTER_PROVIDER(mid, "alpha_shm_attach",
+            shm_attach_in_t, shm_attach_out_t,
+            alpha_shm_attach_ult, provider_id, p->pool);
+    margo_register_data(mid, id, (void*)p, NULL);
+    p->shm_attach_id = id;
+
+    id = MARGO_REGISTER_PROVIDER(mid, "alpha_shm_detach",
+            shm_detach_in_t, shm_detach_out_t,
+            alpha_shm_detach_ult, provider_id, p->pool);
+    margo_register_data(mid, id, (void*)p, NULL);
+    p->shm_detach_id = id;
+
+    id = MARGO_REGISTER_PROVIDER(mid, "alpha_sum_shm",
+            sum_shm_in_t, sum_multi_out_t,
+            alpha_sum_shm_ult, provider_id, p->pool);
+    margo_register_data(mid, id, (void*)p, NULL);
+    p->sum_shm_id = id;
+
     /* FIXME: add other RPC registration here */
     /* ... */
 
-    /* add backends available at compile time (e.g. default/dummy backends) */
-    alpha_register_dummy_backend(); // function from "dummy/dummy-backend.h"
-    /* FIXME: add other backend registrations here */
-    /* ... */
+    /* operations for co-located clients, which never go through Mercury;
+     * the context is freed by margo after the provider's finalize callback,
+     * which is pushed after this one */
+    p->local = (alpha_local_context*)calloc(1, sizeof(*p->local));
+    if (!p->local) {
+        ret = ALPHA_ERR_ALLOCATION;
+        goto finish;
+    }
+    p->local->ops.context   = p->local;
+    p->local->ops.sum_multi = alpha_local_sum_multi;
+    p->local->provider      = p;
+    ABT_rwlock_create(&p->local->lock);
+    margo_push_finalize_callback(mid, alpha_local_context_free, p->local);
+    id = margo_provider_register_name(mid, ALPHA_LOCAL_RPC_NAME,
+            NULL, NULL, NULL, provider_id, p->pool);
+    margo_register_data(mid, id, (void*)&p->local->ops, NULL);
+    p->local_id = id;
 
-    /* read the configuration to add defined resources */
-    struct json_object* resource = json_object_object_get(config, "resource");
-    if (resource) {
-        if (!json_object_is_type(resource, json_type_object)) {
-            margo_error(mid, "\"resource\" field should be an object in provider configuration");
+    /* create the pool of registered buffers */
+    ret = alpha_buffer_pool_create(mid,
+            json_object_object_get(config, "buffer_pool"), &p->buffer_pool);
+    if (ret != ALPHA_SUCCESS) {
+        margo_error(mid, "Could not create buffer pool");
+        goto finish;
+    }
+
+    /* create the address cache */
+    ret = alpha_addr_cache_create(mid,
+            json_object_object_get(config, "addr_cache"), &p->addr_cache);
+    if (ret != ALPHA_SUCCESS) {
+        margo_error(mid, "Could not create address cache");
+        goto finish;
+    }
+
+    /* create the admission controller */
+    ret = alpha_admission_create(mid,
+            json_object_object_get(config, "admission"), &p->admission);
+    if (ret != ALPHA_SUCCESS) {
+        margo_error(mid, "Could not create admission controller");
+        goto finish;
+    }
+
+    /* create the store of arrays uploaded by clients */
+    ret = alpha_array_store_create(mid,
+            json_object_object_get(config, "stored_arrays"), &p->array_store);
+    if (ret != ALPHA_SUCCESS) {
+        margo_error(mid, "Could not create array store");
+        goto finish;
+    }
+
+    /* create the cache of sum_multi results */
+    ret = alpha_result_cache_create(mid,
+            json_object_object_get(config, "result_cache"), &p->result_cache);
+    if (ret != ALPHA_SUCCESS) {
+        margo_error(mid, "Could not create result cache");
+        goto finish;
+    }
+
+    /* read the pipelining configuration */
+    p->pipeline_chunk_size = ALPHA_DEFAULT_PIPELINE_CHUNK_SIZE;
+    struct json_object* pipeline = json_object_object_get(config, "pipeline");
+    if (pipeline) {
+        if (!json_object_is_type(pipeline, json_type_object)) {
+            margo_error(mid, "\"pipeline\" field should be an object in provider configuration");
+            ret = ALPHA_ERR_INVALID_CONFIG;
+            goto finish;
+        }
+        struct json_object* chunk_size = json_object_object_get(pipeline, "chunk_size");
+        if (chunk_size) {
+            if (!json_object_is_type(chunk_size, json_type_int)
+            ||  json_object_get_int64(chunk_size) < 0) {
+                margo_error(mid, "\"chunk_size\" field in pipeline configuration should be a positive integer");
+                ret = ALPHA_ERR_INVALID_CONFIG;
+                goto finish;
+            }
+            p->pipeline_chunk_size = (hg_size_t)json_object_get_int64(chunk_size);
+        }
+    }
+
+    /* read the configuration of the compute pool's tasks */
+    p->compute_min_task_size = ALPHA_DEFAULT_COMPUTE_MIN_TASK_SIZE;
+    p->compute_max_tasks     = ALPHA_DEFAULT_COMPUTE_MAX_TASKS;
+    struct json_object* compute = json_object_object_get(config, "compute");
+    if (compute) {
+        if (!json_object_is_type(compute, json_type_object)) {
+            margo_error(mid, "\"compute\" field should be an object in provider configuration");
             ret = ALPHA_ERR_INVALID_CONFIG;
             goto finish;
         }
-        struct json_object* resource_type = json_object_object_get(resource, "type");
-        if (!json_object_is_type(resource_type, json_type_string)) {
-            margo_error(mid, "\"type\" field in resource configuration should be a string");
+        struct json_object* min_task_size = json_object_object_get(compute, "min_task_size");
+        if (min_task_size) {
+            if (!json_object_is_type(min_task_size, json_type_int)
+            ||  json_object_get_int64(min_task_size) <= 0) {
+                margo_error(mid, "\"min_task_size\" field in compute configuration should be a strictly positive integer");
+                ret = ALPHA_ERR_INVALID_CONFIG;
+                goto finish;
+            }
+            p->compute_min_task_size = (size_t)json_object_get_int64(min_task_size);
+        }
+        struct json_object* max_tasks = json_object_object_get(compute, "max_tasks");
+        if (max_tasks) {
+            if (!json_object_is_type(max_tasks, json_type_int)
+            ||  json_object_get_int64(max_tasks) <= 0) {
+                margo_error(mid, "\"max_tasks\" field in compute configuration should be a strictly positive integer");
+                ret = ALPHA_ERR_INVALID_CONFIG;
+                goto finish;
+            }
+            p->compute_max_tasks = (size_t)json_object_get_int64(max_tasks);
+        }
+    }
+
+    /* read the shared-memory configuration, e.g. { "enabled": true }.
+     * Shm is disabled by default: the provider maps the segments of its
+     * clients, so a client on the same node that shrinks its segment
+     * crashes the provider (SIGBUS) on the next access. It should only be
+     * enabled when all the clients on the node are trusted. */
+    p->shm_enabled = false;
+    struct json_object* shm = json_object_object_get(config, "shm");
+    if (shm) {
+        if (!json_object_is_type(shm, json_type_object)) {
+            margo_error(mid, "\"shm\" field should be an object in provider configuration");
             ret = ALPHA_ERR_INVALID_CONFIG;
             goto finish;
         }
-        const char* type = json_object_get_string(resource_type);
-        alpha_backend_impl* backend         = find_backend_impl(type);
-        if (!backend) {
-            margo_error(mid, "Could not find backend of type \"%s\"", type);
+        struct json_object* enabled = json_object_object_get(shm, "enabled");
+        if (enabled) {
+            if (!json_object_is_type(enabled, json_type_boolean)) {
+                margo_error(mid, "\"enabled\" field in shm configuration should be a boolean");
+                ret = ALPHA_ERR_INVALID_CONFIG;
+                goto finish;
+            }
+            p->shm_enabled = json_object_get_boolean(enabled);
+        }
+    }
+
+    /* read the metrics configuration */
+    bool metrics_enabled = true;
+    p->stats_rpc = true;
+    struct json_object* metrics = json_object_object_get(config, "metrics");
+    if (metrics) {
+        if (!json_object_is_type(metrics, json_type_object)) {
+            margo_error(mid, "\"metrics\" field should be an object in provider configuration");
             ret = ALPHA_ERR_INVALID_CONFIG;
             goto finish;
         }
-        struct json_object* resource_config = json_object_object_get(resource, "config");
-        /* create the new resource's context */
-        void* context = NULL;
-        ret = backend->create_resource(
-            mid, p,
-            resource_config ? json_object_to_json_string(resource_config) : "{}",
-            &context);
-        if (ret != ALPHA_SUCCESS) {
-            margo_error(mid, "Could not create resource, backend returned %d", ret);
+        struct json_object* enabled = json_object_object_get(metrics, "enabled");
+        if (enabled) {
+            if (!json_object_is_type(enabled, json_type_boolean)) {
+                margo_error(mid, "\"enabled\" field in metrics configuration should be a boolean");
+                ret = ALPHA_ERR_INVALID_CONFIG;
+                goto finish;
+            }
+            metrics_enabled = json_object_get_boolean(enabled);
+        }
+        struct json_object* stats_rpc = json_object_object_get(metrics, "stats_rpc");
+        if (stats_rpc) {
+            if (!json_object_is_type(stats_rpc, json_type_boolean)) {
+                margo_error(mid, "\"stats_rpc\" field in metrics configuration should be a boolean");
+                ret = ALPHA_ERR_INVALID_CONFIG;
+                goto finish;
+            }
+            p->stats_rpc = json_object_get_boolean(stats_rpc);
+        }
+    }
+    if (metrics_enabled) {
+        p->metrics = alpha_metrics_create();
+        if (!p->metrics) {
+            ret = ALPHA_ERR_ALLOCATION;
             goto finish;
         }
-
-        /* set the provider's resource */
-        p->resource = malloc(sizeof(*(p->resource)));
-        p->resource->ctx = context;
-        p->resource->fn  = backend;
     }
 
+    /* add backends available at compile time (e.g. default/dummy backends) */
+    alpha_register_dummy_backend(); // function from "dummy/dummy-backend.h"
+    alpha_register_files_backend(); // function from "files/files-backend.h"
+    /* FIXME: add other backend registrations here */
+    /* ... */
+
+    /* read the configuration to add defined resources; a single "resource"
+     * object is accepted for compatibility and gets the resource id 0 */
+    struct json_object* resource = json_object_object_get(config, "resource");
+    if (resource) {
+        ret = alpha_provider_add_resource_from_json(p, resource, 0);
+        if (ret != ALPHA_SUCCESS) goto finish;
+    }
+    struct json_object* resources = json_object_object_get(config, "resources");
+    if (resources) {
+        if (!json_object_is_type(resources, json_type_array)) {
+            margo_error(mid, "\"resources\" field should be an array in provider configuration");
+            ret = ALPHA_ERR_INVALID_CONFIG;
+            goto finish;
+        }
+        for (size_t i = 0; i < json_object_array_length(resources); ++i) {
+            ret = alpha_provider_add_resource_from_json(p,
+                    json_object_array_get_idx(resources, i), ALPHA_RESOURCE_ID_ANY);
+            if (ret != ALPHA_SUCCESS) goto finish;
+        }
+    }
 
     /* set the finalize callback */
     margo_provider_push_finalize_callback(mid, p, &alpha_finalize_provider, p);
@@ -181,12 +533,49 @@ static void alpha_finalize_provider(void* p)
     margo_provider_deregister_identity(provider->mid, provider->provider_id);
     margo_deregister(provider->mid, provider->sum_id);
     margo_deregister(provider->mid, provider->sum_multi_id);
+    margo_deregister(provider->mid, provider->accumulate_id);
+    margo_deregister(provider->mid, provider->reduce_id);
+    margo_deregister(provider->mid, provider->sum_strided_id);
+    margo_deregister(provider->mid, provider->sum_stored_id);
+    margo_deregister(provider->mid, provider->array_store_id);
+    margo_deregister(provider->mid, provider->array_remove_id);
+    margo_deregister(provider->mid, provider->named_create_id);
+    margo_deregister(provider->mid, provider->named_io_id);
+    margo_deregister(provider->mid, provider->sum_named_id);
+    margo_deregister(provider->mid, provider->sum_batch_id);
+    margo_deregister(provider->mid, provider->stats_id);
+    margo_deregister(provider->mid, provider->shm_attach_id);
+    margo_deregister(provider->mid, provider->shm_detach_id);
+    margo_deregister(provider->mid, provider->sum_shm_id);
+    margo_deregister(provider->mid, provider->local_id);
     /* FIXME deregister other RPC ids ... */
 
-    /* destroy the resource's context */
-    if(provider->resource)
-        provider->resource->fn->destroy_resource(provider->resource->ctx);
-    free(provider->resource);
+    /* wait for the local calls in progress, and make later ones fail */
+    if(provider->local) {
+        ABT_rwlock_wrlock(provider->local->lock);
+        provider->local->provider = NULL;
+        ABT_rwlock_unlock(provider->local->lock);
+    }
+
+    /* release the resources, which are destroyed
+     * when no RPC is using them anymore */
+    for(size_t i = 0; i < provider->resources_capacity; ++i)
+        alpha_resource_release(provider->resources[i]);
+    free(provider->resources);
+    ABT_rwlock_free(&provider->resources_lock);
+    /* unmap the segments that clients haven't detached */
+    while(provider->shm_segments) {
+        alpha_shm_segment* segment = provider->shm_segments;
+        provider->shm_segments = segment->next;
+        alpha_shm_segment_release(segment);
+    }
+    ABT_mutex_free(&provider->shm_lock);
+    alpha_buffer_pool_destroy(provider->buffer_pool);
+    alpha_addr_cache_destroy(provider->addr_cache);
+    alpha_admission_destroy(provider->admission);
+    alpha_array_store_destroy(provider->array_store);
+    alpha_result_cache_destroy(provider->result_cache);
+    alpha_metrics_destroy(provider->metrics);
     margo_instance_id mid = provider->mid;
     free(provider);
     margo_info(mid, "ALPHA provider successfuly finalized");
@@ -209,27 +598,293 @@ char* alpha_provider_get_config(alpha_provider_t provider)
 {
     if (!provider) return NULL;
     struct json_object* root = json_object_new_object();
-    if(provider->resource) {
+    struct json_object* resources = json_object_new_array();
+    json_object_object_add(root, "resources", resources);
+    ABT_rwlock_rdlock(provider->resources_lock);
+    for(size_t i = 0; i < provider->resources_capacity; ++i) {
+        alpha_resource* r = provider->resources[i];
+        if(!r) continue;
         struct json_object* resource = json_object_new_object();
-        json_object_object_add(root, "resource", resource);
-        struct json_object* resource_type = json_object_new_string(provider->resource->fn->name);
+        json_object_array_add(resources, resource);
+        json_object_object_add(resource, "id", json_object_new_int64((int64_t)r->id));
+        struct json_object* resource_type = json_object_new_string(r->fn->name);
         json_object_object_add(resource, "type", resource_type);
-        char* resource_config_str = (provider->resource->fn->get_config)(provider->resource->ctx);
+        if(r->library)
+            json_object_object_add(resource, "library", json_object_new_string(r->library));
+        char* resource_config_str = (r->fn->get_config)(r->ctx);
         struct json_object* resource_config = json_tokener_parse(resource_config_str);
         free(resource_config_str);
         json_object_object_add(resource, "config", resource_config);
     }
+    ABT_rwlock_unlock(provider->resources_lock);
+    json_object_object_add(root, "buffer_pool",
+        alpha_buffer_pool_get_config(provider->buffer_pool));
+    json_object_object_add(root, "addr_cache",
+        alpha_addr_cache_get_config(provider->addr_cache));
+    json_object_object_add(root, "admission",
+        alpha_admission_get_config(provider->admission));
+    json_object_object_add(root, "stored_arrays",
+        alpha_array_store_get_config(provider->array_store));
+    json_object_object_add(root, "result_cache",
+        alpha_result_cache_get_config(provider->result_cache));
+    struct json_object* pipeline = json_object_new_object();
+    json_object_object_add(pipeline, "chunk_size",
+        json_object_new_int64((int64_t)provider->pipeline_chunk_size));
+    json_object_object_add(root, "pipeline", pipeline);
+    struct json_object* compute = json_object_new_object();
+    json_object_object_add(compute, "min_task_size",
+        json_object_new_int64((int64_t)provider->compute_min_task_size));
+    json_object_object_add(compute, "max_tasks",
+        json_object_new_int64((int64_t)provider->compute_max_tasks));
+    json_object_object_add(root, "compute", compute);
+    struct json_object* shm = json_object_new_object();
+    json_object_object_add(shm, "enabled",
+        json_object_new_boolean(provider->shm_enabled));
+    json_object_object_add(root, "shm", shm);
+    struct json_object* metrics = json_object_new_object();
+    json_object_object_add(metrics, "enabled",
+        json_object_new_boolean(provider->metrics != NULL));
+    json_object_object_add(metrics, "stats_rpc",
+        json_object_new_boolean(provider->stats_rpc));
+    json_object_object_add(root, "metrics", metrics);
+    char* result = strdup(json_object_to_json_string(root));
+    json_object_put(root);
+    return result;
+}
+
+char* alpha_provider_get_stats(alpha_provider_t provider)
+{
+    if (!provider) return NULL;
+    struct json_object* root = json_object_new_object();
+    json_object_object_add(root, "buffer_pool",
+        alpha_buffer_pool_get_stats(provider->buffer_pool));
+    json_object_object_add(root, "addr_cache",
+        alpha_addr_cache_get_stats(provider->addr_cache));
+    json_object_object_add(root, "admission",
+        alpha_admission_get_stats(provider->admission));
+    json_object_object_add(root, "stored_arrays",
+        alpha_array_store_get_stats(provider->array_store));
+    json_object_object_add(root, "result_cache",
+        alpha_result_cache_get_stats(provider->result_cache));
+    if(provider->metrics)
+        json_object_object_add(root, "metrics",
+            alpha_metrics_to_json(provider->metrics));
     char* result = strdup(json_object_to_json_string(root));
     json_object_put(root);
     return result;
 }
 
+alpha_return_t alpha_provider_add_resource(
+        alpha_provider_t provider,
+        const char* type,
+        const char* config,
+        uint32_t* resource_id)
+{
+    if(!provider || !type)
+        return ALPHA_ERR_INVALID_ARGS;
+    alpha_backend_impl* backend = alpha_backend_registry_find(type);
+    if(!backend) {
+        margo_error(provider->mid, "Could not find backend of type \"%s\"", type);
+        return ALPHA_ERR_INVALID_BACKEND;
+    }
+    return alpha_provider_insert_resource(
+            provider, backend, NULL, config, ALPHA_RESOURCE_ID_ANY, resource_id);
+}
+
+alpha_return_t alpha_provider_remove_resource(
+        alpha_provider_t provider,
+        uint32_t resource_id)
+{
+    if(!provider)
+        return ALPHA_ERR_INVALID_ARGS;
+    alpha_resource* resource = NULL;
+    ABT_rwlock_wrlock(provider->resources_lock);
+    if(resource_id < provider->resources_capacity) {
+        resource = provider->resources[resource_id];
+        provider->resources[resource_id] = NULL;
+    }
+    ABT_rwlock_unlock(provider->resources_lock);
+    if(!resource)
+        return ALPHA_ERR_INVALID_RESOURCE;
+    margo_info(provider->mid, "Removing resource %u from ALPHA provider", resource_id);
+    alpha_resource_release(resource);
+    return ALPHA_SUCCESS;
+}
+
+/* Creates a resource and places it in the provider's table, either at the
+ * requested id or, if requested_id is ALPHA_RESOURCE_ID_ANY, in the first
+ * free slot. library is the name of the library providing the backend,
+ * if it was loaded from one, and is only kept for get_config. */
+static alpha_return_t alpha_provider_insert_resource(
+        alpha_provider_t provider,
+        alpha_backend_impl* backend,
+        const char* library,
+        const char* config,
+        int64_t requested_id,
+        uint32_t* resource_id)
+{
+    margo_instance_id mid = provider->mid;
+    alpha_return_t ret = ALPHA_SUCCESS;
+
+    /* create the new resource's context */
+    void* context = NULL;
+    ret = backend->create_resource(mid, provider, config ? config : "{}", &context);
+    if(ret != ALPHA_SUCCESS) {
+        margo_error(mid, "Could not create resource, backend returned %d", ret);
+        return ret;
+    }
+
+    alpha_resource* resource = (alpha_resource*)calloc(1, sizeof(*resource));
+    if(!resource) {
+        backend->destroy_resource(context);
+        return ALPHA_ERR_ALLOCATION;
+    }
+    resource->fn       = backend;
+    resource->ctx      = context;
+    resource->refcount = 1;
+    if(library) {
+        resource->library = strdup(library);
+        if(!resource->library) {
+            backend->destroy_resource(context);
+            free(resource);
+            return ALPHA_ERR_ALLOCATION;
+        }
+    }
+
+    ABT_rwlock_wrlock(provider->resources_lock);
+    size_t id = 0;
+    if(requested_id != ALPHA_RESOURCE_ID_ANY) {
+        id = (size_t)requested_id;
+    } else {
+        while(id < provider->resources_capacity && provider->resources[id]) ++id;
+    }
+    if(id >= ALPHA_MAX_NUM_RESOURCES) {
+        margo_error(mid, "Resource ids should be lower than %d", ALPHA_MAX_NUM_RESOURCES);
+        ret = ALPHA_ERR_INVALID_RESOURCE;
+        goto unlock;
+    }
+    if(id < provider->resources_capacity && provider->resources[id]) {
+        margo_error(mid, "Resource id %lu is already in use", (unsigned long)id);
+        ret = ALPHA_ERR_INVALID_RESOURCE;
+        goto unlock;
+    }
+    if(id >= provider->resources_capacity) {
+        size_t new_capacity = provider->resources_capacity ?
+                              2*provider->resources_capacity : 8;
+        while(new_capacity <= id) new_capacity *= 2;
+        alpha_resource** new_resources = (alpha_resource**)realloc(
+            provider->resources, new_capacity*sizeof(*new_resources));
+        if(!new_resources) {
+            ret = ALPHA_ERR_ALLOCATION;
+            goto unlock;
+        }
+        memset(new_resources + provider->resources_capacity, 0,
+               (new_capacity - provider->resources_capacity)*sizeof(*new_resources));
+        provider->resources          = new_resources;
+        provider->resources_capacity = new_capacity;
+    }
+    resource->id     = (uint32_t)id;
+    resource->serial = provider->resources_added++;
+    provider->resources[id] = resource;
+
+unlock:
+    ABT_rwlock_unlock(provider->resources_lock);
+    if(ret != ALPHA_SUCCESS) {
+        backend->destroy_resource(context);
+        free(resource->library);
+        free(resource);
+        return ret;
+    }
+    margo_info(mid, "Added resource %lu of type \"%s\" to ALPHA provider",
+               (unsigned long)id, backend->name);
+    if(resource_id) *resource_id = (uint32_t)id;
+    return ALPHA_SUCCESS;
+}
+
+/* Adds a resource from its JSON description, i.e. an object with "type",
+ * and optional "config", "id", and "library" fields. default_id is used
+ * if "id" is not provided. If "library" is provided, the library is loaded
+ * before looking up the backend. */
+static alpha_return_t alpha_provider_add_resource_from_json(
+        alpha_provider_t provider,
+        struct json_object* resource,
+        int64_t default_id)
+{
+    margo_instance_id mid = provider->mid;
+    if (!json_object_is_type(resource, json_type_object)) {
+        margo_error(mid, "Resource description should be an object in provider configuration");
+        return ALPHA_ERR_INVALID_CONFIG;
+    }
+    struct json_object* resource_type = json_object_object_get(resource, "type");
+    if (!json_object_is_type(resource_type, json_type_string)) {
+        margo_error(mid, "\"type\" field in resource configuration should be a string");
+        return ALPHA_ERR_INVALID_CONFIG;
+    }
+    int64_t id = default_id;
+    struct json_object* resource_id = json_object_object_get(resource, "id");
+    if (resource_id) {
+        if (!json_object_is_type(resource_id, json_type_int)
+        ||  json_object_get_int64(resource_id) < 0) {
+            margo_error(mid, "\"id\" field in resource configuration should be a positive integer");
+            return ALPHA_ERR_INVALID_CONFIG;
+        }
+        id = json_object_get_int64(resource_id);
+    }
+    const char* library = NULL;
+    struct json_object* resource_library = json_object_object_get(resource, "library");
+    if (resource_library) {
+        if (!json_object_is_type(resource_library, json_type_string)) {
+            margo_error(mid, "\"library\" field in resource configuration should be a string");
+            return ALPHA_ERR_INVALID_CONFIG;
+        }
+        library = json_object_get_string(resource_library);
+        alpha_return_t ret = alpha_backend_registry_load_library(mid, library);
+        if (ret != ALPHA_SUCCESS) return ret;
+    }
+    const char* type = json_object_get_string(resource_type);
+    alpha_backend_impl* backend = alpha_backend_registry_find(type);
+    if (!backend) {
+        margo_error(mid, "Could not find backend of type \"%s\"", type);
+        return ALPHA_ERR_INVALID_CONFIG;
+    }
+    struct json_object* resource_config = json_object_object_get(resource, "config");
+    return alpha_provider_insert_resource(provider, backend, library,
+            resource_config ? json_object_to_json_string(resource_config) : NULL,
+            id, NULL);
+}
+
+/* Returns the resource with the given id, or NULL if there is none.
+ * The resource must be released with alpha_resource_release. */
+static inline alpha_resource* alpha_provider_acquire_resource(
+        alpha_provider_t provider,
+        uint32_t resource_id)
+{
+    alpha_resource* resource = NULL;
+    ABT_rwlock_rdlock(provider->resources_lock);
+    if(resource_id < provider->resources_capacity) {
+        resource = provider->resources[resource_id];
+        if(resource) __atomic_add_fetch(&resource->refcount, 1, __ATOMIC_RELAXED);
+    }
+    ABT_rwlock_unlock(provider->resources_lock);
+    return resource;
+}
+
+static inline void alpha_resource_release(alpha_resource* resource)
+{
+    if(!resource) return;
+    if(__atomic_sub_fetch(&resource->refcount, 1, __ATOMIC_ACQ_REL) == 0) {
+        resource->fn->destroy_resource(resource->ctx);
+        free(resource->library);
+        free(resource);
+    }
+}
+
 alpha_return_t alpha_provider_register_backend(
         alpha_backend_impl* backend_impl)
 {
     margo_info(MARGO_INSTANCE_NULL, "Adding backend implementation \"%s\" to ALPHA",
                backend_impl->name);
-    return add_backend_impl(backend_impl);
+    return alpha_backend_registry_add(backend_impl);
 }
 
 static void alpha_sum_ult(hg_handle_t h)
@@ -237,6 +892,10 @@ static void alpha_sum_ult(hg_handle_t h)
     hg_return_t hret;
     sum_in_t     in;
     sum_out_t   out;
+    alpha_resource* resource = NULL;
+    bool admitted = false;
+
+    out.retry_after_ms = 0;
 
     /* find the margo instance */
     margo_instance_id mid = margo_hg_handle_get_instance(h);
@@ -244,16 +903,24 @@ static void alpha_sum_ult(hg_handle_t h)
     /* find the provider */
     const struct hg_info* info = margo_get_info(h);
     alpha_provider_t provider = (alpha_provider_t)margo_registered_data(mid, info->id);
+    alpha_metrics* metrics = provider->metrics;
+    uint64_t t = alpha_metrics_start(metrics);
 
     /* deserialize the input */
     hret = margo_get_input(h, &in);
+    t = alpha_metrics_record_phase(metrics, ALPHA_METRICS_SUM, ALPHA_PHASE_DESERIALIZE, t);
     if(hret != HG_SUCCESS) {
         margo_error(mid, "Could not deserialize output (mercury error %d)", hret);
         out.ret = ALPHA_ERR_FROM_MERCURY;
         goto finish;
     }
 
-    alpha_resource* resource = provider->resource;
+    out.ret = alpha_admission_enter(provider->admission, 0, &out.retry_after_ms);
+    if(out.ret != ALPHA_SUCCESS) goto finish;
+    admitted = true;
+    t = alpha_metrics_record_phase(metrics, ALPHA_METRICS_SUM, ALPHA_PHASE_QUEUE, t);
+
+    resource = alpha_provider_acquire_resource(provider, in.resource_id);
     if(!resource) {
         out.ret = ALPHA_ERR_INVALID_RESOURCE;
         goto finish;
@@ -262,32 +929,63 @@ static void alpha_sum_ult(hg_handle_t h)
     /* call sum on the resource's context */
     out.result = resource->fn->sum(resource->ctx, in.x, in.y);
     out.ret = ALPHA_SUCCESS;
+    alpha_metrics_record_phase(metrics, ALPHA_METRICS_SUM, ALPHA_PHASE_COMPUTE, t);
 
     margo_debug(mid, "Called sum RPC");
 
 finish:
+    t = alpha_metrics_start(metrics);
     hret = margo_respond(h, &out);
+    alpha_metrics_record_phase(metrics, ALPHA_METRICS_SUM, ALPHA_PHASE_RESPOND, t);
+    alpha_metrics_record_call(metrics, ALPHA_METRICS_SUM, out.ret);
+    alpha_resource_release(resource);
+    if(admitted) alpha_admission_leave(provider->admission, 0);
     hret = margo_free_input(h, &in);
     margo_destroy(h);
 }
 static DEFINE_MARGO_RPC_HANDLER(alpha_sum_ult)
 
-static void alpha_sum_multi_ult(hg_handle_t h)
+/* Checks that a bulk location sent by a client covers size bytes */
+static inline bool alpha_bulk_location_holds(
+        const alpha_bulk_location_t* loc, size_t size)
+{
+    return loc->offset >= 0 && loc->size >= 0 && (uint64_t)loc->size >= size;
+}
+
+/* Checks that the bulk handle of a strided array covers its span */
+static inline bool alpha_strided_plan_fits(const alpha_strided_plan* plan)
+{
+    return plan->span_size == 0
+        || (uint64_t)plan->span_offset + plan->span_size
+           <= margo_bulk_get_size(plan->location->bulk);
+}
+
+/* Handles alpha_sum_multi RPCs (result = x + y) and alpha_accumulate RPCs
+ * (y += x, in which case the result is pushed back to y's region), on
+ * elements of the input's dtype. The result is computed in place of the
+ * pulled y, so that only x and y need scratch memory. alpha_sum_stored and
+ * alpha_sum_named RPCs are handled the same way, except that y is already
+ * in local memory (local_y) and is not pulled. */
+static void alpha_sum_bulk_handler(hg_handle_t h, alpha_metrics_rpc rpc)
 {
     hg_return_t     hret;
     sum_multi_in_t  in;
+    accumulate_in_t acc_in;
+    sum_stored_in_t st_in;
+    sum_named_in_t  nm_in;
     sum_multi_out_t out;
-    int32_t* x_buf = NULL;
-    int32_t* y_buf = NULL;
-    int32_t* r_buf = NULL;
-    hg_bulk_t x_local_bulk = HG_BULK_NULL;
-    hg_bulk_t y_local_bulk = HG_BULK_NULL;
-    hg_bulk_t r_local_bulk = HG_BULK_NULL;
-    hg_addr_t x_addr = HG_ADDR_NULL;
-    hg_addr_t y_addr = HG_ADDR_NULL;
-    hg_addr_t r_addr = HG_ADDR_NULL;
+    alpha_resource* resource = NULL;
+    alpha_stored_array* stored_y = NULL;
+    const char* local_y = NULL;
+    alpha_buffer* buffer = NULL;
+    alpha_cached_addr* x_addr = NULL;
+    alpha_cached_addr* y_addr = NULL;
+    alpha_cached_addr* r_addr = NULL;
+    size_t scratch_size = 0;
+    bool admitted = false;
 
     out.ret = ALPHA_SUCCESS;
+    out.retry_after_ms = 0;
 
     /* find the margo instance */
     margo_instance_id mid = margo_hg_handle_get_instance(h);
@@ -295,133 +993,1485 @@ static void alpha_sum_multi_ult(hg_handle_t h)
     /* find the provider */
     const struct hg_info* info = margo_get_info(h);
     alpha_provider_t provider = (alpha_provider_t)margo_registered_data(mid, info->id);
+    alpha_metrics* metrics = provider->metrics;
+    uint64_t t = alpha_metrics_start(metrics);
 
-    /* deserialize the input */
-    hret = margo_get_input(h, &in);
+    /* deserialize the input, an accumulate being a sum_multi whose
+     * result has the same location as y, and a sum_stored (resp. sum_named)
+     * being a sum_multi whose y is read from a stored (resp. named) array */
+    void* input = rpc == ALPHA_METRICS_ACCUMULATE ? (void*)&acc_in
+                : rpc == ALPHA_METRICS_SUM_STORED ? (void*)&st_in
+                : rpc == ALPHA_METRICS_SUM_NAMED  ? (void*)&nm_in : (void*)&in;
+    hret = margo_get_input(h, input);
+    t = alpha_metrics_record_phase(metrics, rpc, ALPHA_PHASE_DESERIALIZE, t);
     if(hret != HG_SUCCESS) {
         margo_error(mid, "Could not deserialize output (mercury error %d)", hret);
         out.ret = ALPHA_ERR_FROM_MERCURY;
         goto finish;
     }
+    if(rpc == ALPHA_METRICS_ACCUMULATE) {
+        in.resource_id = acc_in.resource_id;
+        in.count       = acc_in.count;
+        in.x           = acc_in.x;
+        in.y           = acc_in.y;
+        in.result      = acc_in.y;
+        in.dtype       = acc_in.dtype;
+    }
+    if(rpc == ALPHA_METRICS_SUM_STORED) {
+        in.resource_id = st_in.resource_id;
+        in.count       = st_in.count;
+        in.x           = st_in.x;
+        in.result      = st_in.result;
+        in.dtype       = st_in.dtype;
+        stored_y = alpha_array_store_acquire(provider->array_store, st_in.y_id);
+        if(!stored_y) {
+            out.ret = ALPHA_ERR_INVALID_ARRAY;
+            goto finish;
+        }
+        if(stored_y->dtype != in.dtype || stored_y->count < in.count) {
+            out.ret = ALPHA_ERR_INVALID_ARGS;
+            goto finish;
+        }
+        local_y = (const char*)stored_y->data;
+    }
+    if(rpc == ALPHA_METRICS_SUM_NAMED) {
+        in.resource_id = nm_in.resource_id;
+        in.count       = nm_in.count;
+        in.x           = nm_in.x;
+        in.result      = nm_in.result;
+        in.dtype       = ALPHA_DTYPE_I32;
+    }
+    if(in.dtype > ALPHA_DTYPE_F64) {
+        out.ret = ALPHA_ERR_INVALID_ARGS;
+        goto finish;
+    }
+    alpha_dtype_t dtype = (alpha_dtype_t)in.dtype;
+    size_t elem_size    = alpha_dtype_size(dtype);
+
+    /* reject counts for which the sizes below would wrap around, and
+     * bulk regions too small to hold the arrays they are said to hold */
+    if(in.count > SIZE_MAX/(2*elem_size)
+    || !alpha_bulk_location_holds(&in.x, elem_size*in.count)
+    || (!local_y && rpc != ALPHA_METRICS_SUM_NAMED
+        && !alpha_bulk_location_holds(&in.y, elem_size*in.count))
+    || !alpha_bulk_location_holds(&in.result, elem_size*in.count)) {
+        out.ret = ALPHA_ERR_INVALID_ARGS;
+        goto finish;
+    }
+
+    /* the request will borrow space for x and y, or for
+     * the chunks in flight if it is pipelined */
+    scratch_size = 2*elem_size*in.count;
+    if(provider->pipeline_chunk_size
+    && elem_size*in.count > provider->pipeline_chunk_size
+    && scratch_size > 2*ALPHA_PIPELINE_DEPTH*provider->pipeline_chunk_size)
+        scratch_size = 2*ALPHA_PIPELINE_DEPTH*provider->pipeline_chunk_size;
+    out.ret = alpha_admission_enter(provider->admission, scratch_size, &out.retry_after_ms);
+    if(out.ret != ALPHA_SUCCESS) goto finish;
+    admitted = true;
+    t = alpha_metrics_record_phase(metrics, rpc, ALPHA_PHASE_QUEUE, t);
+
+    resource = alpha_provider_acquire_resource(provider, in.resource_id);
+    if(!resource) {
+        out.ret = ALPHA_ERR_INVALID_RESOURCE;
+        goto finish;
+    }
+
+    if(rpc == ALPHA_METRICS_SUM_NAMED) {
+        /* the array stays valid as long as we hold the resource */
+        int32_t* array = NULL;
+        size_t   array_count = 0;
+        if(!resource->fn->find_array) {
+            out.ret = ALPHA_ERR_OP_UNSUPPORTED;
+            goto finish;
+        }
+        out.ret = resource->fn->find_array(resource->ctx, nm_in.y_name, &array, &array_count);
+        if(out.ret != ALPHA_SUCCESS) goto finish;
+        if(nm_in.y_offset > array_count || in.count > array_count - nm_in.y_offset) {
+            out.ret = ALPHA_ERR_INVALID_ARGS;
+            goto finish;
+        }
+        local_y = (const char*)(array + nm_in.y_offset);
+    }
 
-    alpha_resource* resource = provider->resource;
+    if(in.count == 0) goto finish;
 
     /* lookup addresses */
-    hret = margo_addr_lookup(mid, in.x.address, &x_addr);
+    hret = alpha_addr_cache_lookup(provider->addr_cache, in.x.address, info->addr, &x_addr);
     if(hret != HG_SUCCESS) {
         margo_error(mid, "Could not lookup address for x buffer (mercury error %d)", hret);
         out.ret = ALPHA_ERR_FROM_MERCURY;
         goto finish;
     }
-    hret = margo_addr_lookup(mid, in.y.address, &y_addr);
-    if(hret != HG_SUCCESS) {
-        margo_error(mid, "Could not lookup address for y buffer (mercury error %d)", hret);
-        out.ret = ALPHA_ERR_FROM_MERCURY;
-        goto finish;
+    if(!local_y) {
+        hret = alpha_addr_cache_lookup(provider->addr_cache, in.y.address, info->addr, &y_addr);
+        if(hret != HG_SUCCESS) {
+            margo_error(mid, "Could not lookup address for y buffer (mercury error %d)", hret);
+            out.ret = ALPHA_ERR_FROM_MERCURY;
+            goto finish;
+        }
     }
-    hret = margo_addr_lookup(mid, in.result.address, &r_addr);
+    hret = alpha_addr_cache_lookup(provider->addr_cache, in.result.address, info->addr, &r_addr);
     if(hret != HG_SUCCESS) {
         margo_error(mid, "Could not lookup address for result buffer (mercury error %d)", hret);
         out.ret = ALPHA_ERR_FROM_MERCURY;
         goto finish;
     }
+    t = alpha_metrics_record_phase(metrics, rpc, ALPHA_PHASE_ADDR_LOOKUP, t);
 
-    /* allocate local buffers for x, y, and result */
-    hg_size_t x_buf_size = sizeof(int32_t)*in.count;
-    hg_size_t y_buf_size = sizeof(int32_t)*in.count;
-    hg_size_t r_buf_size = sizeof(int32_t)*in.count;
-    x_buf = (int32_t*)malloc(x_buf_size);
-    y_buf = (int32_t*)malloc(y_buf_size);
-    r_buf = (int32_t*)malloc(r_buf_size);
-
-    /* create bulk handles for x, y, and result */
-    hret = margo_bulk_create(mid, 1, (void**)&x_buf, &x_buf_size, HG_BULK_WRITE_ONLY, &x_local_bulk);
-    if(hret != HG_SUCCESS) {
-        margo_error(mid, "Could not create bulk handle for x buffer (mercury error %d)", hret);
-        out.ret = ALPHA_ERR_FROM_MERCURY;
+    /* large requests are streamed in chunks */
+    hg_size_t buf_size = elem_size*in.count;
+    if(provider->pipeline_chunk_size && buf_size > provider->pipeline_chunk_size) {
+        out.ret = alpha_sum_multi_pipelined(provider, resource, rpc, &in,
+                x_addr->addr, y_addr ? y_addr->addr : HG_ADDR_NULL, r_addr->addr, local_y);
         goto finish;
     }
-    hret = margo_bulk_create(mid, 1, (void**)&y_buf, &y_buf_size, HG_BULK_WRITE_ONLY, &y_local_bulk);
-    if(hret != HG_SUCCESS) {
-        margo_error(mid, "Could not create bulk handle for y buffer (mercury error %d)", hret);
-        out.ret = ALPHA_ERR_FROM_MERCURY;
+
+    /* borrow a registered buffer for x and y, the result overwriting y
+     * (y's half only holds the result if y is in local memory) */
+    out.ret = alpha_buffer_pool_get(provider->buffer_pool, 2*buf_size, &buffer);
+    if(out.ret != ALPHA_SUCCESS) {
+        margo_error(mid, "Could not get a buffer of size %lu from the buffer pool",
+                    (unsigned long)(2*buf_size));
         goto finish;
     }
-    hret = margo_bulk_create(mid, 1, (void**)&r_buf, &r_buf_size, HG_BULK_READ_ONLY, &r_local_bulk);
+    char* x_buf = (char*)buffer->data;
+    char* y_buf = x_buf + buf_size;
+
+    /* transfer input data, pulling x and y concurrently (or paging
+     * in y while x is pulled, if it is in a named array) */
+    t = alpha_metrics_start(metrics);
+    margo_request pulls[2] = {MARGO_REQUEST_NULL, MARGO_REQUEST_NULL};
+    hret = margo_bulk_itransfer(mid, HG_BULK_PULL, x_addr->addr, in.x.bulk, in.x.offset,
+                                buffer->bulk, 0, buf_size, &pulls[0]);
     if(hret != HG_SUCCESS) {
-        margo_error(mid, "Could not create bulk handle for result buffer (mercury error %d)", hret);
+        margo_error(mid, "Could not bulk transfer x data (mercury error %d)", hret);
         out.ret = ALPHA_ERR_FROM_MERCURY;
         goto finish;
     }
-
-    /* transfer input data */
-    hret = margo_bulk_transfer(mid, HG_BULK_PULL, x_addr, in.x.bulk, in.x.offset, x_local_bulk, 0, x_buf_size);
+    if(!local_y)
+        hret = margo_bulk_itransfer(mid, HG_BULK_PULL, y_addr->addr, in.y.bulk, in.y.offset,
+                                    buffer->bulk, buf_size, buf_size, &pulls[1]);
+    else if(rpc == ALPHA_METRICS_SUM_NAMED && resource->fn->prefetch)
+        resource->fn->prefetch(resource->ctx, (const int32_t*)local_y, in.count);
     if(hret != HG_SUCCESS) {
-        margo_error(mid, "Could not bulk transfer x data (mercury error %d)", hret);
+        margo_error(mid, "Could not bulk transfer y data (mercury error %d)", hret);
         out.ret = ALPHA_ERR_FROM_MERCURY;
+        alpha_wait_all(2, pulls);
         goto finish;
     }
-    hret = margo_bulk_transfer(mid, HG_BULK_PULL, y_addr, in.y.bulk, in.y.offset, y_local_bulk, 0, y_buf_size);
+    hret = alpha_wait_all(2, pulls);
     if(hret != HG_SUCCESS) {
-        margo_error(mid, "Could not bulk transfer y data (mercury error %d)", hret);
+        margo_error(mid, "Could not bulk transfer input data (mercury error %d)", hret);
         out.ret = ALPHA_ERR_FROM_MERCURY;
         goto finish;
     }
+    t = alpha_metrics_record_phase(metrics, rpc, ALPHA_PHASE_BULK_PULL, t);
 
-    /* call sum on the resource's context */
-    for(size_t i = 0; i < in.count; ++i)
-        r_buf[i] = resource->fn->sum(resource->ctx, x_buf[i], y_buf[i]);
+    /* call sum on the resource's context, unless the same
+     * operands have been summed recently (e.g. on a retry) */
+    alpha_provider_compute_cached(provider, resource, rpc, dtype, in.count, x_buf,
+            local_y ? local_y : y_buf, y_buf);
+    t = alpha_metrics_record_phase(metrics, rpc, ALPHA_PHASE_COMPUTE, t);
 
-    hret = margo_bulk_transfer(mid, HG_BULK_PUSH, r_addr,
-        in.result.bulk, in.result.offset, r_local_bulk, 0, r_buf_size);
+    hret = margo_bulk_transfer(mid, HG_BULK_PUSH, r_addr->addr,
+        in.result.bulk, in.result.offset, buffer->bulk, buf_size, buf_size);
     if(hret != HG_SUCCESS) {
         margo_error(mid, "Could not bulk transfer result data (mercury error %d)", hret);
         out.ret = ALPHA_ERR_FROM_MERCURY;
         goto finish;
     }
+    alpha_metrics_record_phase(metrics, rpc, ALPHA_PHASE_BULK_PUSH, t);
+    alpha_metrics_record_bytes(metrics, (local_y ? 1 : 2)*buf_size, buf_size);
 
-    margo_debug(mid, "Called sum_multi RPC");
+    margo_debug(mid, "Called %s RPC", rpc == ALPHA_METRICS_ACCUMULATE ? "accumulate"
+                                    : rpc == ALPHA_METRICS_SUM_STORED ? "sum_stored"
+                                    : rpc == ALPHA_METRICS_SUM_NAMED  ? "sum_named" : "sum_multi");
 
 finish:
+    t = alpha_metrics_start(metrics);
     hret = margo_respond(h, &out);
-    hret = margo_bulk_free(x_local_bulk);
-    hret = margo_bulk_free(y_local_bulk);
-    hret = margo_bulk_free(r_local_bulk);
-    hret = margo_addr_free(mid, x_addr);
-    hret = margo_addr_free(mid, y_addr);
-    hret = margo_addr_free(mid, r_addr);
-    hret = margo_free_input(h, &in);
+    alpha_metrics_record_phase(metrics, rpc, ALPHA_PHASE_RESPOND, t);
+    alpha_metrics_record_call(metrics, rpc, out.ret);
+    alpha_resource_release(resource);
+    alpha_array_store_release(provider->array_store, stored_y);
+    alpha_buffer_pool_release(provider->buffer_pool, buffer);
+    alpha_addr_cache_release(provider->addr_cache, x_addr);
+    alpha_addr_cache_release(provider->addr_cache, y_addr);
+    alpha_addr_cache_release(provider->addr_cache, r_addr);
+    if(admitted) alpha_admission_leave(provider->admission, scratch_size);
+    hret = margo_free_input(h, input);
     margo_destroy(h);
-    free(x_buf);
-    free(y_buf);
-    free(r_buf);
+}
+
+static void alpha_sum_multi_ult(hg_handle_t h)
+{
+    alpha_sum_bulk_handler(h, ALPHA_METRICS_SUM_MULTI);
 }
 static DEFINE_MARGO_RPC_HANDLER(alpha_sum_multi_ult)
 
-static inline alpha_backend_impl* find_backend_impl(const char* name)
+static void alpha_accumulate_ult(hg_handle_t h)
 {
-    for(size_t i = 0; i < ALPHA_MAX_NUM_BACKENDS; i++) {
-        alpha_backend_impl* impl = g_alpha_backend_types[i];
-        if(impl == NULL) return NULL;
-        if(strcmp(name, impl->name) == 0)
-            return impl;
-    }
-    return NULL;
+    alpha_sum_bulk_handler(h, ALPHA_METRICS_ACCUMULATE);
+}
+static DEFINE_MARGO_RPC_HANDLER(alpha_accumulate_ult)
+
+static void alpha_sum_stored_ult(hg_handle_t h)
+{
+    alpha_sum_bulk_handler(h, ALPHA_METRICS_SUM_STORED);
 }
+static DEFINE_MARGO_RPC_HANDLER(alpha_sum_stored_ult)
 
-static inline alpha_return_t add_backend_impl(
-        alpha_backend_impl* backend)
+static void alpha_sum_named_ult(hg_handle_t h)
 {
-    if(find_backend_impl(backend->name)) return ALPHA_SUCCESS;
-    for(size_t i = 0; i < ALPHA_MAX_NUM_BACKENDS; i++) {
-        if(g_alpha_backend_types[i]) continue;
-        g_alpha_backend_types[i] = backend;
-        return ALPHA_SUCCESS;
+    alpha_sum_bulk_handler(h, ALPHA_METRICS_SUM_NAMED);
+}
+static DEFINE_MARGO_RPC_HANDLER(alpha_sum_named_ult)
+
+/* The arrays of a sum_strided request are packed in a scratch buffer as
+ * they are pulled, then the result is unpacked as it is pushed back, small
+ * ranges going through a window of the buffer (see alpha_strided_transfer).
+ * Requests are not pipelined, so the scratch memory is proportional to
+ * their size. */
+static void alpha_sum_strided_ult(hg_handle_t h)
+{
+    hg_return_t       hret;
+    sum_strided_in_t  in;
+    sum_multi_out_t   out;
+    alpha_resource* resource = NULL;
+    alpha_buffer* buffer = NULL;
+    alpha_cached_addr* x_addr = NULL;
+    alpha_cached_addr* y_addr = NULL;
+    alpha_cached_addr* r_addr = NULL;
+    alpha_strided_plan x_plan, y_plan, r_plan;
+    size_t scratch_size = 0;
+    size_t pulled = 0, pushed = 0;
+    bool admitted = false;
+
+    out.ret = ALPHA_SUCCESS;
+    out.retry_after_ms = 0;
+
+    /* find the margo instance */
+    margo_instance_id mid = margo_hg_handle_get_instance(h);
+
+    /* find the provider */
+    const struct hg_info* info = margo_get_info(h);
+    alpha_provider_t provider = (alpha_provider_t)margo_registered_data(mid, info->id);
+    alpha_metrics* metrics = provider->metrics;
+    uint64_t t = alpha_metrics_start(metrics);
+
+    /* deserialize the input */
+    hret = margo_get_input(h, &in);
+    t = alpha_metrics_record_phase(metrics, ALPHA_METRICS_SUM_STRIDED, ALPHA_PHASE_DESERIALIZE, t);
+    if(hret != HG_SUCCESS) {
+        margo_error(mid, "Could not deserialize output (mercury error %d)", hret);
+        out.ret = ALPHA_ERR_FROM_MERCURY;
+        goto finish;
+    }
+    if(in.dtype > ALPHA_DTYPE_F64) {
+        out.ret = ALPHA_ERR_INVALID_ARGS;
+        goto finish;
+    }
+    alpha_dtype_t dtype = (alpha_dtype_t)in.dtype;
+    size_t elem_size    = alpha_dtype_size(dtype);
+
+    /* check the locations and find out how the arrays will be pulled,
+     * rejecting counts for which the scratch size would wrap around and
+     * bulk handles too small for the arrays they are said to hold */
+    if(in.count > SIZE_MAX/(2*elem_size)
+    || alpha_strided_plan_init(&in.x, in.count, elem_size, &x_plan) != ALPHA_SUCCESS
+    || alpha_strided_plan_init(&in.y, in.count, elem_size, &y_plan) != ALPHA_SUCCESS
+    || alpha_strided_plan_init(&in.result, in.count, elem_size, &r_plan) != ALPHA_SUCCESS
+    || !alpha_strided_plan_fits(&x_plan)
+    || !alpha_strided_plan_fits(&y_plan)
+    || !alpha_strided_plan_fits(&r_plan)) {
+        out.ret = ALPHA_ERR_INVALID_ARGS;
+        goto finish;
+    }
+    size_t buf_size    = elem_size*in.count;
+    size_t window_size = alpha_strided_plan_window_size(&x_plan);
+    if(alpha_strided_plan_window_size(&y_plan) > window_size)
+        window_size = alpha_strided_plan_window_size(&y_plan);
+    if(alpha_strided_plan_window_size(&r_plan) > window_size)
+        window_size = alpha_strided_plan_window_size(&r_plan);
+    if(2*buf_size > SIZE_MAX - window_size) {
+        out.ret = ALPHA_ERR_INVALID_ARGS;
+        goto finish;
+    }
+
+    /* the request will borrow space for x and y, and for a window
+     * shared by the transfers of the three arrays */
+    scratch_size = 2*buf_size + window_size;
+    out.ret = alpha_admission_enter(provider->admission, scratch_size, &out.retry_after_ms);
+    if(out.ret != ALPHA_SUCCESS) goto finish;
+    admitted = true;
+    t = alpha_metrics_record_phase(metrics, ALPHA_METRICS_SUM_STRIDED, ALPHA_PHASE_QUEUE, t);
+
+    resource = alpha_provider_acquire_resource(provider, in.resource_id);
+    if(!resource) {
+        out.ret = ALPHA_ERR_INVALID_RESOURCE;
+        goto finish;
     }
-    return ALPHA_ERR_ALLOCATION;
+
+    if(in.count == 0) goto finish;
+
+    /* lookup addresses */
+    hret = alpha_addr_cache_lookup(provider->addr_cache, in.x.address, info->addr, &x_addr);
+    if(hret == HG_SUCCESS)
+        hret = alpha_addr_cache_lookup(provider->addr_cache, in.y.address, info->addr, &y_addr);
+    if(hret == HG_SUCCESS)
+        hret = alpha_addr_cache_lookup(provider->addr_cache, in.result.address, info->addr, &r_addr);
+    if(hret != HG_SUCCESS) {
+        margo_error(mid, "Could not lookup address of a strided array (mercury error %d)", hret);
+        out.ret = ALPHA_ERR_FROM_MERCURY;
+        goto finish;
+    }
+    t = alpha_metrics_record_phase(metrics, ALPHA_METRICS_SUM_STRIDED, ALPHA_PHASE_ADDR_LOOKUP, t);
+
+    out.ret = alpha_buffer_pool_get(provider->buffer_pool, scratch_size, &buffer);
+    if(out.ret != ALPHA_SUCCESS) {
+        margo_error(mid, "Could not get a buffer of size %lu from the buffer pool",
+                    (unsigned long)scratch_size);
+        goto finish;
+    }
+    char* x_buf = (char*)buffer->data;
+    char* y_buf = x_buf + buf_size;
+
+    /* transfer input data, the result overwriting y */
+    t = alpha_metrics_start(metrics);
+    hret = alpha_strided_transfer(mid, HG_BULK_PULL, x_addr->addr, &x_plan, buffer->bulk,
+                                  (char*)buffer->data, 0, 2*buf_size, &pulled, &pushed);
+    if(hret == HG_SUCCESS)
+        hret = alpha_strided_transfer(mid, HG_BULK_PULL, y_addr->addr, &y_plan, buffer->bulk,
+                                      (char*)buffer->data, buf_size, 2*buf_size, &pulled, &pushed);
+    if(hret != HG_SUCCESS) {
+        margo_error(mid, "Could not bulk transfer input data (mercury error %d)", hret);
+        out.ret = ALPHA_ERR_FROM_MERCURY;
+        goto finish;
+    }
+    t = alpha_metrics_record_phase(metrics, ALPHA_METRICS_SUM_STRIDED, ALPHA_PHASE_BULK_PULL, t);
+
+    alpha_provider_compute_typed(provider, resource, dtype, in.count, x_buf, y_buf, y_buf);
+    t = alpha_metrics_record_phase(metrics, ALPHA_METRICS_SUM_STRIDED, ALPHA_PHASE_COMPUTE, t);
+
+    hret = alpha_strided_transfer(mid, HG_BULK_PUSH, r_addr->addr, &r_plan, buffer->bulk,
+                                  (char*)buffer->data, buf_size, 2*buf_size, &pulled, &pushed);
+    if(hret != HG_SUCCESS) {
+        margo_error(mid, "Could not bulk transfer result data (mercury error %d)", hret);
+        out.ret = ALPHA_ERR_FROM_MERCURY;
+        goto finish;
+    }
+    alpha_metrics_record_phase(metrics, ALPHA_METRICS_SUM_STRIDED, ALPHA_PHASE_BULK_PUSH, t);
+    alpha_metrics_record_bytes(metrics, pulled, pushed);
+
+    margo_debug(mid, "Called sum_strided RPC");
+
+finish:
+    t = alpha_metrics_start(metrics);
+    hret = margo_respond(h, &out);
+    alpha_metrics_record_phase(metrics, ALPHA_METRICS_SUM_STRIDED, ALPHA_PHASE_RESPOND, t);
+    alpha_metrics_record_call(metrics, ALPHA_METRICS_SUM_STRIDED, out.ret);
+    alpha_resource_release(resource);
+    alpha_buffer_pool_release(provider->buffer_pool, buffer);
+    alpha_addr_cache_release(provider->addr_cache, x_addr);
+    alpha_addr_cache_release(provider->addr_cache, y_addr);
+    alpha_addr_cache_release(provider->addr_cache, r_addr);
+    if(admitted) alpha_admission_leave(provider->admission, scratch_size);
+    hret = margo_free_input(h, &in);
+    margo_destroy(h);
+}
+static DEFINE_MARGO_RPC_HANDLER(alpha_sum_strided_ult)
+
+/* Streams a sum_multi request through a ring of ALPHA_PIPELINE_DEPTH chunk
+ * slots, so that pulling chunk N+1, computing chunk N, and pushing chunk N-1
+ * overlap. Each slot holds the x and y data of one chunk (the result
+ * overwriting y), hence the memory needed is bounded by the chunk size,
+ * not by the request size. If local_y is not NULL, y is read from it
+ * instead of being pulled, and y's half of the slots only holds results
+ * (if it is a named array, the resource is asked to prefetch each chunk
+ * of local_y when the previous one is computed, if it can). */
+static alpha_return_t alpha_sum_multi_pipelined(
+        alpha_provider_t provider, alpha_resource* resource,
+        alpha_metrics_rpc rpc, const sum_multi_in_t* in,
+        hg_addr_t x_addr, hg_addr_t y_addr, hg_addr_t r_addr,
+        const char* local_y)
+{
+    margo_instance_id mid = provider->mid;
+    alpha_return_t ret    = ALPHA_SUCCESS;
+    hg_return_t hret      = HG_SUCCESS;
+    alpha_buffer* buffer  = NULL;
+    /* since phases overlap, the time spent waiting on
+     * each phase is accumulated over all the chunks */
+    alpha_metrics* metrics = provider->metrics;
+    uint64_t pull_ns = 0, compute_ns = 0, push_ns = 0, t = 0;
+    /* pulls[s] holds the x and y pulls of slot s */
+    margo_request pulls[ALPHA_PIPELINE_DEPTH][2] = {{0}};
+    margo_request push[ALPHA_PIPELINE_DEPTH]     = {0};
+
+    alpha_dtype_t dtype = (alpha_dtype_t)in->dtype;
+    size_t elem_size    = alpha_dtype_size(dtype);
+    size_t chunk_count  = provider->pipeline_chunk_size / elem_size;
+    if(chunk_count == 0) chunk_count = 1;
+    hg_size_t chunk_size = chunk_count*elem_size;
+    hg_size_t slot_size  = 2*chunk_size;
+    size_t num_chunks    = (in->count + chunk_count - 1)/chunk_count;
+
+    ret = alpha_buffer_pool_get(provider->buffer_pool,
+            ALPHA_PIPELINE_DEPTH*slot_size, &buffer);
+    if(ret != ALPHA_SUCCESS) {
+        margo_error(mid, "Could not get a buffer of size %lu from the buffer pool",
+                    (unsigned long)(ALPHA_PIPELINE_DEPTH*slot_size));
+        return ret;
+    }
+
+#define CHUNK_COUNT(i) \
+    (((i) + 1 == num_chunks) ? in->count - (i)*chunk_count : chunk_count)
+#define SLOT_OFFSET(i) (((i) % ALPHA_PIPELINE_DEPTH)*slot_size)
+
+    /* start pulling the first chunk */
+    hret = margo_bulk_itransfer(mid, HG_BULK_PULL, x_addr, in->x.bulk, in->x.offset,
+            buffer->bulk, SLOT_OFFSET(0), CHUNK_COUNT(0)*elem_size, &pulls[0][0]);
+    if(hret == HG_SUCCESS && !local_y)
+        hret = margo_bulk_itransfer(mid, HG_BULK_PULL, y_addr, in->y.bulk, in->y.offset,
+                buffer->bulk, SLOT_OFFSET(0) + chunk_size, CHUNK_COUNT(0)*elem_size, &pulls[0][1]);
+    void (*prefetch)(void*, const int32_t*, size_t) =
+        rpc == ALPHA_METRICS_SUM_NAMED ? resource->fn->prefetch : NULL;
+    if(prefetch)
+        prefetch(resource->ctx, (const int32_t*)local_y, CHUNK_COUNT(0));
+
+    for(size_t i = 0; i < num_chunks && hret == HG_SUCCESS; ++i) {
+        size_t s = i % ALPHA_PIPELINE_DEPTH;
+        /* start pulling chunk i+1 in the slot used by chunk i-2,
+         * after the result of chunk i-2 has been pushed */
+        if(i + 1 < num_chunks) {
+            size_t n = (i + 1) % ALPHA_PIPELINE_DEPTH;
+            hg_size_t remote_offset = (i + 1)*chunk_size;
+            hg_size_t size = CHUNK_COUNT(i + 1)*elem_size;
+            t = alpha_metrics_start(metrics);
+            hret = alpha_wait_request(&push[n]);
+            push_ns += alpha_metrics_elapsed(metrics, t);
+            if(hret != HG_SUCCESS) {
+                margo_error(mid, "Could not bulk transfer result data (mercury error %d)", hret);
+                break;
+            }
+            hret = margo_bulk_itransfer(mid, HG_BULK_PULL, x_addr, in->x.bulk,
+                    in->x.offset + remote_offset, buffer->bulk, SLOT_OFFSET(i + 1),
+                    size, &pulls[n][0]);
+            if(hret != HG_SUCCESS) break;
+            if(!local_y)
+                hret = margo_bulk_itransfer(mid, HG_BULK_PULL, y_addr, in->y.bulk,
+                        in->y.offset + remote_offset, buffer->bulk, SLOT_OFFSET(i + 1) + chunk_size,
+                        size, &pulls[n][1]);
+            else if(prefetch)
+                prefetch(resource->ctx, (const int32_t*)(local_y + remote_offset), CHUNK_COUNT(i + 1));
+            if(hret != HG_SUCCESS) break;
+        }
+        /* wait for chunk i to be available */
+        t = alpha_metrics_start(metrics);
+        hret = alpha_wait_all(2, pulls[s]);
+        pull_ns += alpha_metrics_elapsed(metrics, t);
+        if(hret != HG_SUCCESS) {
+            margo_error(mid, "Could not bulk transfer input data (mercury error %d)", hret);
+            break;
+        }
+        /* compute chunk i and start pushing its result */
+        char* x_buf = (char*)buffer->data + SLOT_OFFSET(i);
+        char* y_buf = x_buf + chunk_size;
+        t = alpha_metrics_start(metrics);
+        const char* y_src = local_y ? local_y + i*chunk_size : y_buf;
+        alpha_provider_compute_cached(provider, resource, rpc, dtype, CHUNK_COUNT(i), x_buf, y_src, y_buf);
+        compute_ns += alpha_metrics_elapsed(metrics, t);
+        hret = margo_bulk_itransfer(mid, HG_BULK_PUSH, r_addr, in->result.bulk,
+                in->result.offset + i*chunk_size, buffer->bulk, SLOT_OFFSET(i) + chunk_size,
+                CHUNK_COUNT(i)*elem_size, &push[s]);
+    }
+
+#undef CHUNK_COUNT
+#undef SLOT_OFFSET
+
+    /* wait for all the remaining operations before releasing the buffer */
+    hg_return_t pulls_hret = alpha_wait_all(2*ALPHA_PIPELINE_DEPTH, &pulls[0][0]);
+    t = alpha_metrics_start(metrics);
+    hg_return_t push_hret  = alpha_wait_all(ALPHA_PIPELINE_DEPTH, push);
+    push_ns += alpha_metrics_elapsed(metrics, t);
+    if(hret == HG_SUCCESS) hret = pulls_hret;
+    if(hret == HG_SUCCESS) hret = push_hret;
+    if(hret != HG_SUCCESS) {
+        margo_error(mid, "Pipelined sum_multi failed (mercury error %d)", hret);
+        ret = ALPHA_ERR_FROM_MERCURY;
+    } else {
+        alpha_metrics_record_duration(metrics, rpc, ALPHA_PHASE_BULK_PULL, pull_ns);
+        alpha_metrics_record_duration(metrics, rpc, ALPHA_PHASE_COMPUTE, compute_ns);
+        alpha_metrics_record_duration(metrics, rpc, ALPHA_PHASE_BULK_PUSH, push_ns);
+        alpha_metrics_record_bytes(metrics, (local_y ? 1 : 2)*in->count*elem_size,
+                                   in->count*elem_size);
+    }
+
+    alpha_buffer_pool_release(provider->buffer_pool, buffer);
+    return ret;
+}
+
+static inline void alpha_resource_sum_batch(
+        alpha_resource* resource, size_t count,
+        const int32_t* x, const int32_t* y, int32_t* r)
+{
+    if(resource->fn->sum_batch) {
+        resource->fn->sum_batch(resource->ctx, count, x, y, r);
+        return;
+    }
+    for(size_t i = 0; i < count; ++i)
+        r[i] = resource->fn->sum(resource->ctx, x[i], y[i]);
+}
+
+/* Reduces x (and y for ALPHA_REDUCE_DOT) with the resource's backend,
+ * or with generic loops if the backend doesn't provide reductions */
+static int64_t alpha_resource_reduce(
+        alpha_resource* resource, alpha_reduce_op_t op, size_t count,
+        const int32_t* x, const int32_t* y)
+{
+    if(op == ALPHA_REDUCE_DOT) {
+        if(resource->fn->dot)
+            return resource->fn->dot(resource->ctx, count, x, y);
+        uint64_t s = 0;
+        for(size_t i = 0; i < count; ++i)
+            s += (uint64_t)((int64_t)x[i]*(int64_t)y[i]);
+        return (int64_t)s;
+    }
+    if(resource->fn->reduce)
+        return resource->fn->reduce(resource->ctx, op, count, x);
+    uint64_t s = 0;
+    int32_t min = INT32_MAX, max = INT32_MIN;
+    for(size_t i = 0; i < count; ++i) {
+        s  += (uint64_t)(int64_t)x[i];
+        min = x[i] < min ? x[i] : min;
+        max = x[i] > max ? x[i] : max;
+    }
+    return op == ALPHA_REDUCE_MIN ? min : op == ALPHA_REDUCE_MAX ? max : (int64_t)s;
+}
+
+/* Combines the partial results of a reduction over two parts of an array */
+static inline int64_t alpha_reduce_combine(alpha_reduce_op_t op, int64_t a, int64_t b)
+{
+    switch(op) {
+    case ALPHA_REDUCE_MIN: return b < a ? b : a;
+    case ALPHA_REDUCE_MAX: return b > a ? b : a;
+    default:               return (int64_t)((uint64_t)a + (uint64_t)b);
+    }
+}
+
+typedef struct alpha_sum_task {
+    alpha_resource* resource;
+    alpha_dtype_t   dtype;
+    size_t          count;
+    const void*     x;
+    const void*     y;
+    void*           r;
+    ABT_thread      thread;
+} alpha_sum_task;
+
+/* Computes a sum in the calling ULT, without splitting it */
+static void alpha_resource_sum_typed(
+        alpha_resource* resource, alpha_dtype_t dtype,
+        size_t count, const void* x, const void* y, void* r)
+{
+    if(dtype == ALPHA_DTYPE_I32) {
+        alpha_resource_sum_batch(resource, count,
+                (const int32_t*)x, (const int32_t*)y, (int32_t*)r);
+        return;
+    }
+    if(resource->fn->sum_typed
+    && resource->fn->sum_typed(resource->ctx, dtype, count, x, y, r) == ALPHA_SUCCESS)
+        return;
+    alpha_typed_sum(dtype, count, x, y, r);
+}
+
+static void alpha_sum_task_ult(void* arg)
+{
+    alpha_sum_task* task = (alpha_sum_task*)arg;
+    alpha_resource_sum_typed(task->resource, task->dtype, task->count, task->x, task->y, task->r);
+}
+
+static void alpha_provider_compute_sum(
+        alpha_provider_t provider, alpha_resource* resource, size_t count,
+        const int32_t* x, const int32_t* y, int32_t* r)
+{
+    alpha_provider_compute_typed(provider, resource, ALPHA_DTYPE_I32, count, x, y, r);
+}
+
+static void alpha_provider_compute_typed(
+        alpha_provider_t provider, alpha_resource* resource, alpha_dtype_t dtype,
+        size_t count, const void* x, const void* y, void* r)
+{
+    /* tasks are sized in bytes, in units of int32_t, so that
+     * min_task_size means the same amount of work for every type */
+    size_t elem_size = alpha_dtype_size(dtype);
+    size_t size      = count*elem_size;
+    size_t units     = size/sizeof(int32_t);
+    if(provider->compute_pool == ABT_POOL_NULL || units < provider->compute_min_task_size) {
+        alpha_resource_sum_typed(resource, dtype, count, x, y, r);
+        return;
+    }
+
+    size_t num_tasks = units / provider->compute_min_task_size;
+    if(num_tasks > provider->compute_max_tasks) num_tasks = provider->compute_max_tasks;
+    if(num_tasks > size/64) num_tasks = size/64;
+    if(num_tasks <= 1) {
+        alpha_resource_sum_typed(resource, dtype, count, x, y, r);
+        return;
+    }
+    alpha_sum_task* tasks = (alpha_sum_task*)calloc(num_tasks, sizeof(*tasks));
+    if(!tasks) {
+        alpha_resource_sum_typed(resource, dtype, count, x, y, r);
+        return;
+    }
+
+    /* the calling ULT only waits for the tasks, so that its execution stream
+     * remains available to handle other RPCs; task boundaries are multiples
+     * of 64 bytes so that each task starts on a SIMD-friendly offset */
+    size_t align = 64/elem_size;
+    for(size_t i = 0; i < num_tasks; ++i) {
+        size_t start = (i*count/num_tasks) & ~(align - 1);
+        size_t end   = (i + 1 == num_tasks) ? count : ((i + 1)*count/num_tasks) & ~(align - 1);
+        tasks[i].resource = resource;
+        tasks[i].dtype    = dtype;
+        tasks[i].count    = end - start;
+        tasks[i].x        = (const char*)x + start*elem_size;
+        tasks[i].y        = (const char*)y + start*elem_size;
+        tasks[i].r        = (char*)r + start*elem_size;
+        if(ABT_thread_create(provider->compute_pool, alpha_sum_task_ult, &tasks[i],
+                             ABT_THREAD_ATTR_NULL, &tasks[i].thread) != ABT_SUCCESS) {
+            tasks[i].thread = ABT_THREAD_NULL;
+            alpha_sum_task_ult(&tasks[i]);
+        }
+    }
+    for(size_t i = 0; i < num_tasks; ++i) {
+        if(tasks[i].thread == ABT_THREAD_NULL) continue;
+        ABT_thread_join(tasks[i].thread);
+        ABT_thread_free(&tasks[i].thread);
+    }
+    free(tasks);
+}
+
+static void alpha_provider_compute_cached(
+        alpha_provider_t provider, alpha_resource* resource, alpha_metrics_rpc rpc,
+        alpha_dtype_t dtype, size_t count, const void* x, const void* y, void* r)
+{
+    alpha_result_cache_t cache = provider->result_cache;
+    if((rpc != ALPHA_METRICS_SUM_MULTI && rpc != ALPHA_METRICS_SUM_BATCH)
+    || !alpha_result_cache_enabled(cache)) {
+        alpha_provider_compute_typed(provider, resource, dtype, count, x, y, r);
+        return;
+    }
+    /* r may alias y, so the key and the copies of the
+     * operands kept by the cache are made before the sum */
+    size_t size = count*alpha_dtype_size(dtype);
+    alpha_result_key key;
+    alpha_result_cache_key(resource->serial, dtype, count, x, y, size, &key);
+    if(alpha_result_cache_get(cache, &key, x, y, r, size))
+        return;
+    alpha_cached_result_t entry = alpha_result_cache_prepare(cache, &key, x, y, size);
+    alpha_provider_compute_typed(provider, resource, dtype, count, x, y, r);
+    alpha_result_cache_put(cache, entry, r);
+}
+
+static void alpha_sum_batch_ult(hg_handle_t h)
+{
+    hg_return_t     hret;
+    sum_batch_in_t  in = {0};
+    sum_batch_out_t out = {0};
+    alpha_resource* resource = NULL;
+    size_t scratch_size = 0;
+    bool admitted = false;
+
+    /* find the margo instance */
+    margo_instance_id mid = margo_hg_handle_get_instance(h);
+
+    /* find the provider */
+    const struct hg_info* info = margo_get_info(h);
+    alpha_provider_t provider = (alpha_provider_t)margo_registered_data(mid, info->id);
+    alpha_metrics* metrics = provider->metrics;
+    uint64_t t = alpha_metrics_start(metrics);
+
+    /* deserialize the input */
+    hret = margo_get_input(h, &in);
+    t = alpha_metrics_record_phase(metrics, ALPHA_METRICS_SUM_BATCH, ALPHA_PHASE_DESERIALIZE, t);
+    if(hret != HG_SUCCESS) {
+        margo_error(mid, "Could not deserialize output (mercury error %d)", hret);
+        out.ret = ALPHA_ERR_FROM_MERCURY;
+        goto finish;
+    }
+
+    /* the x and y arrays have been allocated when deserializing the input,
+     * which rejects counts above ALPHA_MAX_INLINE_COUNT */
+    if(in.count > ALPHA_MAX_INLINE_COUNT) {
+        out.ret = ALPHA_ERR_INVALID_ARGS;
+        goto finish;
+    }
+    scratch_size = 2*sizeof(int32_t)*in.count;
+    out.ret = alpha_admission_enter(provider->admission, scratch_size, &out.retry_after_ms);
+    if(out.ret != ALPHA_SUCCESS) goto finish;
+    admitted = true;
+    t = alpha_metrics_record_phase(metrics, ALPHA_METRICS_SUM_BATCH, ALPHA_PHASE_QUEUE, t);
+
+    resource = alpha_provider_acquire_resource(provider, in.resource_id);
+    if(!resource) {
+        out.ret = ALPHA_ERR_INVALID_RESOURCE;
+        goto finish;
+    }
+
+    /* compute the sums in place in the x array, which is sent back,
+     * unless the same operands have been summed recently */
+    alpha_provider_compute_cached(provider, resource, ALPHA_METRICS_SUM_BATCH,
+            ALPHA_DTYPE_I32, in.count, in.x, in.y, in.x);
+    out.ret    = ALPHA_SUCCESS;
+    out.count  = in.count;
+    out.result = in.x;
+    alpha_metrics_record_phase(metrics, ALPHA_METRICS_SUM_BATCH, ALPHA_PHASE_COMPUTE, t);
+
+    margo_debug(mid, "Called sum_batch RPC");
+
+finish:
+    t = alpha_metrics_start(metrics);
+    hret = margo_respond(h, &out);
+    alpha_metrics_record_phase(metrics, ALPHA_METRICS_SUM_BATCH, ALPHA_PHASE_RESPOND, t);
+    alpha_metrics_record_call(metrics, ALPHA_METRICS_SUM_BATCH, out.ret);
+    alpha_resource_release(resource);
+    if(admitted) alpha_admission_leave(provider->admission, scratch_size);
+    hret = margo_free_input(h, &in);
+    margo_destroy(h);
+}
+static DEFINE_MARGO_RPC_HANDLER(alpha_sum_batch_ult)
+
+static void alpha_stats_ult(hg_handle_t h)
+{
+    stats_out_t out = {0};
+    char* stats = NULL;
+
+    /* find the margo instance */
+    margo_instance_id mid = margo_hg_handle_get_instance(h);
+
+    /* find the provider */
+    const struct hg_info* info = margo_get_info(h);
+    alpha_provider_t provider = (alpha_provider_t)margo_registered_data(mid, info->id);
+
+    if(!provider->stats_rpc) {
+        out.ret = ALPHA_ERR_OP_FORBIDDEN;
+        goto finish;
+    }
+
+    stats = alpha_provider_get_stats(provider);
+    if(!stats) {
+        out.ret = ALPHA_ERR_ALLOCATION;
+        goto finish;
+    }
+    out.ret   = ALPHA_SUCCESS;
+    out.stats = stats;
+
+    margo_debug(mid, "Called stats RPC");
+
+finish:
+    margo_respond(h, &out);
+    free(stats);
+    margo_destroy(h);
+}
+static DEFINE_MARGO_RPC_HANDLER(alpha_stats_ult)
+
+static void alpha_shm_attach_ult(hg_handle_t h)
+{
+    hg_return_t      hret;
+    shm_attach_in_t  in;
+    shm_attach_out_t out = {0};
+
+    /* find the margo instance */
+    margo_instance_id mid = margo_hg_handle_get_instance(h);
+
+    /* find the provider */
+    const struct hg_info* info = margo_get_info(h);
+    alpha_provider_t provider = (alpha_provider_t)margo_registered_data(mid, info->id);
+
+    /* deserialize the input */
+    hret = margo_get_input(h, &in);
+    if(hret != HG_SUCCESS) {
+        margo_error(mid, "Could not deserialize output (mercury error %d)", hret);
+        out.ret = ALPHA_ERR_FROM_MERCURY;
+        goto finish;
+    }
+
+    if(!provider->shm_enabled) {
+        out.ret = ALPHA_ERR_OP_FORBIDDEN;
+        goto finish;
+    }
+
+    alpha_shm_segment* segment = (alpha_shm_segment*)calloc(1, sizeof(*segment));
+    if(!segment) {
+        out.ret = ALPHA_ERR_ALLOCATION;
+        goto finish;
+    }
+    /* this fails if the client is on another node */
+    if(in.size >= ALPHA_SHM_DATA_OFFSET)
+        segment->base = alpha_shm_map(in.name, in.size, false);
+    if(segment->base
+    && ((alpha_shm_header*)segment->base)->token != in.token) {
+        munmap(segment->base, in.size);
+        segment->base = NULL;
+    }
+    if(!segment->base) {
+        margo_debug(mid, "Could not map shared-memory segment %s", in.name);
+        free(segment);
+        out.ret = ALPHA_ERR_OP_UNSUPPORTED;
+        goto finish;
+    }
+    segment->size     = in.size;
+    segment->refcount = 1;
+
+    ABT_mutex_lock(provider->shm_lock);
+    segment->id  = provider->shm_next_id++;
+    segment->next = provider->shm_segments;
+    provider->shm_segments = segment;
+    ABT_mutex_unlock(provider->shm_lock);
+
+    out.ret        = ALPHA_SUCCESS;
+    out.segment_id = segment->id;
+
+    margo_debug(mid, "Attached shared-memory segment %s", in.name);
+
+finish:
+    hret = margo_respond(h, &out);
+    hret = margo_free_input(h, &in);
+    margo_destroy(h);
+}
+static DEFINE_MARGO_RPC_HANDLER(alpha_shm_attach_ult)
+
+static void alpha_shm_detach_ult(hg_handle_t h)
+{
+    hg_return_t      hret;
+    shm_detach_in_t  in;
+    shm_detach_out_t out = {0};
+    alpha_shm_segment* segment = NULL;
+
+    /* find the margo instance */
+    margo_instance_id mid = margo_hg_handle_get_instance(h);
+
+    /* find the provider */
+    const struct hg_info* info = margo_get_info(h);
+    alpha_provider_t provider = (alpha_provider_t)margo_registered_data(mid, info->id);
+
+    /* deserialize the input */
+    hret = margo_get_input(h, &in);
+    if(hret != HG_SUCCESS) {
+        margo_error(mid, "Could not deserialize output (mercury error %d)", hret);
+        out.ret = ALPHA_ERR_FROM_MERCURY;
+        goto finish;
+    }
+
+    /* remove the segment from the list, it is unmapped
+     * when no RPC is using it anymore */
+    ABT_mutex_lock(provider->shm_lock);
+    alpha_shm_segment** s = &provider->shm_segments;
+    while(*s && (*s)->id != in.segment_id) s = &(*s)->next;
+    segment = *s;
+    if(segment) *s = segment->next;
+    ABT_mutex_unlock(provider->shm_lock);
+
+    out.ret = segment ? ALPHA_SUCCESS : ALPHA_ERR_INVALID_ARGS;
+    alpha_shm_segment_release(segment);
+
+finish:
+    hret = margo_respond(h, &out);
+    hret = margo_free_input(h, &in);
+    margo_destroy(h);
+}
+static DEFINE_MARGO_RPC_HANDLER(alpha_shm_detach_ult)
+
+/* The data is pulled directly into the stored array, whose id is only
+ * valid once the whole array has been pulled */
+static void alpha_array_store_ult(hg_handle_t h)
+{
+    hg_return_t       hret;
+    array_store_in_t  in;
+    array_store_out_t out = {0};
+    alpha_stored_array* array = NULL;
+    alpha_cached_addr* addr = NULL;
+    hg_bulk_t local_bulk = HG_BULK_NULL;
+
+    /* find the margo instance */
+    margo_instance_id mid = margo_hg_handle_get_instance(h);
+
+    /* find the provider */
+    const struct hg_info* info = margo_get_info(h);
+    alpha_provider_t provider = (alpha_provider_t)margo_registered_data(mid, info->id);
+
+    /* deserialize the input */
+    hret = margo_get_input(h, &in);
+    if(hret != HG_SUCCESS) {
+        margo_error(mid, "Could not deserialize output (mercury error %d)", hret);
+        out.ret = ALPHA_ERR_FROM_MERCURY;
+        goto finish;
+    }
+    if(in.dtype > ALPHA_DTYPE_F64) {
+        out.ret = ALPHA_ERR_INVALID_ARGS;
+        goto finish;
+    }
+
+    out.ret = alpha_array_store_reserve(provider->array_store,
+            (alpha_dtype_t)in.dtype, in.count, &array);
+    if(out.ret != ALPHA_SUCCESS) goto finish;
+
+    hret = alpha_addr_cache_lookup(provider->addr_cache, in.data.address, info->addr, &addr);
+    if(hret != HG_SUCCESS) {
+        margo_error(mid, "Could not lookup address for array data (mercury error %d)", hret);
+        out.ret = ALPHA_ERR_FROM_MERCURY;
+        goto finish;
+    }
+    void* ptrs[1] = { array->data };
+    hg_size_t sizes[1] = { array->size };
+    hret = margo_bulk_create(mid, 1, ptrs, sizes, HG_BULK_WRITE_ONLY, &local_bulk);
+    if(hret == HG_SUCCESS)
+        hret = margo_bulk_transfer(mid, HG_BULK_PULL, addr->addr, in.data.bulk, in.data.offset,
+                                   local_bulk, 0, array->size);
+    if(hret != HG_SUCCESS) {
+        margo_error(mid, "Could not bulk transfer array data (mercury error %d)", hret);
+        out.ret = ALPHA_ERR_FROM_MERCURY;
+        goto finish;
+    }
+
+    out.array_id = alpha_array_store_publish(provider->array_store, array);
+    array = NULL;
+
+finish:
+    if(array) alpha_array_store_discard(provider->array_store, array);
+    margo_bulk_free(local_bulk);
+    alpha_addr_cache_release(provider->addr_cache, addr);
+    hret = margo_respond(h, &out);
+    hret = margo_free_input(h, &in);
+    margo_destroy(h);
+}
+static DEFINE_MARGO_RPC_HANDLER(alpha_array_store_ult)
+
+static void alpha_array_remove_ult(hg_handle_t h)
+{
+    hg_return_t        hret;
+    array_remove_in_t  in;
+    array_remove_out_t out = {0};
+
+    /* find the margo instance */
+    margo_instance_id mid = margo_hg_handle_get_instance(h);
+
+    /* find the provider */
+    const struct hg_info* info = margo_get_info(h);
+    alpha_provider_t provider = (alpha_provider_t)margo_registered_data(mid, info->id);
+
+    /* deserialize the input */
+    hret = margo_get_input(h, &in);
+    if(hret != HG_SUCCESS) {
+        margo_error(mid, "Could not deserialize output (mercury error %d)", hret);
+        out.ret = ALPHA_ERR_FROM_MERCURY;
+        goto finish;
+    }
+
+    /* the array is freed when no RPC is using it anymore */
+    out.ret = alpha_array_store_remove(provider->array_store, in.array_id);
+
+finish:
+    hret = margo_respond(h, &out);
+    hret = margo_free_input(h, &in);
+    margo_destroy(h);
+}
+static DEFINE_MARGO_RPC_HANDLER(alpha_array_remove_ult)
+
+static void alpha_named_create_ult(hg_handle_t h)
+{
+    hg_return_t       hret;
+    named_create_in_t in;
+    named_array_out_t out = {0};
+    alpha_resource* resource = NULL;
+    int32_t* array = NULL;
+
+    /* find the margo instance */
+    margo_instance_id mid = margo_hg_handle_get_instance(h);
+
+    /* find the provider */
+    const struct hg_info* info = margo_get_info(h);
+    alpha_provider_t provider = (alpha_provider_t)margo_registered_data(mid, info->id);
+
+    /* deserialize the input */
+    hret = margo_get_input(h, &in);
+    if(hret != HG_SUCCESS) {
+        margo_error(mid, "Could not deserialize output (mercury error %d)", hret);
+        out.ret = ALPHA_ERR_FROM_MERCURY;
+        goto finish;
+    }
+
+    resource = alpha_provider_acquire_resource(provider, in.resource_id);
+    if(!resource) {
+        out.ret = ALPHA_ERR_INVALID_RESOURCE;
+        goto finish;
+    }
+    if(!resource->fn->create_array) {
+        out.ret = ALPHA_ERR_OP_UNSUPPORTED;
+        goto finish;
+    }
+    out.ret = resource->fn->create_array(resource->ctx, in.name, in.count, &array);
+
+finish:
+    alpha_resource_release(resource);
+    hret = margo_respond(h, &out);
+    hret = margo_free_input(h, &in);
+    margo_destroy(h);
+}
+static DEFINE_MARGO_RPC_HANDLER(alpha_named_create_ult)
+
+/* Copies data between a client's memory and a named array, in chunks of
+ * pipeline_chunk_size bytes (or in one go if pipelining is disabled) staged
+ * in a buffer of the pool, so that the array's memory is never registered.
+ * When reading, the next chunk is prefetched while one is pushed. */
+static void alpha_named_io_ult(hg_handle_t h)
+{
+    hg_return_t       hret;
+    named_io_in_t     in;
+    named_array_out_t out = {0};
+    alpha_resource* resource = NULL;
+    alpha_buffer* buffer = NULL;
+    alpha_cached_addr* addr = NULL;
+    int32_t* array = NULL;
+    size_t array_count = 0;
+
+    /* find the margo instance */
+    margo_instance_id mid = margo_hg_handle_get_instance(h);
+
+    /* find the provider */
+    const struct hg_info* info = margo_get_info(h);
+    alpha_provider_t provider = (alpha_provider_t)margo_registered_data(mid, info->id);
+
+    /* deserialize the input */
+    hret = margo_get_input(h, &in);
+    if(hret != HG_SUCCESS) {
+        margo_error(mid, "Could not deserialize output (mercury error %d)", hret);
+        out.ret = ALPHA_ERR_FROM_MERCURY;
+        goto finish;
+    }
+
+    /* the array stays valid as long as we hold the resource */
+    resource = alpha_provider_acquire_resource(provider, in.resource_id);
+    if(!resource) {
+        out.ret = ALPHA_ERR_INVALID_RESOURCE;
+        goto finish;
+    }
+    if(!resource->fn->find_array) {
+        out.ret = ALPHA_ERR_OP_UNSUPPORTED;
+        goto finish;
+    }
+    out.ret = resource->fn->find_array(resource->ctx, in.name, &array, &array_count);
+    if(out.ret != ALPHA_SUCCESS) goto finish;
+    if(in.offset > array_count || in.count > array_count - in.offset) {
+        out.ret = ALPHA_ERR_INVALID_ARGS;
+        goto finish;
+    }
+    if(in.count == 0) goto finish;
+
+    hret = alpha_addr_cache_lookup(provider->addr_cache, in.data.address, info->addr, &addr);
+    if(hret != HG_SUCCESS) {
+        margo_error(mid, "Could not lookup address for array data (mercury error %d)", hret);
+        out.ret = ALPHA_ERR_FROM_MERCURY;
+        goto finish;
+    }
+
+    size_t chunk_count = provider->pipeline_chunk_size / sizeof(int32_t);
+    if(chunk_count == 0 || chunk_count > in.count) chunk_count = in.count;
+    out.ret = alpha_buffer_pool_get(provider->buffer_pool, chunk_count*sizeof(int32_t), &buffer);
+    if(out.ret != ALPHA_SUCCESS) {
+        margo_error(mid, "Could not get a buffer of size %lu from the buffer pool",
+                    (unsigned long)(chunk_count*sizeof(int32_t)));
+        goto finish;
+    }
+
+    int32_t* data = array + in.offset;
+    for(size_t i = 0; i < in.count; i += chunk_count) {
+        size_t n = in.count - i < chunk_count ? in.count - i : chunk_count;
+        hg_size_t size = n*sizeof(int32_t);
+        hg_size_t remote_offset = in.data.offset + i*sizeof(int32_t);
+        if(in.write) {
+            hret = margo_bulk_transfer(mid, HG_BULK_PULL, addr->addr, in.data.bulk, remote_offset,
+                                       buffer->bulk, 0, size);
+            if(hret != HG_SUCCESS) break;
+            memcpy(data + i, buffer->data, size);
+        } else {
+            memcpy(buffer->data, data + i, size);
+            if(resource->fn->prefetch && i + n < in.count)
+                resource->fn->prefetch(resource->ctx, data + i + n,
+                        in.count - i - n < chunk_count ? in.count - i - n : chunk_count);
+            hret = margo_bulk_transfer(mid, HG_BULK_PUSH, addr->addr, in.data.bulk, remote_offset,
+                                       buffer->bulk, 0, size);
+            if(hret != HG_SUCCESS) break;
+        }
+    }
+    if(hret != HG_SUCCESS) {
+        margo_error(mid, "Could not bulk transfer array data (mercury error %d)", hret);
+        out.ret = ALPHA_ERR_FROM_MERCURY;
+    }
+
+finish:
+    alpha_buffer_pool_release(provider->buffer_pool, buffer);
+    alpha_addr_cache_release(provider->addr_cache, addr);
+    alpha_resource_release(resource);
+    hret = margo_respond(h, &out);
+    hret = margo_free_input(h, &in);
+    margo_destroy(h);
+}
+static DEFINE_MARGO_RPC_HANDLER(alpha_named_io_ult)
+
+/* Returns the segment with the given id, or NULL if there is none.
+ * The segment must be released with alpha_shm_segment_release. */
+static alpha_shm_segment* alpha_provider_acquire_shm_segment(
+        alpha_provider_t provider,
+        uint64_t segment_id)
+{
+    ABT_mutex_lock(provider->shm_lock);
+    alpha_shm_segment* segment = provider->shm_segments;
+    while(segment && segment->id != segment_id) segment = segment->next;
+    /* atomic since alpha_shm_segment_release doesn't take the lock */
+    if(segment) __atomic_add_fetch(&segment->refcount, 1, __ATOMIC_RELAXED);
+    ABT_mutex_unlock(provider->shm_lock);
+    return segment;
+}
+
+static void alpha_shm_segment_release(alpha_shm_segment* segment)
+{
+    if(!segment) return;
+    if(__atomic_sub_fetch(&segment->refcount, 1, __ATOMIC_ACQ_REL) != 0)
+        return;
+    munmap(segment->base, segment->size);
+    free(segment);
+}
+
+static void alpha_sum_shm_ult(hg_handle_t h)
+{
+    hg_return_t     hret;
+    sum_shm_in_t    in;
+    sum_multi_out_t out = {0};
+    alpha_resource* resource = NULL;
+    alpha_shm_segment* segment = NULL;
+    bool admitted = false;
+
+    /* find the margo instance */
+    margo_instance_id mid = margo_hg_handle_get_instance(h);
+
+    /* find the provider */
+    const struct hg_info* info = margo_get_info(h);
+    alpha_provider_t provider = (alpha_provider_t)margo_registered_data(mid, info->id);
+    alpha_metrics* metrics = provider->metrics;
+    uint64_t t = alpha_metrics_start(metrics);
+
+    /* deserialize the input */
+    hret = margo_get_input(h, &in);
+    t = alpha_metrics_record_phase(metrics, ALPHA_METRICS_SUM_SHM, ALPHA_PHASE_DESERIALIZE, t);
+    if(hret != HG_SUCCESS) {
+        margo_error(mid, "Could not deserialize output (mercury error %d)", hret);
+        out.ret = ALPHA_ERR_FROM_MERCURY;
+        goto finish;
+    }
+
+    /* the operands are in the segment, hence no scratch memory */
+    out.ret = alpha_admission_enter(provider->admission, 0, &out.retry_after_ms);
+    if(out.ret != ALPHA_SUCCESS) goto finish;
+    admitted = true;
+    t = alpha_metrics_record_phase(metrics, ALPHA_METRICS_SUM_SHM, ALPHA_PHASE_QUEUE, t);
+
+    resource = alpha_provider_acquire_resource(provider, in.resource_id);
+    if(!resource) {
+        out.ret = ALPHA_ERR_INVALID_RESOURCE;
+        goto finish;
+    }
+
+    segment = alpha_provider_acquire_shm_segment(provider, in.segment_id);
+    if(!segment) {
+        out.ret = ALPHA_ERR_INVALID_ARGS;
+        goto finish;
+    }
+
+    uint64_t size = in.count*sizeof(int32_t);
+    if(in.count > SIZE_MAX/sizeof(int32_t)
+    || !alpha_shm_range_valid(segment->size, in.x_offset, size)
+    || !alpha_shm_range_valid(segment->size, in.y_offset, size)
+    || !alpha_shm_range_valid(segment->size, in.result_offset, size)) {
+        margo_error(mid, "sum_shm arrays are out of the bounds of the segment");
+        out.ret = ALPHA_ERR_INVALID_ARGS;
+        goto finish;
+    }
+
+    /* compute directly in the segment */
+    char* base = (char*)segment->base;
+    alpha_provider_compute_sum(provider, resource, in.count,
+            (const int32_t*)(base + in.x_offset), (const int32_t*)(base + in.y_offset),
+            (int32_t*)(base + in.result_offset));
+    out.ret = ALPHA_SUCCESS;
+    alpha_metrics_record_phase(metrics, ALPHA_METRICS_SUM_SHM, ALPHA_PHASE_COMPUTE, t);
+
+    margo_debug(mid, "Called sum_shm RPC");
+
+finish:
+    t = alpha_metrics_start(metrics);
+    hret = margo_respond(h, &out);
+    alpha_metrics_record_phase(metrics, ALPHA_METRICS_SUM_SHM, ALPHA_PHASE_RESPOND, t);
+    alpha_metrics_record_call(metrics, ALPHA_METRICS_SUM_SHM, out.ret);
+    alpha_shm_segment_release(segment);
+    alpha_resource_release(resource);
+    if(admitted) alpha_admission_leave(provider->admission, 0);
+    hret = margo_free_input(h, &in);
+    margo_destroy(h);
+}
+static DEFINE_MARGO_RPC_HANDLER(alpha_sum_shm_ult)
+
+static void alpha_reduce_ult(hg_handle_t h)
+{
+    hg_return_t     hret;
+    reduce_in_t     in;
+    reduce_out_t    out = {0};
+    alpha_resource* resource = NULL;
+    alpha_buffer*   buffer = NULL;
+    alpha_cached_addr* x_addr = NULL;
+    alpha_cached_addr* y_addr = NULL;
+    size_t scratch_size = 0;
+    bool admitted = false;
+    /* pulls[s] holds the x and y pulls of slot s */
+    margo_request pulls[2][2] = {{MARGO_REQUEST_NULL}};
+
+    /* find the margo instance */
+    margo_instance_id mid = margo_hg_handle_get_instance(h);
+
+    /* find the provider */
+    const struct hg_info* info = margo_get_info(h);
+    alpha_provider_t provider = (alpha_provider_t)margo_registered_data(mid, info->id);
+    alpha_metrics* metrics = provider->metrics;
+    uint64_t t = alpha_metrics_start(metrics);
+
+    /* deserialize the input */
+    hret = margo_get_input(h, &in);
+    t = alpha_metrics_record_phase(metrics, ALPHA_METRICS_REDUCE, ALPHA_PHASE_DESERIALIZE, t);
+    if(hret != HG_SUCCESS) {
+        margo_error(mid, "Could not deserialize output (mercury error %d)", hret);
+        out.ret = ALPHA_ERR_FROM_MERCURY;
+        goto finish;
+    }
+
+    alpha_reduce_op_t op = (alpha_reduce_op_t)in.op;
+    if(in.op > ALPHA_REDUCE_DOT
+    || (in.count == 0 && (op == ALPHA_REDUCE_MIN || op == ALPHA_REDUCE_MAX))
+    || in.count > SIZE_MAX/(2*sizeof(int32_t))
+    || !alpha_bulk_location_holds(&in.x, sizeof(int32_t)*in.count)
+    || (op == ALPHA_REDUCE_DOT && !alpha_bulk_location_holds(&in.y, sizeof(int32_t)*in.count))) {
+        out.ret = ALPHA_ERR_INVALID_ARGS;
+        goto finish;
+    }
+
+    /* large arrays are reduced in chunks of at most pipeline_chunk_size bytes,
+     * through two slots so that pulling a chunk overlaps with reducing the
+     * previous one */
+    size_t num_arrays  = op == ALPHA_REDUCE_DOT ? 2 : 1;
+    size_t chunk_count = in.count;
+    if(provider->pipeline_chunk_size
+    && sizeof(int32_t)*in.count > provider->pipeline_chunk_size) {
+        chunk_count = provider->pipeline_chunk_size / sizeof(int32_t);
+        if(chunk_count == 0) chunk_count = 1;
+    }
+    size_t num_chunks    = chunk_count ? (in.count + chunk_count - 1)/chunk_count : 0;
+    size_t num_slots     = num_chunks > 1 ? 2 : 1;
+    hg_size_t chunk_size = chunk_count*sizeof(int32_t);
+    hg_size_t slot_size  = num_arrays*chunk_size;
+    scratch_size = num_slots*slot_size;
+
+    out.ret = alpha_admission_enter(provider->admission, scratch_size, &out.retry_after_ms);
+    if(out.ret != ALPHA_SUCCESS) goto finish;
+    admitted = true;
+    t = alpha_metrics_record_phase(metrics, ALPHA_METRICS_REDUCE, ALPHA_PHASE_QUEUE, t);
+
+    resource = alpha_provider_acquire_resource(provider, in.resource_id);
+    if(!resource) {
+        out.ret = ALPHA_ERR_INVALID_RESOURCE;
+        goto finish;
+    }
+
+    out.result = op == ALPHA_REDUCE_MIN ? INT32_MAX : op == ALPHA_REDUCE_MAX ? INT32_MIN : 0;
+    if(in.count == 0) goto finish;
+
+    /* lookup addresses */
+    hret = alpha_addr_cache_lookup(provider->addr_cache, in.x.address, info->addr, &x_addr);
+    if(hret != HG_SUCCESS) {
+        margo_error(mid, "Could not lookup address for x buffer (mercury error %d)", hret);
+        out.ret = ALPHA_ERR_FROM_MERCURY;
+        goto finish;
+    }
+    if(op == ALPHA_REDUCE_DOT) {
+        hret = alpha_addr_cache_lookup(provider->addr_cache, in.y.address, info->addr, &y_addr);
+        if(hret != HG_SUCCESS) {
+            margo_error(mid, "Could not lookup address for y buffer (mercury error %d)", hret);
+            out.ret = ALPHA_ERR_FROM_MERCURY;
+            goto finish;
+        }
+    }
+    t = alpha_metrics_record_phase(metrics, ALPHA_METRICS_REDUCE, ALPHA_PHASE_ADDR_LOOKUP, t);
+
+    out.ret = alpha_buffer_pool_get(provider->buffer_pool, scratch_size, &buffer);
+    if(out.ret != ALPHA_SUCCESS) {
+        margo_error(mid, "Could not get a buffer of size %lu from the buffer pool",
+                    (unsigned long)scratch_size);
+        goto finish;
+    }
+
+    /* since pulls and reductions overlap, the time spent
+     * waiting on each of them is accumulated over all the chunks */
+    uint64_t pull_ns = 0, compute_ns = 0;
+    for(size_t i = 0; i <= num_chunks && hret == HG_SUCCESS; ++i) {
+        /* start pulling chunk i while chunk i-1 is reduced */
+        if(i < num_chunks) {
+            size_t s = i % num_slots;
+            hg_size_t remote_offset = i*chunk_size;
+            hg_size_t size = (i + 1 == num_chunks ? in.count - i*chunk_count : chunk_count)
+                           * sizeof(int32_t);
+            hret = margo_bulk_itransfer(mid, HG_BULK_PULL, x_addr->addr, in.x.bulk,
+                    in.x.offset + remote_offset, buffer->bulk, s*slot_size, size, &pulls[s][0]);
+            if(hret == HG_SUCCESS && y_addr)
+                hret = margo_bulk_itransfer(mid, HG_BULK_PULL, y_addr->addr, in.y.bulk,
+                        in.y.offset + remote_offset, buffer->bulk, s*slot_size + chunk_size,
+                        size, &pulls[s][1]);
+            if(hret != HG_SUCCESS) break;
+        }
+        if(i == 0) continue;
+        size_t p = (i - 1) % num_slots;
+        size_t count = i == num_chunks ? in.count - (i - 1)*chunk_count : chunk_count;
+        t = alpha_metrics_start(metrics);
+        hret = alpha_wait_all(2, pulls[p]);
+        pull_ns += alpha_metrics_elapsed(metrics, t);
+        if(hret != HG_SUCCESS) break;
+        const int32_t* x_buf = (const int32_t*)((char*)buffer->data + p*slot_size);
+        const int32_t* y_buf = x_buf + chunk_count;
+        t = alpha_metrics_start(metrics);
+        out.result = alpha_reduce_combine(op, out.result,
+                alpha_resource_reduce(resource, op, count, x_buf, y_buf));
+        compute_ns += alpha_metrics_elapsed(metrics, t);
+    }
+
+    /* wait for the remaining pulls before releasing the buffer */
+    hg_return_t pulls_hret = alpha_wait_all(4, &pulls[0][0]);
+    if(hret == HG_SUCCESS) hret = pulls_hret;
+    if(hret != HG_SUCCESS) {
+        margo_error(mid, "Could not bulk transfer input data (mercury error %d)", hret);
+        out.ret = ALPHA_ERR_FROM_MERCURY;
+        goto finish;
+    }
+    alpha_metrics_record_duration(metrics, ALPHA_METRICS_REDUCE, ALPHA_PHASE_BULK_PULL, pull_ns);
+    alpha_metrics_record_duration(metrics, ALPHA_METRICS_REDUCE, ALPHA_PHASE_COMPUTE, compute_ns);
+    alpha_metrics_record_bytes(metrics, num_arrays*in.count*sizeof(int32_t), 0);
+
+    margo_debug(mid, "Called reduce RPC");
+
+finish:
+    t = alpha_metrics_start(metrics);
+    hret = margo_respond(h, &out);
+    alpha_metrics_record_phase(metrics, ALPHA_METRICS_REDUCE, ALPHA_PHASE_RESPOND, t);
+    alpha_metrics_record_call(metrics, ALPHA_METRICS_REDUCE, out.ret);
+    alpha_resource_release(resource);
+    alpha_buffer_pool_release(provider->buffer_pool, buffer);
+    alpha_addr_cache_release(provider->addr_cache, x_addr);
+    alpha_addr_cache_release(provider->addr_cache, y_addr);
+    if(admitted) alpha_admission_leave(provider->admission, scratch_size);
+    hret = margo_free_input(h, &in);
+    margo_destroy(h);
+}
+static DEFINE_MARGO_RPC_HANDLER(alpha_reduce_ult)
+
+typedef struct alpha_local_sum_args {
+    alpha_provider_t provider;
+    alpha_resource*  resource;
+    size_t           count;
+    const int32_t*   x;
+    const int32_t*   y;
+    int32_t*         result;
+} alpha_local_sum_args;
+
+static void alpha_local_sum_multi_ult(void* arg)
+{
+    alpha_local_sum_args* a = (alpha_local_sum_args*)arg;
+    /* the result cache applies to co-located calls as well */
+    alpha_provider_compute_cached(a->provider, a->resource, ALPHA_METRICS_SUM_MULTI,
+            ALPHA_DTYPE_I32, a->count, a->x, a->y, a->result);
+}
+
+static void alpha_local_context_free(void* context)
+{
+    alpha_local_context* local = (alpha_local_context*)context;
+    ABT_rwlock_free(&local->lock);
+    free(local);
+}
+
+static alpha_return_t alpha_local_sum_multi_locked(
+        alpha_provider_t provider, uint32_t resource_id, size_t count,
+        const int32_t* x, const int32_t* y, int32_t* result,
+        uint32_t* retry_after_ms);
+
+static alpha_return_t alpha_local_sum_multi(
+        void* context, uint32_t resource_id, size_t count,
+        const int32_t* x, const int32_t* y, int32_t* result,
+        uint32_t* retry_after_ms)
+{
+    alpha_local_context* local = (alpha_local_context*)context;
+    alpha_return_t ret = ALPHA_ERR_INVALID_PROVIDER;
+    ABT_rwlock_rdlock(local->lock);
+    if(local->provider)
+        ret = alpha_local_sum_multi_locked(local->provider, resource_id,
+                count, x, y, result, retry_after_ms);
+    ABT_rwlock_unlock(local->lock);
+    return ret;
+}
+
+/* Same as alpha_local_sum_multi, with the context's lock held */
+static alpha_return_t alpha_local_sum_multi_locked(
+        alpha_provider_t provider, uint32_t resource_id, size_t count,
+        const int32_t* x, const int32_t* y, int32_t* result,
+        uint32_t* retry_after_ms)
+{
+    alpha_metrics* metrics = provider->metrics;
+    alpha_resource* resource = NULL;
+    uint64_t t = alpha_metrics_start(metrics);
+
+    /* the caller's arrays are used in place, hence no scratch memory */
+    alpha_return_t ret = alpha_admission_enter(provider->admission, 0, retry_after_ms);
+    if(ret != ALPHA_SUCCESS) {
+        alpha_metrics_record_call(metrics, ALPHA_METRICS_SUM_MULTI, ret);
+        return ret;
+    }
+    t = alpha_metrics_record_phase(metrics, ALPHA_METRICS_SUM_MULTI, ALPHA_PHASE_QUEUE, t);
+
+    resource = alpha_provider_acquire_resource(provider, resource_id);
+    if(!resource) {
+        ret = ALPHA_ERR_INVALID_RESOURCE;
+        goto finish;
+    }
+
+    /* compute in the pool the provider's RPCs run in, as an RPC would */
+    alpha_local_sum_args args = {provider, resource, count, x, y, result};
+    ABT_pool pool = provider->pool;
+    if(pool == ABT_POOL_NULL) margo_get_handler_pool(provider->mid, &pool);
+    ABT_thread thread = ABT_THREAD_NULL;
+    if(ABT_thread_create(pool, alpha_local_sum_multi_ult, &args,
+                         ABT_THREAD_ATTR_NULL, &thread) == ABT_SUCCESS) {
+        ABT_thread_join(thread);
+        ABT_thread_free(&thread);
+    } else {
+        alpha_local_sum_multi_ult(&args);
+    }
+    alpha_metrics_record_phase(metrics, ALPHA_METRICS_SUM_MULTI, ALPHA_PHASE_COMPUTE, t);
+
+    margo_debug(provider->mid, "Called local sum_multi");
+
+finish:
+    alpha_metrics_record_call(metrics, ALPHA_METRICS_SUM_MULTI, ret);
+    alpha_resource_release(resource);
+    alpha_admission_leave(provider->admission, 0);
+    return ret;
 }
 
 alpha_return_t alpha_register_backend(alpha_backend_impl* backend_impl)
 {
-    return add_backend_impl(backend_impl);
+    return alpha_backend_registry_add(backend_impl);
 }
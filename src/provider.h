@@ -9,23 +9,92 @@
 #include <margo.h>
 #include <json-c/json.h>
 #include "alpha/alpha-backend.h"
+#include "buffer-pool.h"
+#include "addr-cache.h"
+#include "admission.h"
+#include "array-store.h"
+#include "result-cache.h"
+#include "metrics.h"
+#include "local.h"
 
 typedef struct alpha_resource {
-    alpha_backend_impl* fn;  // pointer to function mapping for this backend
-    void*               ctx; // context required by the backend
+    alpha_backend_impl* fn;       // pointer to function mapping for this backend
+    void*               ctx;      // context required by the backend
+    char*               library;  // library the backend was loaded from, if any
+    uint32_t            id;       // index of the resource in the provider's table
+    uint64_t            serial;   // unlike ids, never reused by the provider
+    uint64_t            refcount; // references from the table and from RPCs in progress
 } alpha_resource;
 
+/* Shared-memory segment attached by a same-node client (see shm.h) */
+typedef struct alpha_shm_segment {
+    uint64_t                  id;
+    void*                     base;
+    size_t                    size;
+    uint64_t                  refcount; // reference from the provider's list and from RPCs in progress
+    struct alpha_shm_segment* next;
+} alpha_shm_segment;
+
 typedef struct alpha_provider {
     /* Margo/Argobots/Mercury environment */
     margo_instance_id   mid;         // Margo instance
     uint16_t            provider_id; // Provider id
     ABT_pool            pool;        // Pool on which to post RPC requests
-    /* Resource */
-    alpha_resource* resource;
+    ABT_pool            compute_pool; // Pool in which large computations are split (may be NULL)
+    /* Resources, indexed by resource id. Slots of removed resources
+     * are NULL and reused by resources added subsequently. */
+    ABT_rwlock       resources_lock;
+    alpha_resource** resources;
+    size_t           resources_capacity;
+    uint64_t         resources_added;
+    /* Cache of addresses that bulk handles originate from */
+    alpha_addr_cache_t addr_cache;
+    /* Pool of registered buffers for bulk transfers */
+    alpha_buffer_pool_t buffer_pool;
+    /* Limits on the RPCs in flight and the memory they use */
+    alpha_admission_t admission;
+    /* Arrays uploaded by clients to be used as operands */
+    alpha_array_store_t array_store;
+    /* Results of sum_multi computations, addressed by the operands' content */
+    alpha_result_cache_t result_cache;
+    /* Size (in bytes) of the chunks in which large sum_multi
+     * requests are pipelined (0 to disable pipelining) */
+    hg_size_t pipeline_chunk_size;
+    /* Computations of at least compute_min_task_size elements are split into
+     * tasks of at least that many elements, at most compute_max_tasks of them,
+     * and run in the compute pool (sizes are in int32_t elements, i.e. tasks
+     * cover at least 4*compute_min_task_size bytes whatever the type) */
+    size_t compute_min_task_size;
+    size_t compute_max_tasks;
+    /* Shared-memory segments attached by same-node clients */
+    bool               shm_enabled;
+    ABT_mutex          shm_lock;
+    alpha_shm_segment* shm_segments;
+    uint64_t           shm_next_id;
+    /* Metrics (NULL if disabled) and whether alpha_stats RPCs are allowed */
+    alpha_metrics* metrics;
+    bool           stats_rpc;
     /* RPC identifiers for clients */
     hg_id_t sum_id;
     hg_id_t sum_multi_id;
+    hg_id_t accumulate_id;
+    hg_id_t reduce_id;
+    hg_id_t sum_strided_id;
+    hg_id_t sum_stored_id;
+    hg_id_t array_store_id;
+    hg_id_t array_remove_id;
+    hg_id_t named_create_id;
+    hg_id_t named_io_id;
+    hg_id_t sum_named_id;
+    hg_id_t sum_batch_id;
+    hg_id_t stats_id;
+    hg_id_t shm_attach_id;
+    hg_id_t shm_detach_id;
+    hg_id_t sum_shm_id;
     /* ... add other RPC identifiers here ... */
+    /* Operations exposed to clients in the same margo instance */
+    struct alpha_local_context* local;
+    hg_id_t                     local_id;
 } alpha_provider;
 
 #endif
@@ -0,0 +1,320 @@
+/*
+ * (C) 2020 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "result-cache.h"
+#include "xxh64.h"
+
+#define ALPHA_RESULT_CACHE_MIN_BUCKETS 64
+
+/* Entries keep a copy of the operands next to the result, so that
+ * a hit never depends on the hashes of the operands alone */
+typedef struct alpha_cached_result {
+    alpha_result_key            key;
+    size_t                      size;   // size of x, y, and the result
+    struct alpha_cached_result* lru_prev;
+    struct alpha_cached_result* lru_next;
+    struct alpha_cached_result* bucket_next;
+    char                        data[]; // x, y, then the result
+} alpha_cached_result;
+
+struct alpha_result_cache {
+    margo_instance_id     mid;
+    ABT_mutex             mutex;
+    size_t                max_bytes;   // 0 if the cache is disabled
+    size_t                num_bytes;   // size of the cached entries
+    size_t                num_entries;
+    size_t                num_buckets; // power of 2
+    alpha_cached_result** buckets;
+    alpha_cached_result*  lru_head;    // most recently used
+    alpha_cached_result*  lru_tail;    // least recently used
+    uint64_t              hits;
+    uint64_t              misses;
+    uint64_t              insertions;
+    uint64_t              evictions;
+};
+
+static inline bool key_equal(const alpha_result_key* a, const alpha_result_key* b)
+{
+    return a->x_hash == b->x_hash && a->y_hash == b->y_hash && a->count == b->count
+        && a->resource == b->resource && a->dtype == b->dtype;
+}
+
+static inline size_t key_bucket(alpha_result_cache_t cache, const alpha_result_key* key)
+{
+    return (key->x_hash ^ xxh_rotl64(key->y_hash, 32)) & (cache->num_buckets - 1);
+}
+
+static inline size_t entry_size(size_t size)
+{
+    return sizeof(alpha_cached_result) + 3*size;
+}
+
+static void lru_unlink(alpha_result_cache_t cache, alpha_cached_result* e)
+{
+    if(e->lru_prev) e->lru_prev->lru_next = e->lru_next;
+    else cache->lru_head = e->lru_next;
+    if(e->lru_next) e->lru_next->lru_prev = e->lru_prev;
+    else cache->lru_tail = e->lru_prev;
+    e->lru_prev = e->lru_next = NULL;
+}
+
+static void lru_push_front(alpha_result_cache_t cache, alpha_cached_result* e)
+{
+    e->lru_prev = NULL;
+    e->lru_next = cache->lru_head;
+    if(cache->lru_head) cache->lru_head->lru_prev = e;
+    cache->lru_head = e;
+    if(!cache->lru_tail) cache->lru_tail = e;
+}
+
+static alpha_cached_result* table_find(
+        alpha_result_cache_t cache, const alpha_result_key* key)
+{
+    alpha_cached_result* e = cache->buckets[key_bucket(cache, key)];
+    for(; e; e = e->bucket_next) {
+        if(key_equal(&e->key, key))
+            return e;
+    }
+    return NULL;
+}
+
+static void table_remove(alpha_result_cache_t cache, alpha_cached_result* e)
+{
+    alpha_cached_result** p = &cache->buckets[key_bucket(cache, &e->key)];
+    while(*p && *p != e) p = &(*p)->bucket_next;
+    if(*p) *p = e->bucket_next;
+    e->bucket_next = NULL;
+}
+
+/* must be called with the mutex locked; keeps the
+ * table as large as the number of entries, if possible */
+static void table_grow(alpha_result_cache_t cache)
+{
+    if(cache->num_entries <= cache->num_buckets) return;
+    size_t num_buckets = 2*cache->num_buckets;
+    alpha_cached_result** buckets =
+        (alpha_cached_result**)calloc(num_buckets, sizeof(*buckets));
+    if(!buckets) return;
+    alpha_cached_result** old_buckets = cache->buckets;
+    size_t old_num_buckets = cache->num_buckets;
+    cache->buckets     = buckets;
+    cache->num_buckets = num_buckets;
+    for(size_t i = 0; i < old_num_buckets; ++i) {
+        while(old_buckets[i]) {
+            alpha_cached_result* e = old_buckets[i];
+            old_buckets[i] = e->bucket_next;
+            size_t b = key_bucket(cache, &e->key);
+            e->bucket_next = buckets[b];
+            buckets[b] = e;
+        }
+    }
+    free(old_buckets);
+}
+
+/* must be called with the mutex locked; returns the evicted entry,
+ * which the caller should free after unlocking the mutex */
+static alpha_cached_result* evict_one(alpha_result_cache_t cache)
+{
+    alpha_cached_result* e = cache->lru_tail;
+    if(!e) return NULL;
+    lru_unlink(cache, e);
+    table_remove(cache, e);
+    cache->num_entries -= 1;
+    cache->num_bytes   -= entry_size(e->size);
+    return e;
+}
+
+alpha_return_t alpha_result_cache_create(
+        margo_instance_id mid,
+        struct json_object* config,
+        alpha_result_cache_t* cache)
+{
+    size_t max_bytes = 0;
+    if(config) {
+        if(!json_object_is_type(config, json_type_object)) {
+            margo_error(mid, "\"result_cache\" field should be an object in provider configuration");
+            return ALPHA_ERR_INVALID_CONFIG;
+        }
+        struct json_object* jmax_bytes = json_object_object_get(config, "max_bytes");
+        if(jmax_bytes) {
+            if(!json_object_is_type(jmax_bytes, json_type_int)
+            || json_object_get_int64(jmax_bytes) < 0) {
+                margo_error(mid, "\"max_bytes\" field in result cache configuration should be a positive integer");
+                return ALPHA_ERR_INVALID_CONFIG;
+            }
+            max_bytes = (size_t)json_object_get_int64(jmax_bytes);
+        }
+    }
+
+    alpha_result_cache_t c = (alpha_result_cache_t)calloc(1, sizeof(*c));
+    if(!c) return ALPHA_ERR_ALLOCATION;
+    c->num_buckets = ALPHA_RESULT_CACHE_MIN_BUCKETS;
+    c->buckets = (alpha_cached_result**)calloc(c->num_buckets, sizeof(*c->buckets));
+    if(!c->buckets) {
+        free(c);
+        return ALPHA_ERR_ALLOCATION;
+    }
+    c->mid       = mid;
+    c->max_bytes = max_bytes;
+    ABT_mutex_create(&c->mutex);
+
+    *cache = c;
+    return ALPHA_SUCCESS;
+}
+
+void alpha_result_cache_destroy(alpha_result_cache_t cache)
+{
+    if(!cache) return;
+    while(cache->lru_tail)
+        free(evict_one(cache));
+    ABT_mutex_free(&cache->mutex);
+    free(cache->buckets);
+    free(cache);
+}
+
+bool alpha_result_cache_enabled(alpha_result_cache_t cache)
+{
+    return cache && cache->max_bytes > 0;
+}
+
+void alpha_result_cache_key(
+        uint64_t resource,
+        alpha_dtype_t dtype,
+        size_t count,
+        const void* x,
+        const void* y,
+        size_t size,
+        alpha_result_key* key)
+{
+    key->count       = count;
+    key->resource    = resource;
+    key->dtype       = (uint32_t)dtype;
+    key->x_hash      = alpha_xxh64(x, size, 0);
+    key->y_hash      = alpha_xxh64(y, size, 0);
+}
+
+bool alpha_result_cache_get(
+        alpha_result_cache_t cache,
+        const alpha_result_key* key,
+        const void* x,
+        const void* y,
+        void* result,
+        size_t size)
+{
+    ABT_mutex_lock(cache->mutex);
+    alpha_cached_result* e = table_find(cache, key);
+    if(!e || e->size != size
+    || memcmp(e->data, x, size) != 0
+    || memcmp(e->data + size, y, size) != 0) {
+        cache->misses += 1;
+        ABT_mutex_unlock(cache->mutex);
+        return false;
+    }
+    lru_unlink(cache, e);
+    lru_push_front(cache, e);
+    memcpy(result, e->data + 2*size, size);
+    cache->hits += 1;
+    ABT_mutex_unlock(cache->mutex);
+    return true;
+}
+
+alpha_cached_result_t alpha_result_cache_prepare(
+        alpha_result_cache_t cache,
+        const alpha_result_key* key,
+        const void* x,
+        const void* y,
+        size_t size)
+{
+    if(size > SIZE_MAX/4 || entry_size(size) > cache->max_bytes) return NULL;
+
+    /* copy the operands without holding the lock */
+    alpha_cached_result* e = (alpha_cached_result*)malloc(entry_size(size));
+    if(!e) return NULL;
+    e->key         = *key;
+    e->size        = size;
+    e->lru_prev    = e->lru_next = e->bucket_next = NULL;
+    memcpy(e->data, x, size);
+    memcpy(e->data + size, y, size);
+    return e;
+}
+
+void alpha_result_cache_put(
+        alpha_result_cache_t cache,
+        alpha_cached_result_t e,
+        const void* result)
+{
+    if(!e) return;
+    memcpy(e->data + 2*e->size, result, e->size);
+
+    alpha_cached_result* evicted = NULL;
+    ABT_mutex_lock(cache->mutex);
+    /* evict an entry with the same key, which either holds the same
+     * result (inserted by another ULT in the meantime) or other operands */
+    alpha_cached_result* previous = table_find(cache, &e->key);
+    if(previous) {
+        lru_unlink(cache, previous);
+        table_remove(cache, previous);
+        cache->num_entries -= 1;
+        cache->num_bytes   -= entry_size(previous->size);
+        previous->bucket_next = evicted;
+        evicted = previous;
+    }
+    /* evicted entries are chained through bucket_next to be freed later */
+    while(cache->num_bytes + entry_size(e->size) > cache->max_bytes) {
+        alpha_cached_result* victim = evict_one(cache);
+        victim->bucket_next = evicted;
+        evicted = victim;
+        cache->evictions += 1;
+    }
+    size_t b = key_bucket(cache, &e->key);
+    e->bucket_next = cache->buckets[b];
+    cache->buckets[b] = e;
+    lru_push_front(cache, e);
+    cache->num_entries += 1;
+    cache->num_bytes   += entry_size(e->size);
+    cache->insertions  += 1;
+    table_grow(cache);
+    ABT_mutex_unlock(cache->mutex);
+
+    while(evicted) {
+        alpha_cached_result* next = evicted->bucket_next;
+        free(evicted);
+        evicted = next;
+    }
+}
+
+struct json_object* alpha_result_cache_get_config(alpha_result_cache_t cache)
+{
+    struct json_object* config = json_object_new_object();
+    json_object_object_add(config, "max_bytes",
+        json_object_new_int64((int64_t)cache->max_bytes));
+    return config;
+}
+
+struct json_object* alpha_result_cache_get_stats(alpha_result_cache_t cache)
+{
+    struct json_object* stats = json_object_new_object();
+    ABT_mutex_lock(cache->mutex);
+    uint64_t lookups = cache->hits + cache->misses;
+    json_object_object_add(stats, "hits",
+        json_object_new_int64((int64_t)cache->hits));
+    json_object_object_add(stats, "misses",
+        json_object_new_int64((int64_t)cache->misses));
+    json_object_object_add(stats, "hit_rate",
+        json_object_new_double(lookups ? (double)cache->hits / (double)lookups : 0.0));
+    json_object_object_add(stats, "insertions",
+        json_object_new_int64((int64_t)cache->insertions));
+    json_object_object_add(stats, "evictions",
+        json_object_new_int64((int64_t)cache->evictions));
+    json_object_object_add(stats, "num_entries",
+        json_object_new_int64((int64_t)cache->num_entries));
+    json_object_object_add(stats, "num_bytes",
+        json_object_new_int64((int64_t)cache->num_bytes));
+    ABT_mutex_unlock(cache->mutex);
+    return stats;
+}
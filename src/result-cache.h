@@ -0,0 +1,137 @@
+/*
+ * (C) 2020 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef _RESULT_CACHE_H
+#define _RESULT_CACHE_H
+
+#include <stdbool.h>
+#include <margo.h>
+#include <json-c/json.h>
+#include "alpha/alpha-common.h"
+
+/**
+ * @brief Content of a computation: the resource and type of elements it
+ * involves, and a hash of each of its operands. Keys only locate results
+ * in the cache: since 64-bit hashes can be made to collide, a result is
+ * only returned if the operands it was computed from are equal to the
+ * requested ones, byte for byte.
+ */
+typedef struct alpha_result_key {
+    uint64_t x_hash;
+    uint64_t y_hash;
+    uint64_t count;
+    uint64_t resource; // serial number of the resource
+    uint32_t dtype;
+} alpha_result_key;
+
+/**
+ * @brief Cache of the results of sum_multi and sum_batch computations
+ * (including co-located sum_multi calls, but not sum_shm ones, whose
+ * operands the client can modify during the computation), addressed by the
+ * content of their operands, so that identical requests (e.g. retries, or
+ * the same arrays sent by several clients) don't call the backend again.
+ * Results are copied in and out of the cache, along with their operands,
+ * and the least recently used ones are evicted to stay within its byte
+ * budget.
+ */
+typedef struct alpha_result_cache* alpha_result_cache_t;
+
+/**
+ * @brief Entry created with alpha_result_cache_prepare before computing
+ * a result, and added to the cache with alpha_result_cache_put.
+ */
+typedef struct alpha_cached_result* alpha_cached_result_t;
+
+/**
+ * @brief Creates a result cache from its JSON configuration, e.g.
+ * { "max_bytes": 67108864 }, max_bytes bounding the memory used by the
+ * cached results, their operands, and their bookkeeping. A max_bytes of 0 (the default)
+ * disables the cache. The cache should only be enabled if the backends
+ * compute the same result every time they are given the same operands.
+ *
+ * @param[in] mid Margo instance
+ * @param[in] config JSON configuration (may be NULL)
+ * @param[out] cache created cache
+ *
+ * @return ALPHA_SUCCESS or error code defined in alpha-common.h
+ */
+alpha_return_t alpha_result_cache_create(
+        margo_instance_id mid,
+        struct json_object* config,
+        alpha_result_cache_t* cache);
+
+/**
+ * @brief Destroys the cache. Passing NULL is valid and does nothing.
+ */
+void alpha_result_cache_destroy(alpha_result_cache_t cache);
+
+/**
+ * @brief Whether the cache is enabled, i.e. whether computing keys is
+ * worth it.
+ */
+bool alpha_result_cache_enabled(alpha_result_cache_t cache);
+
+/**
+ * @brief Computes the key of the sum of x and y, two arrays of count
+ * elements of the given type taking size bytes each, by a resource
+ * identified by a number that the provider doesn't reuse.
+ */
+void alpha_result_cache_key(
+        uint64_t resource,
+        alpha_dtype_t dtype,
+        size_t count,
+        const void* x,
+        const void* y,
+        size_t size,
+        alpha_result_key* key);
+
+/**
+ * @brief Looks up the result of the sum of x and y (of size bytes each)
+ * and copies its size bytes into result.
+ *
+ * @return true on a hit, false otherwise (result is left untouched)
+ */
+bool alpha_result_cache_get(
+        alpha_result_cache_t cache,
+        const alpha_result_key* key,
+        const void* x,
+        const void* y,
+        void* result,
+        size_t size);
+
+/**
+ * @brief Creates an entry holding copies of x and y (of size bytes each),
+ * before the result is computed, so that the result may overwrite them.
+ *
+ * @return the entry, or NULL if it wouldn't fit in the cache
+ */
+alpha_cached_result_t alpha_result_cache_prepare(
+        alpha_result_cache_t cache,
+        const alpha_result_key* key,
+        const void* x,
+        const void* y,
+        size_t size);
+
+/**
+ * @brief Completes an entry with a copy of the result and adds it to the
+ * cache, evicting older results if needed. Passing NULL does nothing.
+ */
+void alpha_result_cache_put(
+        alpha_result_cache_t cache,
+        alpha_cached_result_t entry,
+        const void* result);
+
+/**
+ * @brief Returns the configuration of the cache as a JSON object.
+ */
+struct json_object* alpha_result_cache_get_config(alpha_result_cache_t cache);
+
+/**
+ * @brief Returns the hit/miss counters and the occupancy of the cache
+ * as a JSON object.
+ */
+struct json_object* alpha_result_cache_get_stats(alpha_result_cache_t cache);
+
+#endif
@@ -0,0 +1,78 @@
+/*
+ * (C) 2020 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef _SHM_H
+#define _SHM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* POSIX shared-memory segments through which same-node clients and
+ * providers exchange sum_multi operands. The client creates the segment
+ * when creating a resource handle, the provider maps it by name, and the
+ * client then unlinks the name, so that the segment disappears once both
+ * sides have unmapped it. */
+
+/* Alignment of the arrays placed in a segment */
+#define ALPHA_SHM_ALIGNMENT 64
+
+/* The segment starts with a header holding a random token, which the
+ * client also sends when asking the provider to attach the segment. This
+ * way a provider on another node never mistakes an unrelated segment that
+ * happens to have the same name for the client's. */
+typedef struct alpha_shm_header {
+    uint64_t token;
+} alpha_shm_header;
+
+/* Offset of the first array in a segment */
+#define ALPHA_SHM_DATA_OFFSET ALPHA_SHM_ALIGNMENT
+
+/**
+ * @brief Maps the shared-memory segment with the given name, creating it
+ * (exclusively) if create is true. An existing segment is only mapped if
+ * it has the expected size.
+ *
+ * @return the address of the mapping, or NULL on failure
+ */
+static inline void* alpha_shm_map(const char* name, size_t size, bool create)
+{
+    int flags = O_RDWR | (create ? O_CREAT | O_EXCL : 0);
+    int fd = shm_open(name, flags, S_IRUSR | S_IWUSR);
+    if(fd < 0) return NULL;
+    if(create && ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        shm_unlink(name);
+        return NULL;
+    }
+    /* accessing a mapping beyond the end of its file raises SIGBUS */
+    struct stat st;
+    if(!create && (fstat(fd, &st) != 0 || (size_t)st.st_size != size)) {
+        close(fd);
+        return NULL;
+    }
+    void* base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if(base == MAP_FAILED) {
+        if(create) shm_unlink(name);
+        return NULL;
+    }
+    return base;
+}
+
+/**
+ * @brief Checks that [offset, offset + size) lies within a segment of
+ * the given size, without overflowing.
+ */
+static inline bool alpha_shm_range_valid(size_t segment_size, uint64_t offset, uint64_t size)
+{
+    return offset <= segment_size && size <= segment_size - offset;
+}
+
+#endif
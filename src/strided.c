@@ -0,0 +1,176 @@
+/*
+ * (C) 2020 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#include <string.h>
+#include "strided.h"
+#include "wait-all.h"
+
+/* i-th remote range of the array, in bytes from the start of the bulk handle */
+static inline alpha_segment_t alpha_strided_range(const alpha_strided_plan* plan, size_t i)
+{
+    const alpha_strided_location_t* loc = plan->location;
+    alpha_segment_t range;
+    if(loc->num_segments) {
+        range.offset = loc->offset + loc->segments[i].offset;
+        range.size   = loc->segments[i].size;
+    } else {
+        range.offset = loc->offset + (int64_t)i*loc->stride;
+        range.size   = (int64_t)plan->range_size;
+    }
+    return range;
+}
+
+alpha_return_t alpha_strided_plan_init(
+        const alpha_strided_location_t* location,
+        size_t count,
+        size_t elem_size,
+        alpha_strided_plan* plan)
+{
+    int64_t offset = location->offset;
+    if(offset < 0 || count > (size_t)INT64_MAX / elem_size)
+        return ALPHA_ERR_INVALID_ARGS;
+
+    memset(plan, 0, sizeof(*plan));
+    plan->location    = location;
+    plan->size        = count*elem_size;
+    plan->span_offset = offset;
+    if(count == 0 && location->num_segments == 0)
+        return ALPHA_SUCCESS;
+
+    if(location->num_segments == 0) {
+        int64_t stride = location->stride;
+        if(stride < (int64_t)elem_size
+        || (int64_t)(count - 1) > (INT64_MAX - offset - (int64_t)elem_size) / stride)
+            return ALPHA_ERR_INVALID_ARGS;
+        if(stride == (int64_t)elem_size) {
+            /* the elements are contiguous after all */
+            plan->num_ranges = 1;
+            plan->range_size = plan->size;
+        } else {
+            plan->num_ranges = count;
+            plan->range_size = elem_size;
+        }
+        plan->span_size = (size_t)((int64_t)(count - 1)*stride) + elem_size;
+        return ALPHA_SUCCESS;
+    }
+
+    size_t  total = 0;
+    int64_t start = INT64_MAX;
+    int64_t end   = 0;
+    for(uint64_t i = 0; i < location->num_segments; ++i) {
+        const alpha_segment_t* segment = &location->segments[i];
+        if(segment->offset < 0 || segment->size <= 0
+        || segment->offset > INT64_MAX - offset - segment->size
+        || (size_t)segment->size > plan->size - total)
+            return ALPHA_ERR_INVALID_ARGS;
+        total += (size_t)segment->size;
+        if(offset + segment->offset < start)
+            start = offset + segment->offset;
+        if(offset + segment->offset + segment->size > end)
+            end = offset + segment->offset + segment->size;
+    }
+    if(total != plan->size)
+        return ALPHA_ERR_INVALID_ARGS;
+    plan->num_ranges  = location->num_segments;
+    plan->span_offset = start;
+    plan->span_size   = (size_t)(end - start);
+    return ALPHA_SUCCESS;
+}
+
+/* Returns the index of the last of the ranges from first on that fit in a
+ * window of window_size bytes starting at the first one's offset, and sets
+ * *end to the end of the bytes they cover */
+static size_t alpha_strided_window_end(
+        const alpha_strided_plan* plan, size_t first,
+        size_t window_size, int64_t* end)
+{
+    alpha_segment_t range = alpha_strided_range(plan, first);
+    int64_t start = range.offset;
+    *end = range.offset + range.size;
+    size_t last = first;
+    if(range.size > (int64_t)window_size) return last;
+    while(last + 1 < plan->num_ranges) {
+        range = alpha_strided_range(plan, last + 1);
+        if(range.offset < start || range.offset - start > (int64_t)window_size - range.size)
+            break;
+        if(range.offset + range.size > *end)
+            *end = range.offset + range.size;
+        last += 1;
+    }
+    return last;
+}
+
+hg_return_t alpha_strided_transfer(
+        margo_instance_id mid,
+        hg_bulk_op_t op,
+        hg_addr_t addr,
+        const alpha_strided_plan* plan,
+        hg_bulk_t local,
+        char* local_data,
+        size_t local_offset,
+        size_t window_offset,
+        size_t* pulled,
+        size_t* pushed)
+{
+    hg_return_t hret = HG_SUCCESS;
+    hg_bulk_t remote = plan->location->bulk;
+    size_t window_size = alpha_strided_plan_window_size(plan);
+    char* window = local_data + window_offset;
+    size_t num_transfers = 0;
+    margo_request reqs[ALPHA_STRIDED_MAX_TRANSFERS];
+    for(size_t i = 0; i < ALPHA_STRIDED_MAX_TRANSFERS; ++i)
+        reqs[i] = MARGO_REQUEST_NULL;
+
+    for(size_t i = 0; i < plan->num_ranges; ++i) {
+        int64_t end;
+        size_t last = alpha_strided_window_end(plan, i, window_size, &end);
+        alpha_segment_t range = alpha_strided_range(plan, i);
+
+        if(last == i) {
+            /* the range is transferred on its own; the transfers are issued
+             * in a ring, each one waiting for the one issued MAX_TRANSFERS
+             * before */
+            margo_request* req = &reqs[num_transfers++ % ALPHA_STRIDED_MAX_TRANSFERS];
+            hret = alpha_wait_request(req);
+            if(hret != HG_SUCCESS) break;
+            hret = margo_bulk_itransfer(mid, op, addr, remote, (size_t)range.offset,
+                                        local, local_offset, (size_t)range.size, req);
+            if(hret != HG_SUCCESS) break;
+            *(op == HG_BULK_PULL ? pulled : pushed) += (size_t)range.size;
+            local_offset += (size_t)range.size;
+            continue;
+        }
+
+        /* ranges i to last go through the window; the ranges pushed
+         * directly must have landed before it is read, in case it
+         * covers some of them */
+        if(op == HG_BULK_PUSH) {
+            hret = alpha_wait_all(ALPHA_STRIDED_MAX_TRANSFERS, reqs);
+            if(hret != HG_SUCCESS) break;
+        }
+        size_t size = (size_t)(end - range.offset);
+        hret = margo_bulk_transfer(mid, HG_BULK_PULL, addr, remote, (size_t)range.offset,
+                                   local, window_offset, size);
+        if(hret != HG_SUCCESS) break;
+        *pulled += size;
+        for(; i <= last; ++i) {
+            alpha_segment_t r = alpha_strided_range(plan, i);
+            char* w = window + (r.offset - range.offset);
+            if(op == HG_BULK_PULL) memcpy(local_data + local_offset, w, (size_t)r.size);
+            else                   memcpy(w, local_data + local_offset, (size_t)r.size);
+            local_offset += (size_t)r.size;
+        }
+        i = last;
+        if(op == HG_BULK_PUSH) {
+            hret = margo_bulk_transfer(mid, HG_BULK_PUSH, addr, remote, (size_t)range.offset,
+                                       local, window_offset, size);
+            if(hret != HG_SUCCESS) break;
+            *pushed += size;
+        }
+    }
+
+    hg_return_t wait_hret = alpha_wait_all(ALPHA_STRIDED_MAX_TRANSFERS, reqs);
+    return hret != HG_SUCCESS ? hret : wait_hret;
+}
@@ -0,0 +1,89 @@
+/*
+ * (C) 2020 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef _STRIDED_H
+#define _STRIDED_H
+
+#include <stdbool.h>
+#include <margo.h>
+#include "alpha/alpha-common.h"
+
+/* Max number of bulk transfers of a strided array in flight at once */
+#define ALPHA_STRIDED_MAX_TRANSFERS 64
+
+/* Max size of the windows through which small ranges are transferred */
+#define ALPHA_STRIDED_WINDOW_SIZE (1024*1024)
+
+/**
+ * @brief Remote ranges of bytes holding the elements of an array
+ * described by an alpha_strided_location_t, in the order of the array.
+ * The ranges are not materialized: a strided array has one range per
+ * element (or a single one if its elements are contiguous), and an array
+ * made of segments has one range per segment.
+ */
+typedef struct alpha_strided_plan {
+    const alpha_strided_location_t* location;
+    size_t  num_ranges;
+    size_t  range_size;  // size of each range of a strided array
+    size_t  size;        // total number of bytes of the array
+    int64_t span_offset; // smallest range of bytes covering all the ranges
+    size_t  span_size;
+} alpha_strided_plan;
+
+/**
+ * @brief Checks an alpha_strided_location_t describing count elements of
+ * elem_size bytes (offsets and sizes must be positive, the segments must
+ * add up to count*elem_size bytes, and nothing may overflow) and computes
+ * its plan. The plan references the location, which must outlive it.
+ *
+ * @return ALPHA_SUCCESS or ALPHA_ERR_INVALID_ARGS
+ */
+alpha_return_t alpha_strided_plan_init(
+        const alpha_strided_location_t* location,
+        size_t count,
+        size_t elem_size,
+        alpha_strided_plan* plan);
+
+/**
+ * @brief Size of the local window alpha_strided_transfer needs for the
+ * plan, 0 if the array is a single range.
+ */
+static inline size_t alpha_strided_plan_window_size(const alpha_strided_plan* plan)
+{
+    if(plan->num_ranges <= 1) return 0;
+    return plan->span_size < ALPHA_STRIDED_WINDOW_SIZE ?
+           plan->span_size : ALPHA_STRIDED_WINDOW_SIZE;
+}
+
+/**
+ * @brief Transfers the array between its remote ranges and the packed
+ * range [local_offset, local_offset + plan->size) of a local bulk handle
+ * exposing local_data.
+ *
+ * Consecutive ranges that fit in a window of the plan's window size are
+ * transferred together through the window at window_offset, and packed
+ * or unpacked locally, so that a strided array of small elements doesn't
+ * take one transfer per element. To push them, the window is pulled first
+ * and pushed back with the ranges updated, which rewrites the remote bytes
+ * between the ranges with their current value. Other ranges are
+ * transferred directly, at most ALPHA_STRIDED_MAX_TRANSFERS at once.
+ *
+ * The bytes pulled and pushed are added to *pulled and *pushed.
+ *
+ * @return HG_SUCCESS or the first error encountered.
+ */
+hg_return_t alpha_strided_transfer(
+        margo_instance_id mid,
+        hg_bulk_op_t op,
+        hg_addr_t addr,
+        const alpha_strided_plan* plan,
+        hg_bulk_t local,
+        char* local_data,
+        size_t local_offset,
+        size_t window_offset,
+        size_t* pulled,
+        size_t* pushed);
+
+#endif
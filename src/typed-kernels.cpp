@@ -0,0 +1,54 @@
+/*
+ * (C) 2020 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#include <cstdint>
+#include <type_traits>
+#include "typed-kernels.h"
+
+namespace {
+
+// Integers are added as unsigned integers so that overflows wrap around
+// instead of being undefined behavior, which lets the compiler vectorize
+// the same loop for all the types.
+template<typename T, bool = std::is_integral<T>::value>
+struct adder {
+    static inline T add(T a, T b) { return a + b; }
+};
+
+template<typename T>
+struct adder<T, true> {
+    using U = typename std::make_unsigned<T>::type;
+    static inline T add(T a, T b) { return static_cast<T>(static_cast<U>(a) + static_cast<U>(b)); }
+};
+
+template<typename T>
+void sum_kernel(size_t count, const void* x, const void* y, void* r) {
+    auto xs = static_cast<const T*>(x);
+    auto ys = static_cast<const T*>(y);
+    auto rs = static_cast<T*>(r);
+    for(size_t i = 0; i < count; ++i)
+        rs[i] = adder<T>::add(xs[i], ys[i]);
+}
+
+using sum_kernel_fn = void (*)(size_t, const void*, const void*, void*);
+
+// indexed by alpha_dtype_t
+const sum_kernel_fn sum_kernels[] = {
+    sum_kernel<int32_t>,
+    sum_kernel<int64_t>,
+    sum_kernel<float>,
+    sum_kernel<double>
+};
+
+static_assert(sizeof(sum_kernels)/sizeof(sum_kernels[0]) == ALPHA_DTYPE_F64 + 1,
+              "sum_kernels should have one entry per alpha_dtype_t value");
+
+} // namespace
+
+extern "C" void alpha_typed_sum(alpha_dtype_t dtype, size_t count,
+                                const void* x, const void* y, void* r)
+{
+    sum_kernels[dtype](count, x, y, r);
+}
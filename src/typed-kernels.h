@@ -0,0 +1,28 @@
+/*
+ * (C) 2020 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef _TYPED_KERNELS_H
+#define _TYPED_KERNELS_H
+
+#include <stddef.h>
+#include "alpha/alpha-common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Computes r[i] = x[i] + y[i] for i in [0, count) on elements of
+ * the given type. r may alias x or y. Integer additions wrap around on
+ * overflow.
+ */
+void alpha_typed_sum(alpha_dtype_t dtype, size_t count,
+                     const void* x, const void* y, void* r);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
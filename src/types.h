@@ -16,22 +16,219 @@
 /* Client RPC types */
 
 MERCURY_GEN_PROC(sum_in_t,
+        ((uint32_t)(resource_id))\
         ((int32_t)(x))\
         ((int32_t)(y)))
 
+/* retry_after_ms is set along with ALPHA_ERR_BUSY
+ * to tell the client when to retry */
+
 MERCURY_GEN_PROC(sum_out_t,
         ((int32_t)(result))\
-        ((int32_t)(ret)))
+        ((int32_t)(ret))\
+        ((uint32_t)(retry_after_ms)))
 
+/* dtype is an alpha_dtype_t */
 MERCURY_GEN_PROC(sum_multi_in_t,
+        ((uint32_t)(resource_id))\
+        ((uint32_t)(dtype))\
         ((uint64_t)(count))\
         ((alpha_bulk_location_t)(x))\
         ((alpha_bulk_location_t)(y))\
         ((alpha_bulk_location_t)(result)))
 
+/* y += x, the result being pushed back to y's
+ * region, the output is a sum_multi_out_t */
+MERCURY_GEN_PROC(accumulate_in_t,
+        ((uint32_t)(resource_id))\
+        ((uint32_t)(dtype))\
+        ((uint64_t)(count))\
+        ((alpha_bulk_location_t)(x))\
+        ((alpha_bulk_location_t)(y)))
+
+/* sum_multi on arrays that are not contiguous on the
+ * client, the output is a sum_multi_out_t */
+MERCURY_GEN_PROC(sum_strided_in_t,
+        ((uint32_t)(resource_id))\
+        ((uint32_t)(dtype))\
+        ((uint64_t)(count))\
+        ((alpha_strided_location_t)(x))\
+        ((alpha_strided_location_t)(y))\
+        ((alpha_strided_location_t)(result)))
+
+/* sum_multi whose y operand is a stored array, the
+ * output is a sum_multi_out_t */
+MERCURY_GEN_PROC(sum_stored_in_t,
+        ((uint32_t)(resource_id))\
+        ((uint32_t)(dtype))\
+        ((uint64_t)(count))\
+        ((alpha_bulk_location_t)(x))\
+        ((uint64_t)(y_id))\
+        ((alpha_bulk_location_t)(result)))
+
 MERCURY_GEN_PROC(sum_multi_out_t,
+        ((int32_t)(ret))\
+        ((uint32_t)(retry_after_ms)))
+
+/* op is an alpha_reduce_op_t, y is only used by ALPHA_REDUCE_DOT */
+MERCURY_GEN_PROC(reduce_in_t,
+        ((uint32_t)(resource_id))\
+        ((uint32_t)(op))\
+        ((uint64_t)(count))\
+        ((alpha_bulk_location_t)(x))\
+        ((alpha_bulk_location_t)(y)))
+
+MERCURY_GEN_PROC(reduce_out_t,
+        ((int64_t)(result))\
+        ((int32_t)(ret))\
+        ((uint32_t)(retry_after_ms)))
+
+/* Max number of elements of the arrays sent inline, well above what fits
+ * in Mercury's eager buffers: larger arrays must go through RDMA, so that
+ * a count read from the network never drives a huge allocation */
+#define ALPHA_MAX_INLINE_COUNT ((uint64_t)1 << 20)
+
+/* Arrays of int32_t sent inline in the RPC's arguments, the
+ * number of elements being serialized by the caller beforehand */
+
+static inline hg_return_t hg_proc_int32_array(
+        hg_proc_t proc, uint64_t count, int32_t** data)
+{
+    switch(hg_proc_get_op(proc)) {
+    case HG_ENCODE:
+        if(count == 0) return HG_SUCCESS;
+        return hg_proc_memcpy(proc, *data, count*sizeof(int32_t));
+    case HG_DECODE:
+        *data = NULL;
+        if(count == 0) return HG_SUCCESS;
+        if(count > ALPHA_MAX_INLINE_COUNT) return HG_INVALID_ARG;
+        *data = (int32_t*)malloc(count*sizeof(int32_t));
+        if(!*data) return HG_NOMEM;
+        return hg_proc_memcpy(proc, *data, count*sizeof(int32_t));
+    case HG_FREE:
+        free(*data);
+        *data = NULL;
+        return HG_SUCCESS;
+    default:
+        return HG_INVALID_ARG;
+    }
+}
+
+typedef struct sum_batch_in_t {
+    uint32_t resource_id;
+    uint64_t count;
+    int32_t* x;
+    int32_t* y;
+} sum_batch_in_t;
+
+static inline hg_return_t hg_proc_sum_batch_in_t(hg_proc_t proc, void* data)
+{
+    sum_batch_in_t* in = (sum_batch_in_t*)data;
+    hg_return_t hret = hg_proc_uint32_t(proc, &in->resource_id);
+    if(hret != HG_SUCCESS) return hret;
+    hret = hg_proc_uint64_t(proc, &in->count);
+    if(hret != HG_SUCCESS) return hret;
+    hret = hg_proc_int32_array(proc, in->count, &in->x);
+    if(hret != HG_SUCCESS) return hret;
+    return hg_proc_int32_array(proc, in->count, &in->y);
+}
+
+typedef struct sum_batch_out_t {
+    int32_t  ret;
+    uint32_t retry_after_ms;
+    uint64_t count;
+    int32_t* result;
+} sum_batch_out_t;
+
+static inline hg_return_t hg_proc_sum_batch_out_t(hg_proc_t proc, void* data)
+{
+    sum_batch_out_t* out = (sum_batch_out_t*)data;
+    hg_return_t hret = hg_proc_int32_t(proc, &out->ret);
+    if(hret != HG_SUCCESS) return hret;
+    hret = hg_proc_uint32_t(proc, &out->retry_after_ms);
+    if(hret != HG_SUCCESS) return hret;
+    hret = hg_proc_uint64_t(proc, &out->count);
+    if(hret != HG_SUCCESS) return hret;
+    return hg_proc_int32_array(proc, out->count, &out->result);
+}
+
+/* Shared-memory data plane (see shm.h) */
+
+MERCURY_GEN_PROC(shm_attach_in_t,
+        ((hg_string_t)(name))\
+        ((uint64_t)(size))\
+        ((uint64_t)(token)))
+
+MERCURY_GEN_PROC(shm_attach_out_t,
+        ((int32_t)(ret))\
+        ((uint64_t)(segment_id)))
+
+MERCURY_GEN_PROC(shm_detach_in_t,
+        ((uint64_t)(segment_id)))
+
+MERCURY_GEN_PROC(shm_detach_out_t,
+        ((int32_t)(ret)))
+
+/* offsets are relative to the start of the segment,
+ * the output is a sum_multi_out_t */
+MERCURY_GEN_PROC(sum_shm_in_t,
+        ((uint32_t)(resource_id))\
+        ((uint64_t)(segment_id))\
+        ((uint64_t)(count))\
+        ((uint64_t)(x_offset))\
+        ((uint64_t)(y_offset))\
+        ((uint64_t)(result_offset)))
+
+/* Arrays stored by the provider (see array-store.h) */
+
+MERCURY_GEN_PROC(array_store_in_t,
+        ((uint32_t)(dtype))\
+        ((uint64_t)(count))\
+        ((alpha_bulk_location_t)(data)))
+
+MERCURY_GEN_PROC(array_store_out_t,
+        ((int32_t)(ret))\
+        ((uint64_t)(array_id)))
+
+MERCURY_GEN_PROC(array_remove_in_t,
+        ((uint64_t)(array_id)))
+
+MERCURY_GEN_PROC(array_remove_out_t,
         ((int32_t)(ret)))
 
+/* Named arrays of int32_t kept by resources (see alpha-backend.h) */
+
+MERCURY_GEN_PROC(named_create_in_t,
+        ((uint32_t)(resource_id))\
+        ((hg_string_t)(name))\
+        ((uint64_t)(count)))
+
+/* write is 1 to copy data into the array, 0 to read from it */
+MERCURY_GEN_PROC(named_io_in_t,
+        ((uint32_t)(resource_id))\
+        ((hg_string_t)(name))\
+        ((uint8_t)(write))\
+        ((uint64_t)(offset))\
+        ((uint64_t)(count))\
+        ((alpha_bulk_location_t)(data)))
+
+MERCURY_GEN_PROC(named_array_out_t,
+        ((int32_t)(ret)))
+
+/* y is elements [y_offset, y_offset+count) of the named array y_name,
+ * the output is a sum_multi_out_t */
+MERCURY_GEN_PROC(sum_named_in_t,
+        ((uint32_t)(resource_id))\
+        ((uint64_t)(count))\
+        ((alpha_bulk_location_t)(x))\
+        ((hg_string_t)(y_name))\
+        ((uint64_t)(y_offset))\
+        ((alpha_bulk_location_t)(result)))
+
+MERCURY_GEN_PROC(stats_out_t,
+        ((int32_t)(ret))\
+        ((hg_string_t)(stats)))
+
 /* FIXME: other types come here */
 
 #endif
@@ -0,0 +1,24 @@
+/*
+ * (C) 2020 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#include "wait-all.h"
+
+hg_return_t alpha_wait_request(margo_request* req)
+{
+    if(*req == MARGO_REQUEST_NULL) return HG_SUCCESS;
+    hg_return_t hret = margo_wait(*req);
+    *req = MARGO_REQUEST_NULL;
+    return hret;
+}
+
+hg_return_t alpha_wait_all(size_t count, margo_request* reqs)
+{
+    hg_return_t ret = HG_SUCCESS;
+    for(size_t i = 0; i < count; ++i) {
+        hg_return_t hret = alpha_wait_request(&reqs[i]);
+        if(ret == HG_SUCCESS) ret = hret;
+    }
+    return ret;
+}
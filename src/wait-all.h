@@ -0,0 +1,35 @@
+/*
+ * (C) 2020 The University of Chicago
+ *
+ * See COPYRIGHT in top-level directory.
+ */
+#ifndef _WAIT_ALL_H
+#define _WAIT_ALL_H
+
+#include <margo.h>
+
+/**
+ * @brief Waits for a request if it is not MARGO_REQUEST_NULL,
+ * then sets it to MARGO_REQUEST_NULL.
+ *
+ * @param[inout] req request to wait on
+ *
+ * @return the result of the operation (HG_SUCCESS for a null request).
+ */
+hg_return_t alpha_wait_request(margo_request* req);
+
+/**
+ * @brief Waits for all the requests of an array (ignoring the ones that
+ * are MARGO_REQUEST_NULL, so that the array can be partially filled).
+ * All the requests are waited on, even if some of them failed, so that
+ * the memory they use can safely be released afterwards. The requests
+ * are set to MARGO_REQUEST_NULL.
+ *
+ * @param[in] count number of requests
+ * @param[inout] reqs array of requests
+ *
+ * @return HG_SUCCESS or the first error encountered.
+ */
+hg_return_t alpha_wait_all(size_t count, margo_request* reqs);
+
+#endif
@@ -4,20 +4,45 @@
  * See COPYRIGHT in top-level directory.
  */
 #include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <cstddef>
+#include <string>
+#include <vector>
 #include <margo.h>
+#include <json-c/json.h>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_all.hpp>
 #include <alpha/alpha-server.h>
 #include <alpha/alpha-client.h>
 #include <alpha/alpha-resource.h>
+#include "../src/types.h"
+#include "../src/xxh64.h"
 
 struct test_context {
     margo_instance_id mid;
     hg_addr_t         addr;
 };
 
+/* Returns the integer found at the given path of a JSON document, e.g.
+ * {"metrics", "rpcs", "sum_multi", "calls"} in a provider's stats,
+ * or -1 if there is none */
+static int64_t json_get_int64(const char* json, const std::vector<const char*>& path)
+{
+    struct json_object* root = json_tokener_parse(json);
+    struct json_object* obj  = root;
+    for(auto key : path)
+        obj = obj ? json_object_object_get(obj, key) : nullptr;
+    int64_t value = obj && json_object_is_type(obj, json_type_int) ?
+                    json_object_get_int64(obj) : -1;
+    json_object_put(root);
+    return value;
+}
+
 static const uint16_t provider_id = 42;
-static const char* provider_config = "{ \"resource\":{ \"type\":\"dummy\", \"config\":{} } }";
+static const char* provider_config =
+    "{ \"resource\":{ \"type\":\"dummy\", \"config\":{} },"
+    "  \"shm\":{ \"enabled\":true } }";
 
 TEST_CASE("Test client interface", "[client]") {
 
@@ -32,9 +57,43 @@ TEST_CASE("Test client interface", "[client]") {
     REQUIRE(hret == HG_SUCCESS);
     // register alpha provider
     struct alpha_provider_args args = ALPHA_PROVIDER_ARGS_INIT;
+    alpha_provider_t provider = ALPHA_PROVIDER_NULL;
     ret = alpha_provider_register(
             mid, provider_id, provider_config, &args,
-            ALPHA_PROVIDER_IGNORE);
+            &provider);
+    REQUIRE(ret == ALPHA_SUCCESS);
+    // check that a backend library that can't be loaded is reported
+    ret = alpha_provider_register(
+            mid, provider_id + 1,
+            "{ \"resources\":[{ \"type\":\"foo\", \"library\":\"libalpha-does-not-exist.so\" }] }",
+            &args, ALPHA_PROVIDER_IGNORE);
+    REQUIRE(ret == ALPHA_ERR_INVALID_BACKEND);
+    // register a provider that splits large computations into
+    // small tasks running in the handler pool
+    struct alpha_provider_args compute_args = ALPHA_PROVIDER_ARGS_INIT;
+    margo_get_handler_pool(mid, &compute_args.compute_pool);
+    ret = alpha_provider_register(
+            mid, provider_id + 2,
+            "{ \"resource\":{ \"type\":\"dummy\", \"config\":{} },"
+            "  \"compute\":{ \"min_task_size\":1000, \"max_tasks\":7 } }",
+            &compute_args, ALPHA_PROVIDER_IGNORE);
+    REQUIRE(ret == ALPHA_SUCCESS);
+    // register a provider that handles one RPC of at most 1 MiB at a time
+    // and rejects others, its scalar sums taking 200ms
+    ret = alpha_provider_register(
+            mid, provider_id + 3,
+            "{ \"resource\":{ \"type\":\"dummy\", \"config\":{ \"sum_delay_ms\":200 } },"
+            "  \"admission\":{ \"max_requests\":1, \"max_bytes\":1048576,"
+            "                  \"max_queue_size\":0, \"retry_after_ms\":1 } }",
+            &args, ALPHA_PROVIDER_IGNORE);
+    REQUIRE(ret == ALPHA_SUCCESS);
+    // register a provider that caches the results of sum_multi RPCs
+    ret = alpha_provider_register(
+            mid, provider_id + 4,
+            "{ \"resource\":{ \"type\":\"dummy\", \"config\":{} },"
+            "  \"result_cache\":{ \"max_bytes\":16777216 },"
+            "  \"pipeline\":{ \"chunk_size\":65536 } }",
+            &args, ALPHA_PROVIDER_IGNORE);
     REQUIRE(ret == ALPHA_SUCCESS);
     // create test context
     auto context = std::make_unique<test_context>();
@@ -44,10 +103,129 @@ TEST_CASE("Test client interface", "[client]") {
     SECTION("Create client") {
         alpha_client_t client;
         alpha_return_t ret;
+        // run the tests with small arrays sent both inline and through RDMA
+        struct alpha_client_args client_args = ALPHA_CLIENT_ARGS_INIT;
+        client_args.eager_threshold = GENERATE(ALPHA_EAGER_THRESHOLD_AUTO, (size_t)0);
+        // the provider is in the same process, but we want to test the RPCs
+        client_args.local_shortcut = false;
         // test that we can create a client object
-        ret = alpha_client_init(context->mid, &client);
+        ret = alpha_client_init_ext(context->mid, &client_args, &client);
         REQUIRE(ret == ALPHA_SUCCESS);
 
+        SECTION("Call co-located provider directly") {
+            // test that sum_multi on a provider of the same margo
+            // instance is computed without any bulk transfer
+            struct alpha_client_args local_args = ALPHA_CLIENT_ARGS_INIT;
+            alpha_client_t local_client;
+            ret = alpha_client_init_ext(context->mid, &local_args, &local_client);
+            REQUIRE(ret == ALPHA_SUCCESS);
+            alpha_resource_handle_t rh;
+            ret = alpha_resource_handle_create(local_client,
+                    context->addr, provider_id, true, &rh);
+            REQUIRE(ret == ALPHA_SUCCESS);
+            size_t count = 100003;
+            std::vector<int32_t> x(count), y(count), result(count, 0);
+            for(size_t i = 0; i < count; ++i) {
+                x[i] = (int32_t)i;
+                y[i] = (int32_t)(2*i);
+            }
+            ret = alpha_compute_sum_multi(rh, count, x.data(), y.data(), result.data());
+            REQUIRE(ret == ALPHA_SUCCESS);
+            size_t num_errors = 0;
+            for(size_t i = 0; i < count; ++i)
+                num_errors += (result[i] != (int32_t)(3*i));
+            REQUIRE(num_errors == 0);
+            char* stats = nullptr;
+            ret = alpha_client_get_provider_stats(local_client, context->addr, provider_id, &stats);
+            REQUIRE(ret == ALPHA_SUCCESS);
+            REQUIRE(json_get_int64(stats, {"metrics", "bytes_pulled"}) == 0);
+            REQUIRE(json_get_int64(stats, {"metrics", "rpcs", "sum_multi", "calls"}) == 1);
+            REQUIRE(json_get_int64(stats, {"metrics", "rpcs", "sum_batch", "calls"}) == 0);
+            free(stats);
+            ret = alpha_resource_handle_release(rh);
+            REQUIRE(ret == ALPHA_SUCCESS);
+            ret = alpha_client_finalize(local_client);
+            REQUIRE(ret == ALPHA_SUCCESS);
+        }
+
+        SECTION("Exchange arrays through shared memory") {
+            // test that sum_multi places its arrays in the resource
+            // handle's shared-memory segment instead of using RDMA
+            struct alpha_client_args shm_args = ALPHA_CLIENT_ARGS_INIT;
+            shm_args.local_shortcut = false;
+            shm_args.shm_size = 1024*1024;
+            alpha_client_t shm_client;
+            ret = alpha_client_init_ext(context->mid, &shm_args, &shm_client);
+            REQUIRE(ret == ALPHA_SUCCESS);
+            alpha_resource_handle_t rh;
+            ret = alpha_resource_handle_create(shm_client,
+                    context->addr, provider_id, true, &rh);
+            REQUIRE(ret == ALPHA_SUCCESS);
+            size_t count = 10007;
+            // arrays outside of the segment are copied into it
+            std::vector<int32_t> x(count), y(count), result(count, 0);
+            for(size_t i = 0; i < count; ++i) {
+                x[i] = (int32_t)i;
+                y[i] = (int32_t)(2*i);
+            }
+            ret = alpha_compute_sum_multi(rh, count, x.data(), y.data(), result.data());
+            REQUIRE(ret == ALPHA_SUCCESS);
+            size_t num_errors = 0;
+            for(size_t i = 0; i < count; ++i)
+                num_errors += (result[i] != (int32_t)(3*i));
+            REQUIRE(num_errors == 0);
+            // arrays allocated in the segment are used in place
+            int32_t *shm_x = nullptr, *shm_y = nullptr, *shm_result = nullptr;
+            REQUIRE(alpha_resource_handle_shm_alloc(rh, count*sizeof(int32_t), (void**)&shm_x) == ALPHA_SUCCESS);
+            REQUIRE(alpha_resource_handle_shm_alloc(rh, count*sizeof(int32_t), (void**)&shm_y) == ALPHA_SUCCESS);
+            REQUIRE(alpha_resource_handle_shm_alloc(rh, count*sizeof(int32_t), (void**)&shm_result) == ALPHA_SUCCESS);
+            for(size_t i = 0; i < count; ++i) {
+                shm_x[i] = (int32_t)(5*i);
+                shm_y[i] = (int32_t)i;
+            }
+            ret = alpha_compute_sum_multi(rh, count, shm_x, shm_y, shm_result);
+            REQUIRE(ret == ALPHA_SUCCESS);
+            num_errors = 0;
+            for(size_t i = 0; i < count; ++i)
+                num_errors += (shm_result[i] != (int32_t)(6*i));
+            REQUIRE(num_errors == 0);
+            // test that a segment too small for the request is reported
+            void* too_large = nullptr;
+            ret = alpha_resource_handle_shm_alloc(rh, 2*1024*1024, &too_large);
+            REQUIRE(ret == ALPHA_ERR_ALLOCATION);
+            REQUIRE(alpha_resource_handle_shm_free(rh, shm_x) == ALPHA_SUCCESS);
+            REQUIRE(alpha_resource_handle_shm_free(rh, shm_y) == ALPHA_SUCCESS);
+            REQUIRE(alpha_resource_handle_shm_free(rh, shm_result) == ALPHA_SUCCESS);
+            REQUIRE(alpha_resource_handle_shm_free(rh, shm_result) == ALPHA_ERR_INVALID_ARGS);
+            char* stats = nullptr;
+            ret = alpha_client_get_provider_stats(shm_client, context->addr, provider_id, &stats);
+            REQUIRE(ret == ALPHA_SUCCESS);
+            REQUIRE(json_get_int64(stats, {"metrics", "bytes_pulled"}) == 0);
+            REQUIRE(json_get_int64(stats, {"metrics", "rpcs", "sum_shm", "calls"}) == 2);
+            REQUIRE(json_get_int64(stats, {"metrics", "rpcs", "sum_multi", "calls"}) == 0);
+            free(stats);
+            ret = alpha_resource_handle_release(rh);
+            REQUIRE(ret == ALPHA_SUCCESS);
+            // test that a provider that doesn't enable shm (the default)
+            // refuses the segment, sum_multi falling back to RPCs
+            ret = alpha_resource_handle_create(shm_client,
+                    context->addr, provider_id + 2, true, &rh);
+            REQUIRE(ret == ALPHA_SUCCESS);
+            ret = alpha_resource_handle_shm_alloc(rh, 64, (void**)&shm_x);
+            REQUIRE(ret == ALPHA_ERR_OP_UNSUPPORTED);
+            result.assign(count, 0);
+            ret = alpha_compute_sum_multi(rh, count, x.data(), y.data(), result.data());
+            REQUIRE(ret == ALPHA_SUCCESS);
+            num_errors = 0;
+            for(size_t i = 0; i < count; ++i)
+                num_errors += (result[i] != (int32_t)(3*i));
+            REQUIRE(num_errors == 0);
+            ret = alpha_resource_handle_release(rh);
+            REQUIRE(ret == ALPHA_SUCCESS);
+            ret = alpha_client_finalize(shm_client);
+            REQUIRE(ret == ALPHA_SUCCESS);
+        }
+
         SECTION("Open resource") {
             alpha_resource_handle_t rh;
             // test that we can create a resource handle
@@ -77,6 +255,77 @@ TEST_CASE("Test client interface", "[client]") {
                 REQUIRE(result == 100);
             }
 
+            SECTION("Send async RPCs") {
+                // test that we can have many RPCs in flight
+                const size_t n = 64;
+                std::vector<alpha_request_t> reqs(n, ALPHA_REQUEST_NULL);
+                std::vector<int32_t> results(n, 0);
+                for(size_t i = 0; i < n; ++i) {
+                    ret = alpha_compute_sum_async(rh, (int32_t)i, 1, &results[i], &reqs[i]);
+                    REQUIRE(ret == ALPHA_SUCCESS);
+                }
+                int flag = 0;
+                ret = alpha_request_test(reqs[0], &flag);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                // wait for half of them in any order
+                for(size_t j = 0; j < n/2; ++j) {
+                    size_t index = n;
+                    ret = alpha_request_wait_any(n, reqs.data(), &index);
+                    REQUIRE(ret == ALPHA_SUCCESS);
+                    REQUIRE(index < n);
+                    REQUIRE(reqs[index] == ALPHA_REQUEST_NULL);
+                    REQUIRE(results[index] == (int32_t)index + 1);
+                }
+                // and the other half all at once
+                ret = alpha_request_wait_all(n, reqs.data());
+                REQUIRE(ret == ALPHA_SUCCESS);
+                for(size_t i = 0; i < n; ++i) {
+                    REQUIRE(reqs[i] == ALPHA_REQUEST_NULL);
+                    REQUIRE(results[i] == (int32_t)i + 1);
+                }
+                size_t index;
+                ret = alpha_request_wait_any(n, reqs.data(), &index);
+                REQUIRE(ret == ALPHA_ERR_INVALID_ARGS);
+
+                // non-blocking sum_multi
+                int32_t x[3] = {1,2,3};
+                int32_t y[3] = {4,5,6};
+                int32_t result[3] = {0,0,0};
+                alpha_request_t req = ALPHA_REQUEST_NULL;
+                ret = alpha_compute_sum_multi_async(rh, 3, x, y, result, &req);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                ret = alpha_request_wait(req);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                REQUIRE(result[0] == 5);
+                REQUIRE(result[1] == 7);
+                REQUIRE(result[2] == 9);
+            }
+
+            SECTION("Send coalesced sum RPCs") {
+                // batches of 16 sums, the last (partial) batch
+                // being sent after 1ms
+                ret = alpha_resource_handle_set_coalescing(rh, 16, 1000.0);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                const size_t n = 40;
+                std::vector<alpha_request_t> reqs(n, ALPHA_REQUEST_NULL);
+                std::vector<int32_t> results(n, 0);
+                for(size_t i = 0; i < n; ++i) {
+                    ret = alpha_compute_sum_async(rh, (int32_t)i, 2, &results[i], &reqs[i]);
+                    REQUIRE(ret == ALPHA_SUCCESS);
+                }
+                ret = alpha_request_wait_all(n, reqs.data());
+                REQUIRE(ret == ALPHA_SUCCESS);
+                for(size_t i = 0; i < n; ++i)
+                    REQUIRE(results[i] == (int32_t)i + 2);
+                // blocking calls complete when the batch is sent
+                int32_t result = 0;
+                ret = alpha_compute_sum(rh, 45, 55, &result);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                REQUIRE(result == 100);
+                ret = alpha_resource_handle_set_coalescing(rh, 0, 0);
+                REQUIRE(ret == ALPHA_SUCCESS);
+            }
+
             SECTION("Send sum_multi RPC") {
                 // test that we can send a sum RPC to the resource
                 int32_t x[3] = {1,2,3};
@@ -87,6 +336,616 @@ TEST_CASE("Test client interface", "[client]") {
                 REQUIRE(result[0] == 5);
                 REQUIRE(result[1] == 7);
                 REQUIRE(result[2] == 9);
+                if(client_args.eager_threshold == 0) {
+                    // the second call should reuse the buffer registered by the first
+                    ret = alpha_compute_sum_multi(rh, 3, x, y, result);
+                    REQUIRE(ret == ALPHA_SUCCESS);
+                    char* stats = alpha_provider_get_stats(provider);
+                    REQUIRE(stats != nullptr);
+                    REQUIRE(std::string{stats}.find("\"hits\": 1") != std::string::npos);
+                    free(stats);
+                }
+            }
+
+            SECTION("Send sum_batch RPC with an oversized count") {
+                // test that the provider refuses to allocate inline arrays
+                // larger than ALPHA_MAX_INLINE_COUNT, which the client API
+                // never sends, by forwarding the RPC directly
+                hg_id_t sum_batch_id;
+                hg_bool_t flag;
+                hret = margo_registered_name(context->mid, "alpha_sum_batch", &sum_batch_id, &flag);
+                REQUIRE(hret == HG_SUCCESS);
+                REQUIRE(flag == HG_TRUE);
+                std::vector<int32_t> x(ALPHA_MAX_INLINE_COUNT + 1, 1);
+                sum_batch_in_t in;
+                in.resource_id = 0;
+                in.count       = x.size();
+                in.x           = x.data();
+                in.y           = x.data();
+                hg_handle_t h;
+                hret = margo_create(context->mid, context->addr, sum_batch_id, &h);
+                REQUIRE(hret == HG_SUCCESS);
+                hret = margo_provider_forward(provider_id, h, &in);
+                REQUIRE(hret == HG_SUCCESS);
+                sum_batch_out_t out;
+                hret = margo_get_output(h, &out);
+                REQUIRE(hret == HG_SUCCESS);
+                REQUIRE(out.ret == ALPHA_ERR_FROM_MERCURY);
+                REQUIRE(out.count == 0);
+                margo_free_output(h, &out);
+                margo_destroy(h);
+            }
+
+            SECTION("Send RPCs of different types") {
+                // test that handles cached by the resource handle
+                // can be reused for another RPC
+                int32_t x[3] = {1,2,3};
+                int32_t y[3] = {4,5,6};
+                int32_t result[3] = {0,0,0};
+                for(int i = 0; i < 4; ++i) {
+                    int32_t r = 0;
+                    ret = alpha_compute_sum(rh, i, 1, &r);
+                    REQUIRE(ret == ALPHA_SUCCESS);
+                    REQUIRE(r == i + 1);
+                    ret = alpha_compute_sum_multi(rh, 3, x, y, result);
+                    REQUIRE(ret == ALPHA_SUCCESS);
+                    REQUIRE(result[2] == 9);
+                }
+            }
+
+            SECTION("Send RPCs to a busy provider") {
+                // test that, while a sum holds the provider's only slot,
+                // RPCs are rejected with ALPHA_ERR_BUSY by a provider that
+                // doesn't queue them, and resent successfully by a client
+                // that retries for long enough
+                struct alpha_client_args busy_args = client_args;
+                busy_args.max_retries = 0;
+                alpha_client_t busy_client;
+                ret = alpha_client_init_ext(context->mid, &busy_args, &busy_client);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                struct alpha_client_args retry_args = client_args;
+                retry_args.max_retries = 10; // backing off for more than 1s
+                alpha_client_t retry_client;
+                ret = alpha_client_init_ext(context->mid, &retry_args, &retry_client);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                alpha_resource_handle_t rh4, rh5;
+                ret = alpha_resource_handle_create(busy_client,
+                        context->addr, provider_id + 3, true, &rh4);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                ret = alpha_resource_handle_create(retry_client,
+                        context->addr, provider_id + 3, true, &rh5);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                // hold the slot and wait until the sum has been admitted
+                int32_t held_result = 0;
+                alpha_request_t held = ALPHA_REQUEST_NULL;
+                ret = alpha_compute_sum_async(rh4, 1, 2, &held_result, &held);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                char* stats = nullptr;
+                int64_t in_flight = 0;
+                for(int i = 0; i < 100 && in_flight != 1; ++i) {
+                    ret = alpha_client_get_provider_stats(client, context->addr, provider_id + 3, &stats);
+                    REQUIRE(ret == ALPHA_SUCCESS);
+                    in_flight = json_get_int64(stats, {"admission", "in_flight_requests"});
+                    free(stats);
+                    if(in_flight != 1) margo_thread_sleep(context->mid, 1);
+                }
+                REQUIRE(in_flight == 1);
+                int32_t result = 0;
+                ret = alpha_compute_sum(rh4, 3, 4, &result);
+                REQUIRE(ret == ALPHA_ERR_BUSY);
+                ret = alpha_compute_sum(rh5, 5, 6, &result);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                REQUIRE(result == 11);
+                ret = alpha_request_wait(held);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                REQUIRE(held_result == 3);
+                ret = alpha_client_get_provider_stats(client, context->addr, provider_id + 3, &stats);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                // the first attempt of the retried sum was rejected too
+                REQUIRE(json_get_int64(stats, {"admission", "rejected"}) >= 2);
+                REQUIRE(json_get_int64(stats, {"admission", "in_flight_requests"}) == 0);
+                free(stats);
+                // test that an RPC needing more than max_bytes of scratch
+                // memory (x and y, 1 MiB each) is rejected, even alone
+                std::vector<int32_t> x(262144, 1), y(262144, 2), r(262144, 0);
+                ret = alpha_compute_sum_multi(rh4, x.size(), x.data(), y.data(), r.data());
+                REQUIRE(ret == ALPHA_ERR_ALLOCATION);
+                ret = alpha_resource_handle_release(rh4);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                ret = alpha_resource_handle_release(rh5);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                ret = alpha_client_finalize(busy_client);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                ret = alpha_client_finalize(retry_client);
+                REQUIRE(ret == ALPHA_SUCCESS);
+            }
+
+            SECTION("Get provider stats") {
+                // test that RPCs are accounted for in the provider's metrics
+                int32_t result = 0;
+                ret = alpha_compute_sum(rh, 45, 55, &result);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                char* stats = nullptr;
+                ret = alpha_client_get_provider_stats(client, context->addr, provider_id, &stats);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                REQUIRE(stats != nullptr);
+                auto stats_str = std::string{stats};
+                free(stats);
+                REQUIRE(stats_str.find("\"calls\": 1") != std::string::npos);
+                REQUIRE(stats_str.find("\"deserialize\"") != std::string::npos);
+                REQUIRE(stats_str.find("\"p99_ns\"") != std::string::npos);
+            }
+
+            SECTION("Add and remove resources") {
+                // test that a provider can host several resources
+                uint32_t resource_id = 0;
+                ret = alpha_provider_add_resource(provider, "dummy", "{}", &resource_id);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                REQUIRE(resource_id == 1);
+                uint32_t invalid_id = 0;
+                ret = alpha_provider_add_resource(provider, "unknown", NULL, &invalid_id);
+                REQUIRE(ret == ALPHA_ERR_INVALID_BACKEND);
+
+                alpha_resource_handle_t rh1;
+                ret = alpha_resource_handle_create_with_id(client,
+                        context->addr, provider_id, resource_id, true, &rh1);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                int32_t result = 0;
+                ret = alpha_compute_sum(rh1, 45, 55, &result);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                REQUIRE(result == 100);
+
+                // test that a removed resource can't be used anymore
+                ret = alpha_provider_remove_resource(provider, resource_id);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                ret = alpha_compute_sum(rh1, 45, 55, &result);
+                REQUIRE(ret == ALPHA_ERR_INVALID_RESOURCE);
+                ret = alpha_provider_remove_resource(provider, resource_id);
+                REQUIRE(ret == ALPHA_ERR_INVALID_RESOURCE);
+                ret = alpha_resource_handle_release(rh1);
+                REQUIRE(ret == ALPHA_SUCCESS);
+
+                // the resource with id 0 is unaffected
+                ret = alpha_compute_sum(rh, 45, 55, &result);
+                REQUIRE(ret == ALPHA_SUCCESS);
+            }
+
+            SECTION("Send sum_multi RPC with registered buffers") {
+                // test that arrays within registered buffers are used
+                // without being registered again
+                int32_t data[9] = {1,2,3,4,5,6,0,0,0};
+                ret = alpha_client_register_buffer(client, data, sizeof(data));
+                REQUIRE(ret == ALPHA_SUCCESS);
+                // overlapping registrations are not allowed
+                ret = alpha_client_register_buffer(client, data+1, sizeof(int32_t));
+                REQUIRE(ret == ALPHA_ERR_INVALID_ARGS);
+                for(int i = 0; i < 2; ++i) {
+                    ret = alpha_compute_sum_multi(rh, 3, data, data+3, data+6);
+                    REQUIRE(ret == ALPHA_SUCCESS);
+                    REQUIRE(data[6] == 5);
+                    REQUIRE(data[7] == 7);
+                    REQUIRE(data[8] == 9);
+                }
+                // mixing registered and non-registered arrays
+                int32_t y[3] = {10,20,30};
+                ret = alpha_compute_sum_multi(rh, 3, data, y, data+6);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                REQUIRE(data[6] == 11);
+                REQUIRE(data[7] == 22);
+                REQUIRE(data[8] == 33);
+                ret = alpha_client_unregister_buffer(client, data);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                ret = alpha_client_unregister_buffer(client, data);
+                REQUIRE(ret == ALPHA_ERR_INVALID_ARGS);
+            }
+
+            SECTION("Send large sum_multi RPC") {
+                // test that a request larger than the pipeline's chunk size
+                // is correctly streamed through the provider
+                size_t count = 1000003;
+                std::vector<int32_t> x(count), y(count), result(count, 0);
+                for(size_t i = 0; i < count; ++i) {
+                    x[i] = (int32_t)i;
+                    y[i] = (int32_t)(2*i);
+                }
+                ret = alpha_compute_sum_multi(rh, count, x.data(), y.data(), result.data());
+                REQUIRE(ret == ALPHA_SUCCESS);
+                size_t num_errors = 0;
+                for(size_t i = 0; i < count; ++i)
+                    num_errors += (result[i] != (int32_t)(3*i));
+                REQUIRE(num_errors == 0);
+            }
+
+            SECTION("Send accumulate RPC") {
+                // test that y += x is computed in y's region, both
+                // directly and through the pipeline
+                size_t count = GENERATE((size_t)1000, (size_t)1000003);
+                std::vector<int32_t> data(2*count);
+                for(size_t i = 0; i < count; ++i) {
+                    data[i]         = (int32_t)i;
+                    data[count + i] = (int32_t)(2*i);
+                }
+                void* ptrs[1] = { data.data() };
+                hg_size_t sizes[1] = { data.size()*sizeof(int32_t) };
+                hg_bulk_t bulk = HG_BULK_NULL;
+                hret = margo_bulk_create(context->mid, 1, ptrs, sizes, HG_BULK_READWRITE, &bulk);
+                REQUIRE(hret == HG_SUCCESS);
+                char address[256];
+                hg_size_t address_size = sizeof(address);
+                hret = margo_addr_to_string(context->mid, address, &address_size, context->addr);
+                REQUIRE(hret == HG_SUCCESS);
+                alpha_bulk_location_t x_bl = {
+                    bulk, address, 0, (int64_t)(count*sizeof(int32_t))
+                };
+                alpha_bulk_location_t y_bl = x_bl;
+                y_bl.offset = (int64_t)(count*sizeof(int32_t));
+                ret = alpha_compute_accumulate_bulk(rh, count, &x_bl, &y_bl);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                size_t num_errors = 0;
+                for(size_t i = 0; i < count; ++i)
+                    num_errors += (data[i] != (int32_t)i) + (data[count + i] != (int32_t)(3*i));
+                REQUIRE(num_errors == 0);
+                // test that a region smaller than the arrays is rejected
+                x_bl.size = (int64_t)((count - 1)*sizeof(int32_t));
+                ret = alpha_compute_accumulate_bulk(rh, count, &x_bl, &y_bl);
+                REQUIRE(ret == ALPHA_ERR_INVALID_ARGS);
+                margo_bulk_free(bulk);
+            }
+
+            SECTION("Send reduce RPCs") {
+                // test that reductions return the same values as local
+                // loops, both directly and in chunks
+                size_t count = GENERATE((size_t)1000, (size_t)1000003);
+                std::vector<int32_t> data(2*count);
+                int64_t sum = 0, dot = 0;
+                for(size_t i = 0; i < count; ++i) {
+                    data[i]         = (int32_t)i - (int32_t)(count/2);
+                    data[count + i] = (int32_t)(i % 7);
+                    sum += data[i];
+                    dot += (int64_t)data[i]*data[count + i];
+                }
+                void* ptrs[1] = { data.data() };
+                hg_size_t sizes[1] = { data.size()*sizeof(int32_t) };
+                hg_bulk_t bulk = HG_BULK_NULL;
+                hret = margo_bulk_create(context->mid, 1, ptrs, sizes, HG_BULK_READ_ONLY, &bulk);
+                REQUIRE(hret == HG_SUCCESS);
+                char address[256];
+                hg_size_t address_size = sizeof(address);
+                hret = margo_addr_to_string(context->mid, address, &address_size, context->addr);
+                REQUIRE(hret == HG_SUCCESS);
+                alpha_bulk_location_t x_bl = {
+                    bulk, address, 0, (int64_t)(count*sizeof(int32_t))
+                };
+                alpha_bulk_location_t y_bl = x_bl;
+                y_bl.offset = (int64_t)(count*sizeof(int32_t));
+                int64_t result = 0;
+                ret = alpha_compute_reduce_bulk(rh, ALPHA_REDUCE_SUM, count, &x_bl, nullptr, &result);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                REQUIRE(result == sum);
+                ret = alpha_compute_reduce_bulk(rh, ALPHA_REDUCE_MIN, count, &x_bl, nullptr, &result);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                REQUIRE(result == -(int64_t)(count/2));
+                ret = alpha_compute_reduce_bulk(rh, ALPHA_REDUCE_MAX, count, &x_bl, nullptr, &result);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                REQUIRE(result == (int64_t)(count - 1 - count/2));
+                ret = alpha_compute_reduce_bulk(rh, ALPHA_REDUCE_DOT, count, &x_bl, &y_bl, &result);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                REQUIRE(result == dot);
+                // a dot product needs y, and min and max need elements
+                ret = alpha_compute_reduce_bulk(rh, ALPHA_REDUCE_DOT, count, &x_bl, nullptr, &result);
+                REQUIRE(ret == ALPHA_ERR_INVALID_ARGS);
+                ret = alpha_compute_reduce_bulk(rh, ALPHA_REDUCE_MIN, 0, &x_bl, nullptr, &result);
+                REQUIRE(ret == ALPHA_ERR_INVALID_ARGS);
+                margo_bulk_free(bulk);
+            }
+
+            SECTION("Send typed sum_multi RPCs") {
+                // test arrays of each type, both directly and through
+                // the pipeline
+                size_t count = GENERATE((size_t)1000, (size_t)1000003);
+                std::vector<int64_t> xl(count), yl(count), rl(count, 0);
+                std::vector<float>   xf(count), yf(count), rf(count, 0);
+                std::vector<double>  xd(count), yd(count), rd(count, 0);
+                for(size_t i = 0; i < count; ++i) {
+                    xl[i] = (int64_t)i << 32;
+                    yl[i] = -(int64_t)i;
+                    xf[i] = (float)i*0.5f;
+                    yf[i] = 1.0f;
+                    xd[i] = (double)i*0.25;
+                    yd[i] = (double)i;
+                }
+                ret = alpha_compute_sum_multi_typed(rh, ALPHA_DTYPE_I64, count, xl.data(), yl.data(), rl.data());
+                REQUIRE(ret == ALPHA_SUCCESS);
+                ret = alpha_compute_sum_multi_typed(rh, ALPHA_DTYPE_F32, count, xf.data(), yf.data(), rf.data());
+                REQUIRE(ret == ALPHA_SUCCESS);
+                ret = alpha_compute_sum_multi_typed(rh, ALPHA_DTYPE_F64, count, xd.data(), yd.data(), rd.data());
+                REQUIRE(ret == ALPHA_SUCCESS);
+                size_t num_errors = 0;
+                for(size_t i = 0; i < count; ++i) {
+                    num_errors += (rl[i] != xl[i] + yl[i]);
+                    num_errors += (rf[i] != xf[i] + yf[i]);
+                    num_errors += (rd[i] != xd[i] + yd[i]);
+                }
+                REQUIRE(num_errors == 0);
+                ret = alpha_compute_sum_multi_typed(rh, (alpha_dtype_t)42, count, xd.data(), yd.data(), rd.data());
+                REQUIRE(ret == ALPHA_ERR_INVALID_ARGS);
+            }
+
+            SECTION("Send sum_strided RPC") {
+                // test fields of records, transferred through windows of
+                // their span (several ones, since the records take more
+                // than 1 MiB), and arrays made of segments
+                struct record { int32_t a; int32_t b; int32_t c; int32_t d; };
+                size_t count = 100003;
+                std::vector<record> records(count);
+                std::vector<int32_t> result(2*count, 0);
+                for(size_t i = 0; i < count; ++i)
+                    records[i] = { (int32_t)i, (int32_t)(2*i), 0, -1 };
+                void* ptrs[2] = { records.data(), result.data() };
+                hg_size_t sizes[2] = { count*sizeof(record), result.size()*sizeof(int32_t) };
+                hg_bulk_t bulk = HG_BULK_NULL;
+                hret = margo_bulk_create(context->mid, 2, ptrs, sizes, HG_BULK_READWRITE, &bulk);
+                REQUIRE(hret == HG_SUCCESS);
+                char address[256];
+                hg_size_t address_size = sizeof(address);
+                hret = margo_addr_to_string(context->mid, address, &address_size, context->addr);
+                REQUIRE(hret == HG_SUCCESS);
+                alpha_strided_location_t a_loc = {
+                    bulk, address, offsetof(record, a), sizeof(record), 0, nullptr
+                };
+                alpha_strided_location_t b_loc = a_loc;
+                b_loc.offset = offsetof(record, b);
+                alpha_strided_location_t c_loc = a_loc;
+                c_loc.offset = offsetof(record, c);
+                alpha_strided_location_t r_loc = a_loc;
+                r_loc.offset = (int64_t)(count*sizeof(record));
+                r_loc.stride = sizeof(int32_t);
+                // a and b into c, leaving d untouched
+                ret = alpha_compute_sum_strided(rh, ALPHA_DTYPE_I32, count, &a_loc, &b_loc, &c_loc);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                size_t num_errors = 0;
+                for(size_t i = 0; i < count; ++i)
+                    num_errors += (records[i].c != (int32_t)(3*i)) + (records[i].d != -1);
+                REQUIRE(num_errors == 0);
+                // the first halves of the first records, as an array made
+                // of segments, into a packed array
+                size_t num_segments = 1000;
+                std::vector<alpha_segment_t> segments(num_segments);
+                for(size_t i = 0; i < num_segments; ++i)
+                    segments[i] = { (int64_t)(i*sizeof(record)), 2*sizeof(int32_t) };
+                alpha_strided_location_t ab_loc = a_loc;
+                ab_loc.offset       = 0;
+                ab_loc.num_segments = num_segments;
+                ab_loc.segments     = segments.data();
+                ret = alpha_compute_sum_strided(rh, ALPHA_DTYPE_I32, 2*num_segments, &ab_loc, &ab_loc, &r_loc);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                for(size_t i = 0; i < num_segments; ++i)
+                    num_errors += (result[2*i] != (int32_t)(2*i)) + (result[2*i + 1] != (int32_t)(4*i));
+                REQUIRE(num_errors == 0);
+                // the segments should add up to the size of the array
+                ret = alpha_compute_sum_strided(rh, ALPHA_DTYPE_I32, num_segments, &ab_loc, &ab_loc, &r_loc);
+                REQUIRE(ret == ALPHA_ERR_INVALID_ARGS);
+                // a stride smaller than an element is invalid
+                r_loc.stride = 1;
+                ret = alpha_compute_sum_strided(rh, ALPHA_DTYPE_I32, count, &a_loc, &b_loc, &r_loc);
+                REQUIRE(ret == ALPHA_ERR_INVALID_ARGS);
+                // so is an array that goes past the end of its bulk handle
+                r_loc.stride = sizeof(int32_t);
+                r_loc.offset += (int64_t)(count*sizeof(int32_t) + 1);
+                ret = alpha_compute_sum_strided(rh, ALPHA_DTYPE_I32, count, &a_loc, &b_loc, &r_loc);
+                REQUIRE(ret == ALPHA_ERR_INVALID_ARGS);
+                margo_bulk_free(bulk);
+            }
+
+            SECTION("Send sum_stored RPCs") {
+                // test that a stored array can be added to several x
+                // arrays, both directly and through the pipeline
+                size_t count = GENERATE((size_t)1000, (size_t)1000003);
+                std::vector<int32_t> x(count), y(count), result(count, 0);
+                for(size_t i = 0; i < count; ++i)
+                    y[i] = (int32_t)(2*i);
+                uint64_t y_id = 0;
+                ret = alpha_store_array(rh, ALPHA_DTYPE_I32, count, y.data(), &y_id);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                for(int32_t k = 0; k < 3; ++k) {
+                    for(size_t i = 0; i < count; ++i)
+                        x[i] = (int32_t)i + k;
+                    ret = alpha_compute_sum_stored(rh, ALPHA_DTYPE_I32, count, x.data(), y_id, result.data());
+                    REQUIRE(ret == ALPHA_SUCCESS);
+                    size_t num_errors = 0;
+                    for(size_t i = 0; i < count; ++i)
+                        num_errors += (result[i] != (int32_t)(3*i) + k);
+                    REQUIRE(num_errors == 0);
+                }
+                // the type and number of elements should match the stored array
+                ret = alpha_compute_sum_stored(rh, ALPHA_DTYPE_F32, count, x.data(), y_id, result.data());
+                REQUIRE(ret == ALPHA_ERR_INVALID_ARGS);
+                x.resize(count + 1);
+                result.resize(count + 1);
+                ret = alpha_compute_sum_stored(rh, ALPHA_DTYPE_I32, count + 1, x.data(), y_id, result.data());
+                REQUIRE(ret == ALPHA_ERR_INVALID_ARGS);
+                ret = alpha_remove_array(rh, y_id);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                ret = alpha_remove_array(rh, y_id);
+                REQUIRE(ret == ALPHA_ERR_INVALID_ARRAY);
+                ret = alpha_compute_sum_stored(rh, ALPHA_DTYPE_I32, count, x.data(), y_id, result.data());
+                REQUIRE(ret == ALPHA_ERR_INVALID_ARRAY);
+            }
+
+            SECTION("Use named arrays of a files resource") {
+                // test that named arrays can be written, read, and added to
+                // x arrays, both directly and through the pipeline, and that
+                // they outlive the resource
+                char path[] = "/tmp/alpha-files-XXXXXX";
+                REQUIRE(mkdtemp(path) != NULL);
+                std::string config = std::string("{\"path\":\"") + path + "\"}";
+                size_t count = GENERATE((size_t)1000, (size_t)1000003);
+                uint32_t resource_id = 0;
+                ret = alpha_provider_add_resource(provider, "files", config.c_str(), &resource_id);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                alpha_resource_handle_t rh1;
+                ret = alpha_resource_handle_create_with_id(client,
+                        context->addr, provider_id, resource_id, true, &rh1);
+                REQUIRE(ret == ALPHA_SUCCESS);
+
+                std::vector<int32_t> x(count), y(count), result(count, 0);
+                for(size_t i = 0; i < count; ++i) {
+                    x[i] = (int32_t)i;
+                    y[i] = (int32_t)(2*i);
+                }
+                ret = alpha_create_named_array(rh1, "y", count + 10);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                ret = alpha_create_named_array(rh1, "y", count);
+                REQUIRE(ret == ALPHA_ERR_INVALID_ARGS);
+                ret = alpha_create_named_array(rh1, "../y", count);
+                REQUIRE(ret == ALPHA_ERR_INVALID_ARGS);
+                ret = alpha_write_named_array(rh1, "y", 10, count, y.data());
+                REQUIRE(ret == ALPHA_SUCCESS);
+                ret = alpha_write_named_array(rh1, "y", 11, count, y.data());
+                REQUIRE(ret == ALPHA_ERR_INVALID_ARGS);
+                ret = alpha_compute_sum_named(rh1, count, x.data(), "y", 10, result.data());
+                REQUIRE(ret == ALPHA_SUCCESS);
+                size_t num_errors = 0;
+                for(size_t i = 0; i < count; ++i)
+                    num_errors += (result[i] != (int32_t)(3*i));
+                REQUIRE(num_errors == 0);
+                ret = alpha_compute_sum_named(rh1, count, x.data(), "z", 0, result.data());
+                REQUIRE(ret == ALPHA_ERR_INVALID_ARRAY);
+                // the dummy backend doesn't have named arrays
+                ret = alpha_compute_sum_named(rh, count, x.data(), "y", 0, result.data());
+                REQUIRE(ret == ALPHA_ERR_OP_UNSUPPORTED);
+
+                // a new resource on the same directory sees the array
+                ret = alpha_provider_remove_resource(provider, resource_id);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                ret = alpha_resource_handle_release(rh1);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                ret = alpha_provider_add_resource(provider, "files", config.c_str(), &resource_id);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                ret = alpha_resource_handle_create_with_id(client,
+                        context->addr, provider_id, resource_id, true, &rh1);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                std::vector<int32_t> z(count + 10, -1);
+                ret = alpha_read_named_array(rh1, "y", 0, count + 10, z.data());
+                REQUIRE(ret == ALPHA_SUCCESS);
+                num_errors = 0;
+                for(size_t i = 0; i < 10; ++i)
+                    num_errors += (z[i] != 0);
+                for(size_t i = 0; i < count; ++i)
+                    num_errors += (z[i + 10] != y[i]);
+                REQUIRE(num_errors == 0);
+
+                ret = alpha_provider_remove_resource(provider, resource_id);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                ret = alpha_resource_handle_release(rh1);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                REQUIRE(unlink((std::string(path) + "/y.i32").c_str()) == 0);
+                REQUIRE(rmdir(path) == 0);
+            }
+
+            SECTION("Send sum_multi RPCs to a provider with a result cache") {
+                // test that identical sum_multi RPCs are answered from the
+                // cache, both directly and through the pipeline (one entry
+                // per chunk)
+                alpha_resource_handle_t rh5;
+                ret = alpha_resource_handle_create(client,
+                        context->addr, provider_id + 4, true, &rh5);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                size_t count = GENERATE((size_t)1000, (size_t)100000);
+                size_t num_chunks = (count*sizeof(int64_t) + 65535)/65536;
+                std::vector<int64_t> x(count), y(count), result(count, 0);
+                for(size_t i = 0; i < count; ++i) {
+                    x[i] = (int64_t)i;
+                    y[i] = (int64_t)(2*i);
+                }
+                for(int k = 0; k < 3; ++k) {
+                    if(k == 2) x[0] = 42;
+                    result.assign(count, 0);
+                    ret = alpha_compute_sum_multi_typed(rh5, ALPHA_DTYPE_I64, count,
+                            x.data(), y.data(), result.data());
+                    REQUIRE(ret == ALPHA_SUCCESS);
+                    size_t num_errors = 0;
+                    for(size_t i = 0; i < count; ++i)
+                        num_errors += (result[i] != x[i] + y[i]);
+                    REQUIRE(num_errors == 0);
+                }
+                char* stats = nullptr;
+                ret = alpha_client_get_provider_stats(client, context->addr, provider_id + 4, &stats);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                auto stats_str = std::string{stats};
+                free(stats);
+                // changing x[0] only changes the first chunk
+                auto expected = "\"result_cache\": { \"hits\": " + std::to_string(2*num_chunks - 1)
+                              + ", \"misses\": " + std::to_string(num_chunks + 1) + ",";
+                REQUIRE(stats_str.find(expected) != std::string::npos);
+                ret = alpha_resource_handle_release(rh5);
+                REQUIRE(ret == ALPHA_SUCCESS);
+            }
+
+            SECTION("Send small sum_multi RPCs to a provider with a result cache") {
+                // test that arrays sent inline (as sum_batch RPCs) are
+                // cached as well as the ones pulled through RDMA
+                alpha_resource_handle_t rh5;
+                ret = alpha_resource_handle_create(client,
+                        context->addr, provider_id + 4, true, &rh5);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                int32_t x[3] = {1,2,3};
+                int32_t y[3] = {4,5,6};
+                for(int k = 0; k < 2; ++k) {
+                    int32_t result[3] = {0,0,0};
+                    ret = alpha_compute_sum_multi(rh5, 3, x, y, result);
+                    REQUIRE(ret == ALPHA_SUCCESS);
+                    REQUIRE(result[0] == 5);
+                    REQUIRE(result[1] == 7);
+                    REQUIRE(result[2] == 9);
+                }
+                char* stats = nullptr;
+                ret = alpha_client_get_provider_stats(client, context->addr, provider_id + 4, &stats);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                const char* rpc = client_args.eager_threshold == 0 ? "sum_multi" : "sum_batch";
+                REQUIRE(json_get_int64(stats, {"metrics", "rpcs", rpc, "calls"}) == 2);
+                REQUIRE(json_get_int64(stats, {"result_cache", "hits"}) == 1);
+                REQUIRE(json_get_int64(stats, {"result_cache", "misses"}) == 1);
+                free(stats);
+                ret = alpha_resource_handle_release(rh5);
+                REQUIRE(ret == ALPHA_SUCCESS);
+            }
+
+            SECTION("Send sum_multi RPC split into compute tasks") {
+                // test that a computation split across the compute pool
+                // (with task boundaries not multiple of the task size)
+                // produces the same result
+                alpha_resource_handle_t rh3;
+                ret = alpha_resource_handle_create(client,
+                        context->addr, provider_id + 2, true, &rh3);
+                REQUIRE(ret == ALPHA_SUCCESS);
+                size_t count = GENERATE((size_t)999, (size_t)5003, (size_t)100003);
+                std::vector<int32_t> x(count), y(count), result(count, 0);
+                for(size_t i = 0; i < count; ++i) {
+                    x[i] = (int32_t)i;
+                    y[i] = (int32_t)(2*i);
+                }
+                ret = alpha_compute_sum_multi(rh3, count, x.data(), y.data(), result.data());
+                REQUIRE(ret == ALPHA_SUCCESS);
+                size_t num_errors = 0;
+                for(size_t i = 0; i < count; ++i)
+                    num_errors += (result[i] != (int32_t)(3*i));
+                REQUIRE(num_errors == 0);
+                // arrays of other types are split in the same way
+                std::vector<double> dx(count), dy(count), dresult(count, 0.0);
+                for(size_t i = 0; i < count; ++i) {
+                    dx[i] = 0.5*(double)i;
+                    dy[i] = (double)i;
+                }
+                ret = alpha_compute_sum_multi_typed(rh3, ALPHA_DTYPE_F64, count,
+                        dx.data(), dy.data(), dresult.data());
+                REQUIRE(ret == ALPHA_SUCCESS);
+                num_errors = 0;
+                for(size_t i = 0; i < count; ++i)
+                    num_errors += (dresult[i] != 1.5*(double)i);
+                REQUIRE(num_errors == 0);
+                ret = alpha_resource_handle_release(rh3);
+                REQUIRE(ret == ALPHA_SUCCESS);
             }
 
             // test that we can increase the ref count
@@ -111,3 +970,13 @@ TEST_CASE("Test client interface", "[client]") {
     // munit because we need margo_finalize to be called no matter what.
     margo_finalize(context->mid);
 }
+
+TEST_CASE("Test the hash function of the result cache", "[result-cache]") {
+    // reference values of XXH64 with a seed of 0, the last
+    // input being long enough to go through the 32-byte stripes
+    REQUIRE(alpha_xxh64("", 0, 0) == 0xEF46DB3751D8E999ULL);
+    REQUIRE(alpha_xxh64("a", 1, 0) == 0xD24EC4F1A98C6E5BULL);
+    REQUIRE(alpha_xxh64("abc", 3, 0) == 0x44BC2CF5AD770999ULL);
+    const std::string fox = "The quick brown fox jumps over the lazy dog";
+    REQUIRE(alpha_xxh64(fox.data(), fox.size(), 0) == 0x0B242D361FDA71BCULL);
+}